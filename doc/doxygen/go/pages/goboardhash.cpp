@@ -11,6 +11,11 @@ independent who is to play.
 The hash code is always zero for an empty board, independent of the board
 size.
 
+Each block stores the combined hash code of its stones, so a captured block
+is removed from the hash code with a single XOR.
+The hash code has the type SgHashCode, which has 64 bits by default and
+128 bits if configured with --enable-hash-size=128.
+
 @section goboardhashko Ko Moves
 
 If Ko moves are allowed and GoBoard::KoModifiesHash is true, then the
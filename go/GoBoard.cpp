@@ -38,12 +38,15 @@ void UpdateChanges(SgPoint p, SgArrayList<SgPoint,SG_MAXPOINT>& changes,
 //----------------------------------------------------------------------------
 
 GoBoard::GoBoard(int size, const GoSetup& setup, const GoRules& rules)
-    : m_snapshot(new Snapshot()),
+    : m_nuSnapshots(0),
       m_const(size),
       m_blockList(new SgArrayList<Block,GO_MAX_NUM_MOVES>()),
-      m_moves(new SgArrayList<StackEntry,GO_MAX_NUM_MOVES>())
+      m_moves(new SgArrayList<StackEntry,GO_MAX_NUM_MOVES>()),
+      m_positions(new PositionSet())
 
 {
+    for (int i = 0; i < MAX_SNAPSHOTS; ++i)
+        m_snapshots[i] = 0;
     GoInitCheck();
     Init(size, rules, setup);
 }
@@ -54,6 +57,40 @@ GoBoard::~GoBoard()
     m_blockList = 0;
     delete m_moves;
     m_moves = 0;
+    delete m_positions;
+    m_positions = 0;
+    for (int i = 0; i < MAX_SNAPSHOTS; ++i)
+        delete m_snapshots[i];
+}
+
+SgPointSet GoBoard::AllLegal(SgBlackWhite player) const
+{
+    SG_ASSERT_BW(player);
+    SgPointSet legal = m_state.m_empty;
+    if (! Rules().AllowSuicide())
+    {
+        const SgPointSet noEmptyNeighbor =
+            m_state.m_empty - m_state.m_empty.Neighbors4();
+        for (SgSetIterator it(noEmptyNeighbor); it; ++it)
+            if (IsSuicide(*it, player))
+                legal.Exclude(*it);
+    }
+    if (Rules().GetKoRule() == GoRules::SIMPLEKO)
+    {
+        const SgPoint koPoint = m_state.m_koPoint;
+        if (koPoint != SG_NULLPOINT && m_state.m_toPlay == player
+            && legal.Contains(koPoint) && ! IsFirst(koPoint)
+            && ! AnyRepetitionAllowed() && ! KoRepetitionAllowed())
+            legal.Exclude(koPoint);
+    }
+    else
+    {
+        const SgPointSet candidates = legal;
+        for (SgSetIterator it(candidates); it; ++it)
+            if (! IsFirst(*it) && ! IsLegal(*it, player))
+                legal.Exclude(*it);
+    }
+    return legal;
 }
 
 void GoBoard::CheckConsistency() const
@@ -106,6 +143,8 @@ void GoBoard::CheckConsistencyBlock(SgPoint point) const
     GoPointList stones;
     Block::LibertyList liberties;
     SgMarker mark;
+    HashCode hash;
+    hash.Clear();
     SgStack<SgPoint,SG_MAXPOINT> stack;
     stack.Push(point);
     while (! stack.IsEmpty())
@@ -116,6 +155,7 @@ void GoBoard::CheckConsistencyBlock(SgPoint point) const
         if (GetColor(p) == color)
         {
             stones.PushBack(p);
+            hash.XorStone(p, color);
             stack.Push(p - SG_NS);
             stack.Push(p - SG_WE);
             stack.Push(p + SG_WE);
@@ -130,7 +170,12 @@ void GoBoard::CheckConsistencyBlock(SgPoint point) const
     SG_ASSERT(color == block->Color());
     SG_ASSERT(stones.SameElements(block->Stones()));
     SG_ASSERT(liberties.SameElements(block->Liberties()));
+    SG_ASSERT(block->LibertySet().Size() == block->NumLiberties());
+    for (Block::LibertyIterator it(block->Liberties()); it; ++it)
+        SG_ASSERT(block->LibertySet().Contains(*it));
     SG_ASSERT(stones.Length() == NumStones(point));
+    SG_ASSERT(hash.Get() == block->Hash().Get());
+    SG_ASSERT(hash.GetStonesKey() == block->Hash().GetStonesKey());
 }
 
 bool GoBoard::CheckKo(SgBlackWhite player)
@@ -173,15 +218,7 @@ void GoBoard::AddLibToAdjBlocks(SgPoint p)
 
 void GoBoard::AddLibToAdjBlocks(SgPoint p, SgBlackWhite c)
 {
-    if (NumNeighbors(p, c) == 0)
-        return;
-    SgArrayList<Block*,4> blocks = GetAdjacentBlocks(p, c);
-    for (SgArrayList<Block*,4>::Iterator it(blocks); it; ++it)
-    {
-        Block* block = *it;
-        if (block != 0)
-            block->AppendLiberty(p);
-    }
+    Kernel::AddLibToAdjBlocks(*this, m_state.m_block, p, c, m_marker);
 }
 
 void GoBoard::AddStoneToBlock(SgPoint p, SgBlackWhite c, Block* block,
@@ -190,31 +227,19 @@ void GoBoard::AddStoneToBlock(SgPoint p, SgBlackWhite c, Block* block,
     SG_DEBUG_ONLY(c);
     // Stone already placed
     SG_ASSERT(IsColor(p, c));
-    block->AppendStone(p);
-    entry.m_newLibs.Clear();
-    if (IsEmpty(p - SG_NS) && ! IsAdjacentTo(p - SG_NS, block))
-    {
-        block->AppendLiberty(p - SG_NS);
-        entry.m_newLibs.PushBack(p - SG_NS);
-    }
-    if (IsEmpty(p - SG_WE) && ! IsAdjacentTo(p - SG_WE, block))
-    {
-        block->AppendLiberty(p - SG_WE);
-        entry.m_newLibs.PushBack(p - SG_WE);
-    }
-    if (IsEmpty(p + SG_WE) && ! IsAdjacentTo(p + SG_WE, block))
-    {
-        block->AppendLiberty(p + SG_WE);
-        entry.m_newLibs.PushBack(p + SG_WE);
-    }
-    if (IsEmpty(p + SG_NS) && ! IsAdjacentTo(p + SG_NS, block))
-    {
-        block->AppendLiberty(p + SG_NS);
-        entry.m_newLibs.PushBack(p + SG_NS);
-    }
+    GoBoardKernelUndo undo(entry.m_newLibs);
+    Kernel::AddStoneToBlock(*this, m_state.m_block, p, block, undo);
     entry.m_oldAnchor = block->Anchor();
     block->UpdateAnchor(p);
-    m_state.m_block[p] = block;
+}
+
+GoBoard::Block* GoBoard::CopiedBlock(const GoBoard& bd,
+                                     const Block* block) const
+{
+    if (block == 0)
+        return 0;
+    const int index = static_cast<int>(block - &(*bd.m_blockList)[0]);
+    return &(*m_blockList)[index];
 }
 
 GoBoard::Block& GoBoard::CreateNewBlock()
@@ -232,14 +257,7 @@ void GoBoard::CreateSingleStoneBlock(SgPoint p, SgBlackWhite c)
     SG_ASSERT(NumNeighbors(p, c) == 0);
     Block& block = CreateNewBlock();
     block.Init(c, p);
-    if (IsEmpty(p - SG_NS))
-        block.AppendLiberty(p - SG_NS);
-    if (IsEmpty(p - SG_WE))
-        block.AppendLiberty(p - SG_WE);
-    if (IsEmpty(p + SG_WE))
-        block.AppendLiberty(p + SG_WE);
-    if (IsEmpty(p + SG_NS))
-        block.AppendLiberty(p + SG_NS);
+    Kernel::AddSingleStoneLiberties(*this, p, block);
     m_state.m_block[p] = &block;
 }
 
@@ -286,47 +304,19 @@ SgArrayList<GoBoard::Block*,4> GoBoard::GetAdjacentBlocks(SgPoint p,
     return result;
 }
 
-bool GoBoard::IsAdjacentTo(SgPoint p, const GoBoard::Block* block) const
-{
-    return   m_state.m_block[p - SG_NS] == block
-          || m_state.m_block[p - SG_WE] == block
-          || m_state.m_block[p + SG_WE] == block
-          || m_state.m_block[p + SG_NS] == block;
-}
-
 void GoBoard::MergeBlocks(SgPoint p, SgBlackWhite c,
                           const SgArrayList<Block*,4>& adjBlocks)
 {
     // Stone already placed
     SG_ASSERT(IsColor(p, c));
     SG_ASSERT(NumNeighbors(p, c) > 1);
+    // Merge into a new block, the merged blocks are needed for Undo()
     Block& block = CreateNewBlock();
     block.Init(c, p);
-    SgReserveMarker reserve(m_marker);
-    SG_UNUSED(reserve);
-    m_marker.Clear();
+    Kernel::MergeBlocks(*this, m_state.m_block, p, block, adjBlocks,
+                        m_marker);
     for (SgArrayList<Block*,4>::Iterator it(adjBlocks); it; ++it)
-    {
-        Block* adjBlock = *it;
-        for (Block::StoneIterator stn(adjBlock->Stones()); stn; ++stn)
-        {
-            block.AppendStone(*stn);
-            m_state.m_block[*stn] = &block;
-        }
-        for (Block::LibertyIterator lib(adjBlock->Liberties()); lib; ++lib)
-            if (m_marker.NewMark(*lib))
-                block.AppendLiberty(*lib);
-        block.UpdateAnchor(adjBlock->Anchor());
-    }
-    m_state.m_block[p] = &block;
-    if (IsEmpty(p - SG_NS) && m_marker.NewMark(p - SG_NS))
-        block.AppendLiberty(p - SG_NS);
-    if (IsEmpty(p - SG_WE) && m_marker.NewMark(p - SG_WE))
-        block.AppendLiberty(p - SG_WE);
-    if (IsEmpty(p + SG_WE) && m_marker.NewMark(p + SG_WE))
-        block.AppendLiberty(p + SG_WE);
-    if (IsEmpty(p + SG_NS) && m_marker.NewMark(p + SG_NS))
-        block.AppendLiberty(p + SG_NS);
+        block.UpdateAnchor((*it)->Anchor());
 }
 
 void GoBoard::RemoveLibFromAdjBlocks(SgPoint p, SgBlackWhite c)
@@ -425,6 +415,7 @@ void GoBoard::Init(int size, const GoRules& rules, const GoSetup& setup)
     SG_ASSERTRANGE(m_size, SG_MIN_SIZE, SG_MAX_SIZE);
     m_state.m_hash.Clear();
     m_moves->Clear();
+    m_positions->Clear();
     m_state.m_prisoners[SG_BLACK] = 0;
     m_state.m_prisoners[SG_WHITE] = 0;
     m_state.m_numStones[SG_BLACK] = 0;
@@ -493,7 +484,51 @@ void GoBoard::Init(int size, const GoRules& rules, const GoSetup& setup)
             InitBlock(block, c, *it);
         }
     }
-    m_snapshot->m_moveNumber = -1;
+    m_nuSnapshots = 0;
+    m_changed.Clear();
+    CheckConsistency();
+}
+
+void GoBoard::Init(const GoBoard& bd)
+{
+    SG_ASSERT(&bd != this);
+    if (bd.m_size != m_size)
+    {
+        m_size = bd.m_size;
+        m_const.ChangeSize(m_size);
+    }
+    m_rules = bd.m_rules;
+    m_setup = bd.m_setup;
+    m_countPlay = bd.m_countPlay;
+    m_moveInfo = bd.m_moveInfo;
+    m_capturedStones = bd.m_capturedStones;
+    m_allowAnyRepetition = bd.m_allowAnyRepetition;
+    m_allowKoRepetition = bd.m_allowKoRepetition;
+    m_koModifiesHash = bd.m_koModifiesHash;
+    m_koColor = bd.m_koColor;
+    m_koLoser = bd.m_koLoser;
+    m_isBorder = bd.m_isBorder;
+    *m_blockList = *bd.m_blockList;
+    *m_positions = *bd.m_positions;
+    m_state = bd.m_state;
+    for (SgPoint p = 0; p < SG_MAXPOINT; ++p)
+        m_state.m_block[p] = CopiedBlock(bd, bd.m_state.m_block[p]);
+    *m_moves = *bd.m_moves;
+    for (int i = 0; i < m_moves->Length(); ++i)
+    {
+        StackEntry& entry = (*m_moves)[i];
+        if (IsPass(entry.m_point))
+            continue;
+        entry.m_stoneAddedTo = CopiedBlock(bd, entry.m_stoneAddedTo);
+        if (entry.m_stoneAddedTo == 0)
+            for (int j = 0; j < entry.m_merged.Length(); ++j)
+                entry.m_merged[j] = CopiedBlock(bd, entry.m_merged[j]);
+        for (int j = 0; j < entry.m_killed.Length(); ++j)
+            entry.m_killed[j] = CopiedBlock(bd, entry.m_killed[j]);
+        entry.m_suicide = CopiedBlock(bd, entry.m_suicide);
+    }
+    m_nuSnapshots = 0;
+    m_changed.Clear();
     CheckConsistency();
 }
 
@@ -582,49 +617,13 @@ int GoBoard::AdjacentBlocks(SgPoint point, int maxLib, SgPoint anchors[],
 void GoBoard::NeighborBlocks(SgPoint p, SgBlackWhite c,
                              SgPoint anchors[]) const
 {
-    SG_ASSERT(IsEmpty(p));
-    SgReserveMarker reserve(m_marker);
-    SG_UNUSED(reserve);
-    m_marker.Clear();
-    int i = 0;
-    if (NumNeighbors(p, c) > 0)
-    {
-        if (IsColor(p - SG_NS, c) && m_marker.NewMark(Anchor(p - SG_NS)))
-            anchors[i++] = Anchor(p - SG_NS);
-        if (IsColor(p - SG_WE, c) && m_marker.NewMark(Anchor(p - SG_WE)))
-            anchors[i++] = Anchor(p - SG_WE);
-        if (IsColor(p + SG_WE, c) && m_marker.NewMark(Anchor(p + SG_WE)))
-            anchors[i++] = Anchor(p + SG_WE);
-        if (IsColor(p + SG_NS, c) && m_marker.NewMark(Anchor(p + SG_NS)))
-            anchors[i++] = Anchor(p + SG_NS);
-    }
-    anchors[i] = SG_ENDPOINT;
+    Kernel::NeighborBlocks(*this, p, c, anchors, m_marker);
 }
 
 void GoBoard::NeighborBlocks(SgPoint p, SgBlackWhite c, int maxLib,
                              SgPoint anchors[]) const
 {
-    SG_ASSERT(IsEmpty(p));
-    SgReserveMarker reserve(m_marker);
-    SG_UNUSED(reserve);
-    m_marker.Clear();
-    int i = 0;
-    if (NumNeighbors(p, c) > 0)
-    {
-        if (IsColor(p - SG_NS, c) && m_marker.NewMark(Anchor(p - SG_NS))
-            && AtMostNumLibs(p - SG_NS, maxLib))
-            anchors[i++] = Anchor(p - SG_NS);
-        if (IsColor(p - SG_WE, c) && m_marker.NewMark(Anchor(p - SG_WE))
-            && AtMostNumLibs(p - SG_WE, maxLib))
-            anchors[i++] = Anchor(p - SG_WE);
-        if (IsColor(p + SG_WE, c) && m_marker.NewMark(Anchor(p + SG_WE))
-            && AtMostNumLibs(p + SG_WE, maxLib))
-            anchors[i++] = Anchor(p + SG_WE);
-        if (IsColor(p + SG_NS, c) && m_marker.NewMark(Anchor(p + SG_NS))
-            && AtMostNumLibs(p + SG_NS, maxLib))
-            anchors[i++] = Anchor(p + SG_NS);
-    }
-    anchors[i] = SG_ENDPOINT;
+    Kernel::NeighborBlocks(*this, p, c, maxLib, anchors, m_marker);
 }
 
 void GoBoard::AddStone(SgPoint p, SgBlackWhite c)
@@ -632,6 +631,8 @@ void GoBoard::AddStone(SgPoint p, SgBlackWhite c)
     SG_ASSERT(IsEmpty(p));
     SG_ASSERT_BW(c);
     m_state.m_color[p] = c;
+    if (m_nuSnapshots > 0)
+        m_changed.Include(p);
     m_state.m_empty.Exclude(p);
     m_state.m_all[c].Include(p);
     --m_state.m_nuNeighborsEmpty[p - SG_NS];
@@ -650,6 +651,8 @@ void GoBoard::RemoveStone(SgPoint p)
     SgBlackWhite c = GetStone(p);
     SG_ASSERT_BW(c);
     m_state.m_color[p] = SG_EMPTY;
+    if (m_nuSnapshots > 0)
+        m_changed.Include(p);
     m_state.m_empty.Include(p);
     m_state.m_all[c].Exclude(p);
     ++m_state.m_nuNeighborsEmpty[p - SG_NS];
@@ -667,11 +670,11 @@ void GoBoard::KillBlock(const Block* block)
 {
     SgBlackWhite c = block->Color();
     SgBlackWhite opp = SgOppBW(c);
+    m_state.m_hash.Xor(block->Hash());
     for (Block::StoneIterator it(block->Stones()); it; ++it)
     {
         SgPoint stn = *it;
         AddLibToAdjBlocks(stn, opp);
-        m_state.m_hash.XorStone(stn, c);
         RemoveStone(stn);
         m_capturedStones.PushBack(stn);
         m_state.m_block[stn] = 0;
@@ -696,6 +699,12 @@ bool GoBoard::FullBoardRepetition() const
         const StackEntry& entry = (*m_moves)[nuMoves - 1];
         return (entry.m_point == entry.m_koPoint);
     }
+    // A repetition is the position before one of the moves in m_moves,
+    // whose stones keys are all in m_positions. The backward scan is only
+    // needed to confirm a found key (hash collision, or a different color
+    // to play for situational superko)
+    if (! m_positions->Contains(m_state.m_hash.GetStonesKey()))
+        return false;
     SgBWArray<SgArrayList<SgPoint,SG_MAXPOINT> > changes;
     int nuChanges = 0;
     int moveNumber = m_moves->Length() - 1;
@@ -761,6 +770,7 @@ void GoBoard::Play(SgPoint p, SgBlackWhite player)
     entry.m_point = p;
     entry.m_color = player;
     SaveState(entry);
+    m_positions->Push(m_state.m_hash.GetStonesKey());
     m_state.m_koPoint = SG_NULLPOINT;
     m_capturedStones.Clear();
     m_moveInfo.reset();
@@ -817,6 +827,7 @@ void GoBoard::Undo()
     RestoreState(entry);
     UpdateBlocksAfterUndo(entry);
     m_moves->PopBack();
+    m_positions->Pop();
     CheckConsistency();
 }
 
@@ -875,33 +886,121 @@ void GoBoard::SaveState(StackEntry& entry)
 
 void GoBoard::TakeSnapshot()
 {
-    m_snapshot->m_moveNumber = MoveNumber();
-    m_snapshot->m_blockListSize = m_blockList->Length();
-    m_snapshot->m_state = m_state;
+    m_nuSnapshots = 0;
+    m_changed.Clear();
+    PushSnapshot();
+}
+
+void GoBoard::PushSnapshot()
+{
+    SG_ASSERT(m_nuSnapshots < MAX_SNAPSHOTS);
+    if (m_snapshots[m_nuSnapshots] == 0)
+        m_snapshots[m_nuSnapshots] = new Snapshot();
+    Snapshot& snapshot = *m_snapshots[m_nuSnapshots];
+    ++m_nuSnapshots;
+    snapshot.m_moveNumber = MoveNumber();
+    snapshot.m_blockListSize = m_blockList->Length();
+    snapshot.m_changed = m_changed;
+    m_changed.Clear();
+    snapshot.m_state = m_state;
     for (GoBoard::Iterator it(*this); it; ++it)
     {
         SgPoint p = *it;
-        if (m_state.m_block[p] != 0)
-            m_snapshot->m_blockArray[p] = *m_state.m_block[p];
+        const Block* block = m_state.m_block[p];
+        if (block != 0)
+        {
+            SgPoint anchor = block->Anchor();
+            snapshot.m_anchor[p] = anchor;
+            if (p == anchor)
+                snapshot.m_blockArray[p] = *block;
+        }
     }
 }
 
 void GoBoard::RestoreSnapshot()
 {
-    SG_ASSERT(m_snapshot->m_moveNumber >= 0);
-    SG_ASSERT(m_snapshot->m_moveNumber <= MoveNumber());
-    if (m_snapshot->m_moveNumber == MoveNumber())
+    RestoreSnapshot(m_nuSnapshots - 1);
+}
+
+void GoBoard::RestoreSnapshot(int level)
+{
+    SG_ASSERT(level >= 0);
+    SG_ASSERT(level < m_nuSnapshots);
+    while (m_nuSnapshots > level + 1)
+        PopSnapshot();
+    const Snapshot& snapshot = *m_snapshots[level];
+    SG_ASSERT(snapshot.m_moveNumber <= MoveNumber());
+    if (snapshot.m_moveNumber == MoveNumber())
+    {
+        // Same position, points can only have changed temporarily
+        m_changed.Clear();
         return;
-    m_blockList->Resize(m_snapshot->m_blockListSize);
-    m_moves->Resize(m_snapshot->m_moveNumber);
-    m_state = m_snapshot->m_state;
-    for (GoBoard::Iterator it(*this); it; ++it)
+    }
+    m_blockList->Resize(snapshot.m_blockListSize);
+    m_moves->Resize(snapshot.m_moveNumber);
+    while (m_positions->Size() > snapshot.m_moveNumber)
+        m_positions->Pop();
+    const State& state = snapshot.m_state;
+    m_state.m_koPoint = state.m_koPoint;
+    m_state.m_toPlay = state.m_toPlay;
+    m_state.m_hash = state.m_hash;
+    m_state.m_all = state.m_all;
+    m_state.m_empty = state.m_empty;
+    m_state.m_prisoners = state.m_prisoners;
+    m_state.m_numStones = state.m_numStones;
+    m_state.m_koLevel = state.m_koLevel;
+    m_state.m_isNewPosition = state.m_isNewPosition;
+    SgReserveMarker reserve(m_marker);
+    SG_UNUSED(reserve);
+    m_marker.Clear();
+    for (SgSetIterator it(m_changed); it; ++it)
     {
         SgPoint p = *it;
-        if (m_state.m_block[p] != 0)
-            *m_state.m_block[p] = m_snapshot->m_blockArray[p];
+        RestorePoint(snapshot, p);
+        RestorePoint(snapshot, p - SG_NS);
+        RestorePoint(snapshot, p - SG_WE);
+        RestorePoint(snapshot, p + SG_WE);
+        RestorePoint(snapshot, p + SG_NS);
     }
+    m_changed.Clear();
     CheckConsistency();
 }
 
+void GoBoard::PopSnapshot()
+{
+    SG_ASSERT(m_nuSnapshots > 0);
+    --m_nuSnapshots;
+    if (m_nuSnapshots == 0)
+        m_changed.Clear();
+    else
+        m_changed |= m_snapshots[m_nuSnapshots]->m_changed;
+}
+
+/** Restore the data of a point and of the block at the point.
+    Blocks that were on the board at the snapshot can only have changed if
+    they are adjacent to a point that changed color. The restored block also
+    restores the block pointers of its stones, which might point to a block
+    created by a merge after the snapshot. */
+void GoBoard::RestorePoint(const Snapshot& snapshot, SgPoint p)
+{
+    const State& state = snapshot.m_state;
+    m_state.m_color[p] = state.m_color[p];
+    m_state.m_nuNeighborsEmpty[p] = state.m_nuNeighborsEmpty[p];
+    m_state.m_nuNeighbors[SG_BLACK][p] = state.m_nuNeighbors[SG_BLACK][p];
+    m_state.m_nuNeighbors[SG_WHITE][p] = state.m_nuNeighbors[SG_WHITE][p];
+    m_state.m_isFirst[p] = state.m_isFirst[p];
+    Block* block = state.m_block[p];
+    m_state.m_block[p] = block;
+    if (block != 0)
+    {
+        SgPoint anchor = snapshot.m_anchor[p];
+        if (m_marker.NewMark(anchor))
+        {
+            *block = snapshot.m_blockArray[anchor];
+            for (Block::StoneIterator it(block->Stones()); it; ++it)
+                m_state.m_block[*it] = block;
+        }
+    }
+}
+
 //----------------------------------------------------------------------------
@@ -14,6 +14,7 @@
 #include <cstring>
 #include <stdint.h>
 #include <boost/static_assert.hpp>
+#include "GoBoardKernel.h"
 #include "GoPlayerMove.h"
 #include "GoRules.h"
 #include "GoSetup.h"
@@ -99,6 +100,10 @@ public:
         @see KoModifiesHash() */
     static const int MAX_KOLEVEL = 3;
 
+    /** Maximum number of nested snapshots.
+        @see PushSnapshot() */
+    static const int MAX_SNAPSHOTS = 4;
+
     /** Marker that can be used in client code.
         This marker is never used by this class, it is intended for external
         functions that operate on the board and can profit from the fast clear
@@ -128,6 +133,16 @@ public:
     void Init(int size, const GoRules& rules,
               const GoSetup& setup = GoSetup());
 
+    /** Re-initializes the board as a copy of another board.
+        Copies the complete state including rules, setup and the move
+        history, so that the moves can be undone on the copy. The blocks are
+        stored by value in a list with the same indices in both boards, so
+        the copy is a copy of the used part of each array plus the
+        conversion of the block pointers. Much faster than replaying the
+        moves of a long game (e.g. with GoBoardSynchronizer). A snapshot
+        (see TakeSnapshot()) is not copied. */
+    void Init(const GoBoard& bd);
+
     /** Non-const access to current game rules.
         The game rules are attached to a GoBoard for convenient access
         by the players only.
@@ -237,6 +252,15 @@ public:
 
     const SgPointSet& AllEmpty() const;
 
+    /** Get all legal moves of a color except pass.
+        Same result as calling IsLegal(p, player) for each point. The empty
+        points that have an empty neighbor cannot be suicide, they are found
+        with a few word operations on AllEmpty(). Only the other empty
+        points are checked for suicide. With simple ko, only the ko point
+        is checked for repetition, otherwise the points that are not
+        IsFirst() are checked with IsLegal(). */
+    SgPointSet AllLegal(SgBlackWhite player) const;
+
     const SgPointSet& AllPoints() const;
 
     /** See SgBoardConst::Corners */
@@ -455,6 +479,12 @@ public:
         Not defined for empty or border points. */
     int NumLiberties(SgPoint p) const;
 
+    /** Return the liberties of the block at 'p' as a set.
+        Contains the same points as LibertyIterator, but allows word-parallel
+        intersections and unions of the liberties of several blocks.
+        Not defined for empty or border points. */
+    const SgPointSet& LibertySet(SgPoint p) const;
+
     /** Return whether block has at most n liberties. */
     bool AtMostNumLibs(SgPoint block, int n) const;
 
@@ -495,18 +525,98 @@ public:
     void CheckConsistency() const;
 
     /** Remember current position for quickly undoing a sequence of moves.
+        Replaces all snapshots that were taken earlier.
         Note that for short sequences of moves this can take longer than
         incrementally restoring the state by multiple calls to Undo(). */
     void TakeSnapshot();
 
-    /** Restore a snapshot.
+    /** Remember current position in addition to the earlier snapshots.
+        The new snapshot is put on top of the snapshots that were taken
+        earlier and not yet discarded. At most MAX_SNAPSHOTS snapshots can
+        be on the stack. */
+    void PushSnapshot();
+
+    /** Restore the topmost snapshot.
         Can only be called, if previously TakeSnapshot() was called and
         the current position is a followup position of the snapshot position.
         RestoreSnapshot() can used multiple times for the same snapshot.
+        The time needed is proportional to the number of points that changed
+        since the snapshot and the size of the blocks next to them.
         @see TakeSnapshot() */
     void RestoreSnapshot();
 
+    /** Restore the snapshot at a given level of the snapshot stack.
+        Discards all snapshots above the level; the snapshot itself stays
+        on the stack.
+        @param level The level (0 is the snapshot that was taken first) */
+    void RestoreSnapshot(int level);
+
+    /** Discard the topmost snapshot without changing the position. */
+    void PopSnapshot();
+
+    /** Number of snapshots on the snapshot stack. */
+    int NuSnapshots() const;
+
 private:
+    /** Board hash code.
+        @see @ref goboardhash */
+    class HashCode
+    {
+    public:
+        void Clear();
+
+        const SgHashCode& Get() const;
+
+        SgHashCode GetInclToPlay(SgBlackWhite toPlay) const;
+
+        void XorCaptured(int moveNumber, SgPoint firstCapturedStone);
+
+        void XorStone(SgPoint p, SgBlackWhite c);
+
+        void XorWinKo(int level, SgBlackWhite c);
+
+        /** Combine with another hash code.
+            Used for removing a captured block with a single operation.
+            @see Block::Hash() */
+        void Xor(const HashCode& code);
+
+        /** Key that depends only on the stones on the board.
+            32 bit Zobrist key, which is not modified by XorCaptured() and
+            XorWinKo(). Used for the repetition check in PositionSet. */
+        unsigned int GetStonesKey() const;
+
+    private:
+        // Index ranges used in global Zobrist table
+        static const int START_INDEX_TOPLAY = 1;
+        static const int END_INDEX_TOPLAY = 2;
+        static const int START_INDEX_STONES = 3;
+        static const int END_INDEX_STONES = 2 * SG_MAXPOINT;
+        static const int START_INDEX_WINKO = 2 * SG_MAXPOINT + 1;
+        static const int END_INDEX_WINKO = 2 * SG_MAXPOINT + SG_MAX_SIZE + 1;
+        static const int START_INDEX_CAPTURES
+        = 2 * SG_MAXPOINT + SG_MAX_SIZE + 2;
+        static const int END_INDEX_CAPTURES = 3 * SG_MAXPOINT + 63;
+
+        // Certain values for SG_MAX_SIZE and WIN_KO_LEVEL can break the
+        // assumption that the above ranges don't overlap
+        BOOST_STATIC_ASSERT(START_INDEX_TOPLAY >= 0);
+        BOOST_STATIC_ASSERT(END_INDEX_TOPLAY > START_INDEX_TOPLAY);
+        BOOST_STATIC_ASSERT(START_INDEX_STONES > END_INDEX_TOPLAY);
+        BOOST_STATIC_ASSERT(END_INDEX_STONES > START_INDEX_STONES);
+        BOOST_STATIC_ASSERT(END_INDEX_WINKO > START_INDEX_WINKO);
+        BOOST_STATIC_ASSERT(START_INDEX_CAPTURES > END_INDEX_WINKO);
+        BOOST_STATIC_ASSERT(END_INDEX_CAPTURES > START_INDEX_CAPTURES);
+        BOOST_STATIC_ASSERT(START_INDEX_WINKO + MAX_KOLEVEL * 3 - 1
+                            <= END_INDEX_WINKO);
+        BOOST_STATIC_ASSERT(END_INDEX_CAPTURES
+                        < SgHashZobristTable::MAX_HASH_INDEX);
+
+        SgHashCode m_hash;
+
+        /** See GetStonesKey() */
+        unsigned int m_stonesKey;
+    };
+
     /** Data related to a block of stones on the board. */
     class Block
     {
@@ -525,13 +635,35 @@ private:
 
         void UpdateAnchor(SgPoint p) { if (p < m_anchor) m_anchor = p; }
 
-        void AppendLiberty(SgPoint p) { m_liberties.PushBack(p); }
+        void AppendLiberty(SgPoint p)
+        {
+            m_liberties.PushBack(p);
+            m_libertySet.Include(p);
+        }
 
-        void AppendStone(SgPoint p) { m_stones.PushBack(p); }
+        void AppendStone(SgPoint p)
+        {
+            m_stones.PushBack(p);
+            m_hash.XorStone(p, m_color);
+        }
+
+        /** Append the stones of another block for merging blocks.
+            Combines the hash codes instead of hashing each stone. */
+        void AppendStones(const Block& block)
+        {
+            SG_ASSERT(block.m_color == m_color);
+            for (StoneIterator it(block.m_stones); it; ++it)
+                m_stones.PushBack(*it);
+            m_hash.Xor(block.m_hash);
+        }
 
         SgBlackWhite Color() const { return m_color; }
 
-        void ExcludeLiberty(SgPoint p) { m_liberties.Exclude(p); }
+        void ExcludeLiberty(SgPoint p)
+        {
+            m_liberties.Exclude(p);
+            m_libertySet.Exclude(p);
+        }
 
         void Init(SgBlackWhite c, SgPoint anchor)
         {
@@ -540,6 +672,9 @@ private:
             m_anchor = anchor;
             m_stones.SetTo(anchor);
             m_liberties.Clear();
+            m_libertySet.Clear();
+            m_hash.Clear();
+            m_hash.XorStone(anchor, c);
         }
 
         void Init(SgBlackWhite c, SgPoint anchor, GoPointList stones,
@@ -551,15 +686,31 @@ private:
             m_anchor = anchor;
             m_stones = stones;
             m_liberties = liberties;
+            m_libertySet.Clear();
+            for (LibertyIterator it(m_liberties); it; ++it)
+                m_libertySet.Include(*it);
+            m_hash.Clear();
+            for (StoneIterator it(m_stones); it; ++it)
+                m_hash.XorStone(*it, c);
         }
 
+        /** Hash code of the stones of the block. */
+        const HashCode& Hash() const { return m_hash; }
+
         const LibertyList& Liberties() const { return m_liberties; }
 
+        /** Same points as Liberties() as a set. */
+        const SgPointSet& LibertySet() const { return m_libertySet; }
+
         int NumLiberties() const { return m_liberties.Length(); }
 
         int NumStones() const { return m_stones.Length(); }
 
-        void PopStone() { m_stones.PopBack(); }
+        void PopStone()
+        {
+            m_hash.XorStone(m_stones.Last(), m_color);
+            m_stones.PopBack();
+        }
 
         void SetAnchor(SgPoint p) { m_anchor = p; }
 
@@ -572,53 +723,59 @@ private:
 
         LibertyList m_liberties;
 
+        /** Set of the points in m_liberties.
+            Kept in sync by AppendLiberty(), ExcludeLiberty() and Init(). */
+        SgPointSet m_libertySet;
+
         GoPointList m_stones;
+
+        /** XOR of the Zobrist codes of the stones.
+            Maintained with each change of the stones, so that capturing
+            the block updates the board hash code with a single XOR. */
+        HashCode m_hash;
     };
 
-    /** Board hash code.
-        @see @ref goboardhash */
-    class HashCode
+    /** Block update operations shared with GoUctBoard. */
+    typedef GoBoardKernel<GoBoard,Block> Kernel;
+
+    /** Multiset of the stones keys of the positions before each move.
+        Contains one entry for each entry in m_moves, so that
+        FullBoardRepetition() can exclude a repetition without a backward
+        scan through the move stack, if the key of the current position is
+        not contained.
+        Open addressing with linear probing. Keys are only added and
+        removed in stack order (Play() and Undo()), so removing the most
+        recently added key can clear its slot without breaking the probe
+        sequence of any key added earlier.
+        @see HashCode::GetStonesKey() */
+    class PositionSet
     {
     public:
-        void Clear();
+        PositionSet();
 
-        const SgHashCode& Get() const;
+        void Clear();
 
-        SgHashCode GetInclToPlay(SgBlackWhite toPlay) const;
+        bool Contains(unsigned int key) const;
 
-        void XorCaptured(int moveNumber, SgPoint firstCapturedStone);
+        /** Remove the most recently added key. */
+        void Pop();
 
-        void XorStone(SgPoint p, SgBlackWhite c);
+        void Push(unsigned int key);
 
-        void XorWinKo(int level, SgBlackWhite c);
+        int Size() const;
 
     private:
-        // Index ranges used in global Zobrist table
-        static const int START_INDEX_TOPLAY = 1;
-        static const int END_INDEX_TOPLAY = 2;
-        static const int START_INDEX_STONES = 3;
-        static const int END_INDEX_STONES = 2 * SG_MAXPOINT;
-        static const int START_INDEX_WINKO = 2 * SG_MAXPOINT + 1;
-        static const int END_INDEX_WINKO = 2 * SG_MAXPOINT + SG_MAX_SIZE + 1;
-        static const int START_INDEX_CAPTURES
-        = 2 * SG_MAXPOINT + SG_MAX_SIZE + 2;
-        static const int END_INDEX_CAPTURES = 3 * SG_MAXPOINT + 63;
+        /** Number of slots. More than twice the maximum number of keys. */
+        static const int TABLE_SIZE = 4 * GO_MAX_NUM_MOVES + 1;
 
-        // Certain values for SG_MAX_SIZE and WIN_KO_LEVEL can break the
-        // assumption that the above ranges don't overlap
-        BOOST_STATIC_ASSERT(START_INDEX_TOPLAY >= 0);
-        BOOST_STATIC_ASSERT(END_INDEX_TOPLAY > START_INDEX_TOPLAY);
-        BOOST_STATIC_ASSERT(START_INDEX_STONES > END_INDEX_TOPLAY);
-        BOOST_STATIC_ASSERT(END_INDEX_STONES > START_INDEX_STONES);
-        BOOST_STATIC_ASSERT(END_INDEX_WINKO > START_INDEX_WINKO);
-        BOOST_STATIC_ASSERT(START_INDEX_CAPTURES > END_INDEX_WINKO);
-        BOOST_STATIC_ASSERT(END_INDEX_CAPTURES > START_INDEX_CAPTURES);
-        BOOST_STATIC_ASSERT(START_INDEX_WINKO + MAX_KOLEVEL * 3 - 1
-                            <= END_INDEX_WINKO);
-        BOOST_STATIC_ASSERT(END_INDEX_CAPTURES
-                        < SgHashZobristTable::MAX_HASH_INDEX);
+        /** Keys with 0 for empty slots.
+            A key 0 is stored as 1, which only causes a hash collision. */
+        SgArray<unsigned int,TABLE_SIZE> m_table;
 
-        SgHashCode m_hash;
+        /** Slots of the keys in the order they were added. */
+        SgArrayList<int,GO_MAX_NUM_MOVES> m_slots;
+
+        static unsigned int TableKey(unsigned int key);
     };
 
     /** Information to undo a move.
@@ -732,20 +889,37 @@ private:
 
     struct Snapshot
     {
-        /** Move number; -1, if no snapshot was made. */
         int m_moveNumber;
 
         int m_blockListSize;
 
+        /** Points that changed color between the snapshot below this one
+            and this snapshot. */
+        SgPointSet m_changed;
+
         State m_state;
 
-        /** State of blocks currently on the board. */
+        /** State of blocks currently on the board, stored at the anchor. */
         SgPointArray<Block> m_blockArray;
+
+        /** Anchor of the block at each point with a stone. */
+        SgPointArray<SgPoint> m_anchor;
     };
 
     State m_state;
 
-    std::auto_ptr<Snapshot> m_snapshot;
+    /** Stack of snapshots.
+        Only the first m_nuSnapshots elements are used. The snapshots are
+        allocated when first needed and kept for reuse. */
+    Snapshot* m_snapshots[MAX_SNAPSHOTS];
+
+    int m_nuSnapshots;
+
+    /** Points that changed color since the topmost snapshot was taken.
+        Restoring a snapshot only needs to restore these points, their
+        neighbors and the blocks at them. Only updated while there is a
+        snapshot. */
+    SgPointSet m_changed;
 
     /** See CountPlay */
     uint64_t m_countPlay;
@@ -794,6 +968,9 @@ private:
 
     SgArrayList<StackEntry,GO_MAX_NUM_MOVES>* m_moves;
 
+    /** Stones keys of the positions before the moves in m_moves. */
+    PositionSet* m_positions;
+
     static bool IsPass(SgPoint p);
 
     /** Not implemented. */
@@ -819,14 +996,17 @@ private:
 
     void CreateSingleStoneBlock(SgPoint p, SgBlackWhite c);
 
+    /** Return the block of this board at the same position in the block
+        list as a block of another board.
+        Used in Init(const GoBoard&). Returns 0 for a null pointer. */
+    Block* CopiedBlock(const GoBoard& bd, const Block* block) const;
+
     SgArrayList<Block*,4> GetAdjacentBlocks(SgPoint p) const;
 
     SgArrayList<Block*,4> GetAdjacentBlocks(SgPoint p, SgBlackWhite c) const;
 
     void InitBlock(GoBoard::Block& block, SgBlackWhite c, SgPoint anchor);
 
-    bool IsAdjacentTo(SgPoint p, const Block* block) const;
-
     void MergeBlocks(SgPoint p, SgBlackWhite c,
                      const SgArrayList<Block*,4>& adjBlocks);
 
@@ -855,6 +1035,8 @@ private:
 
     void RemoveStone(SgPoint p);
 
+    void RestorePoint(const Snapshot& snapshot, SgPoint p);
+
     void KillBlock(const Block* block);
 
     bool HasLiberties(SgPoint p) const;
@@ -1106,6 +1288,7 @@ inline GoBoard::LibertyCopyIterator::operator bool() const
 inline void GoBoard::HashCode::Clear()
 {
     m_hash.Clear();
+    m_stonesKey = 0;
 }
 
 inline const SgHashCode& GoBoard::HashCode::Get() const
@@ -1113,6 +1296,11 @@ inline const SgHashCode& GoBoard::HashCode::Get() const
     return m_hash;
 }
 
+inline unsigned int GoBoard::HashCode::GetStonesKey() const
+{
+    return m_stonesKey;
+}
+
 inline SgHashCode GoBoard::HashCode::GetInclToPlay(SgBlackWhite toPlay) const
 {
     SgHashCode hash = m_hash;
@@ -1140,7 +1328,62 @@ inline void GoBoard::HashCode::XorStone(SgPoint p, SgBlackWhite c)
     BOOST_STATIC_ASSERT(SG_WHITE == 1);
     int index = p + c * SG_MAXPOINT;
     SG_ASSERTRANGE(index, START_INDEX_STONES, END_INDEX_STONES);
-    SgHashUtil::XorZobrist(m_hash, index);
+    const SgHashCode& code = SgHashZobristTable::GetTable().Get(index);
+    m_hash.Xor(code);
+    m_stonesKey ^= code.Code1();
+}
+
+inline GoBoard::PositionSet::PositionSet()
+{
+    m_table.Fill(0);
+}
+
+inline void GoBoard::PositionSet::Clear()
+{
+    for (SgArrayList<int,GO_MAX_NUM_MOVES>::Iterator it(m_slots); it; ++it)
+        m_table[*it] = 0;
+    m_slots.Clear();
+}
+
+inline bool GoBoard::PositionSet::Contains(unsigned int key) const
+{
+    key = TableKey(key);
+    for (int i = key % TABLE_SIZE; m_table[i] != 0; i = (i + 1) % TABLE_SIZE)
+        if (m_table[i] == key)
+            return true;
+    return false;
+}
+
+inline void GoBoard::PositionSet::Pop()
+{
+    m_table[m_slots.Last()] = 0;
+    m_slots.PopBack();
+}
+
+inline void GoBoard::PositionSet::Push(unsigned int key)
+{
+    key = TableKey(key);
+    int i = key % TABLE_SIZE;
+    while (m_table[i] != 0)
+        i = (i + 1) % TABLE_SIZE;
+    m_table[i] = key;
+    m_slots.PushBack(i);
+}
+
+inline int GoBoard::PositionSet::Size() const
+{
+    return m_slots.Length();
+}
+
+inline unsigned int GoBoard::PositionSet::TableKey(unsigned int key)
+{
+    return key == 0 ? 1 : key;
+}
+
+inline void GoBoard::HashCode::Xor(const HashCode& code)
+{
+    m_hash.Xor(code.m_hash);
+    m_stonesKey ^= code.m_stonesKey;
 }
 
 inline void GoBoard::HashCode::XorWinKo(int level, SgBlackWhite c)
@@ -1347,13 +1590,7 @@ inline bool GoBoard::IsLibertyOfBlock(SgPoint p, SgPoint anchor) const
     SG_ASSERT(IsEmpty(p));
     SG_ASSERT(Occupied(anchor));
     SG_ASSERT(Anchor(anchor) == anchor);
-    const Block* b = m_state.m_block[anchor];
-    if (m_state.m_nuNeighbors[b->Color()][p] == 0)
-        return false;
-    return (   m_state.m_block[p - SG_NS] == b
-            || m_state.m_block[p - SG_WE] == b
-            || m_state.m_block[p + SG_WE] == b
-            || m_state.m_block[p + SG_NS] == b);
+    return m_state.m_block[anchor]->LibertySet().Contains(p);
 }
 
 inline bool GoBoard::CanCapture(SgPoint p, SgBlackWhite c) const
@@ -1596,6 +1833,11 @@ inline int GoBoard::NumNeighbors(SgPoint p, SgBlackWhite c) const
     return m_state.m_nuNeighbors[c][p];
 }
 
+inline int GoBoard::NuSnapshots() const
+{
+    return m_nuSnapshots;
+}
+
 inline int GoBoard::NumPrisoners(SgBlackWhite color) const
 {
     return m_state.m_prisoners[color];
@@ -1700,6 +1942,12 @@ inline SgGrid GoBoard::Size() const
     return m_size;
 }
 
+inline const SgPointSet& GoBoard::LibertySet(SgPoint p) const
+{
+    SG_ASSERT(Occupied(p));
+    return m_state.m_block[p]->LibertySet();
+}
+
 inline SgPoint GoBoard::TheLiberty(SgPoint p) const
 {
     SG_ASSERT(Occupied(p));
@@ -0,0 +1,301 @@
+//----------------------------------------------------------------------------
+/** @file GoBoardKernel.h
+    Block update operations shared by GoBoard and GoUctBoard. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_BOARDKERNEL_H
+#define GO_BOARDKERNEL_H
+
+#include "SgArray.h"
+#include "SgArrayList.h"
+#include "SgBlackWhite.h"
+#include "SgMarker.h"
+#include "SgPoint.h"
+
+//----------------------------------------------------------------------------
+
+/** Undo policy of GoBoardKernel for boards without undo.
+    Nothing is recorded. Used by GoUctBoard. */
+class GoBoardKernelNoUndo
+{
+public:
+    void AddLiberty(SgPoint p)
+    {
+        SG_UNUSED(p);
+    }
+};
+
+/** Undo policy of GoBoardKernel for boards with undo.
+    Records the liberties that were added to a block together with a stone,
+    so that they can be removed again on undo. Used by GoBoard. */
+class GoBoardKernelUndo
+{
+public:
+    explicit GoBoardKernelUndo(SgArrayList<SgPoint,4>& newLibs)
+        : m_newLibs(newLibs)
+    {
+        m_newLibs.Clear();
+    }
+
+    void AddLiberty(SgPoint p)
+    {
+        m_newLibs.PushBack(p);
+    }
+
+private:
+    SgArrayList<SgPoint,4>& m_newLibs;
+};
+
+//----------------------------------------------------------------------------
+
+/** Block update operations shared by GoBoard and GoUctBoard.
+    The boards keep their own data (point colors, neighbor counts, block
+    pointers and the storage of the blocks). The kernel contains the
+    algorithms that maintain the stones and liberties of the blocks, so that
+    fixes and optimizations apply to both boards.
+    The boards differ in what needs to be remembered for undo, which is
+    handled by the undo policy (GoBoardKernelNoUndo or GoBoardKernelUndo),
+    and in the target of a merge: a board with undo merges into a new block
+    to keep the merged blocks unchanged, a board without undo merges into
+    the largest adjacent block. Both use MergeBlocks() with a different
+    target.
+    Anchors are not updated by the kernel, because GoBoard uses the
+    smallest point of a block as the anchor, while GoUctBoard stores a
+    block at the index of its anchor and never changes it.
+    @tparam BOARD The board class. Only functions of the public interface
+    are used.
+    @tparam BLOCK The block class. Needs the functions Anchor(),
+    AppendLiberty(), AppendStone(), AppendStones(), Liberties() and
+    Stones() and the types LibertyIterator and StoneIterator. */
+template<class BOARD, class BLOCK>
+class GoBoardKernel
+{
+public:
+    /** Block pointers of the board, 0 for points without a stone. */
+    typedef SgArray<BLOCK*,SG_MAXPOINT> BlockArray;
+
+    /** Add an empty point as a liberty to the adjacent blocks of a color.
+        @param marker Marker of the board, used for marking the anchors of
+        the blocks that were already handled */
+    static void AddLibToAdjBlocks(const BOARD& bd, const BlockArray& blocks,
+                                  SgPoint p, SgBlackWhite c,
+                                  SgMarker& marker);
+
+    /** Add the liberties of a single stone block.
+        The stone must already be placed on the board. */
+    static void AddSingleStoneLiberties(const BOARD& bd, SgPoint p,
+                                        BLOCK& block);
+
+    /** Add a stone to an existing block.
+        The stone must already be placed on the board. Adds the empty
+        neighbors of the stone, which are not yet liberties of the block. */
+    template<class UNDO>
+    static void AddStoneToBlock(const BOARD& bd, BlockArray& blocks,
+                                SgPoint p, BLOCK* block, UNDO& undo);
+
+    /** Check if a point is adjacent to a block. */
+    static bool IsAdjacentTo(const BlockArray& blocks, SgPoint p,
+                             const BLOCK* block);
+
+    /** Merge the blocks adjacent to a newly placed stone into a target.
+        @param target The block that all blocks are merged into. Must
+        already contain the stone at p as a stone. Can be one of adjBlocks,
+        then its stones and liberties are kept.
+        @param marker Marker of the board, used for the liberties of the
+        merged block */
+    static void MergeBlocks(const BOARD& bd, BlockArray& blocks, SgPoint p,
+                            BLOCK& target,
+                            const SgArrayList<BLOCK*,4>& adjBlocks,
+                            SgMarker& marker);
+
+    /** See GoBoard::NeighborBlocks(SgPoint,SgBlackWhite,SgPoint[]) */
+    static void NeighborBlocks(const BOARD& bd, SgPoint p, SgBlackWhite c,
+                               SgPoint anchors[], SgMarker& marker);
+
+    /** See GoBoard::NeighborBlocks(SgPoint,SgBlackWhite,int,SgPoint[]) */
+    static void NeighborBlocks(const BOARD& bd, SgPoint p, SgBlackWhite c,
+                               int maxLib, SgPoint anchors[],
+                               SgMarker& marker);
+};
+
+template<class BOARD, class BLOCK>
+void GoBoardKernel<BOARD,BLOCK>::AddLibToAdjBlocks(const BOARD& bd,
+                                                   const BlockArray& blocks,
+                                                   SgPoint p, SgBlackWhite c,
+                                                   SgMarker& marker)
+{
+    if (bd.NumNeighbors(p, c) == 0)
+        return;
+    SgReserveMarker reserve(marker);
+    SG_UNUSED(reserve);
+    marker.Clear();
+    // Block pointers can be 0 for a stone that was just placed and is not
+    // yet part of a block
+    BLOCK* b;
+    if (bd.IsColor(p - SG_NS, c) && (b = blocks[p - SG_NS]) != 0)
+    {
+        marker.Include(b->Anchor());
+        b->AppendLiberty(p);
+    }
+    if (bd.IsColor(p + SG_NS, c) && (b = blocks[p + SG_NS]) != 0
+        && marker.NewMark(b->Anchor()))
+        b->AppendLiberty(p);
+    if (bd.IsColor(p - SG_WE, c) && (b = blocks[p - SG_WE]) != 0
+        && marker.NewMark(b->Anchor()))
+        b->AppendLiberty(p);
+    if (bd.IsColor(p + SG_WE, c) && (b = blocks[p + SG_WE]) != 0
+        && ! marker.Contains(b->Anchor()))
+        b->AppendLiberty(p);
+}
+
+template<class BOARD, class BLOCK>
+inline void GoBoardKernel<BOARD,BLOCK>::AddSingleStoneLiberties(
+                                        const BOARD& bd, SgPoint p,
+                                        BLOCK& block)
+{
+    if (bd.IsEmpty(p - SG_NS))
+        block.AppendLiberty(p - SG_NS);
+    if (bd.IsEmpty(p - SG_WE))
+        block.AppendLiberty(p - SG_WE);
+    if (bd.IsEmpty(p + SG_WE))
+        block.AppendLiberty(p + SG_WE);
+    if (bd.IsEmpty(p + SG_NS))
+        block.AppendLiberty(p + SG_NS);
+}
+
+template<class BOARD, class BLOCK>
+template<class UNDO>
+void GoBoardKernel<BOARD,BLOCK>::AddStoneToBlock(const BOARD& bd,
+                                                 BlockArray& blocks,
+                                                 SgPoint p, BLOCK* block,
+                                                 UNDO& undo)
+{
+    block->AppendStone(p);
+    if (bd.IsEmpty(p - SG_NS) && ! IsAdjacentTo(blocks, p - SG_NS, block))
+    {
+        block->AppendLiberty(p - SG_NS);
+        undo.AddLiberty(p - SG_NS);
+    }
+    if (bd.IsEmpty(p - SG_WE) && ! IsAdjacentTo(blocks, p - SG_WE, block))
+    {
+        block->AppendLiberty(p - SG_WE);
+        undo.AddLiberty(p - SG_WE);
+    }
+    if (bd.IsEmpty(p + SG_WE) && ! IsAdjacentTo(blocks, p + SG_WE, block))
+    {
+        block->AppendLiberty(p + SG_WE);
+        undo.AddLiberty(p + SG_WE);
+    }
+    if (bd.IsEmpty(p + SG_NS) && ! IsAdjacentTo(blocks, p + SG_NS, block))
+    {
+        block->AppendLiberty(p + SG_NS);
+        undo.AddLiberty(p + SG_NS);
+    }
+    blocks[p] = block;
+}
+
+template<class BOARD, class BLOCK>
+inline bool GoBoardKernel<BOARD,BLOCK>::IsAdjacentTo(const BlockArray& blocks,
+                                                     SgPoint p,
+                                                     const BLOCK* block)
+{
+    return   blocks[p - SG_NS] == block
+          || blocks[p - SG_WE] == block
+          || blocks[p + SG_WE] == block
+          || blocks[p + SG_NS] == block;
+}
+
+template<class BOARD, class BLOCK>
+void GoBoardKernel<BOARD,BLOCK>::MergeBlocks(const BOARD& bd,
+                                       BlockArray& blocks, SgPoint p,
+                                       BLOCK& target,
+                                       const SgArrayList<BLOCK*,4>& adjBlocks,
+                                       SgMarker& marker)
+{
+    SgReserveMarker reserve(marker);
+    SG_UNUSED(reserve);
+    marker.Clear();
+    for (typename BLOCK::LibertyIterator lib(target.Liberties()); lib; ++lib)
+        marker.Include(*lib);
+    for (typename SgArrayList<BLOCK*,4>::Iterator it(adjBlocks); it; ++it)
+    {
+        BLOCK* adjBlock = *it;
+        if (adjBlock == &target)
+            continue;
+        target.AppendStones(*adjBlock);
+        for (typename BLOCK::StoneIterator stn(adjBlock->Stones()); stn;
+             ++stn)
+            blocks[*stn] = &target;
+        for (typename BLOCK::LibertyIterator lib(adjBlock->Liberties()); lib;
+             ++lib)
+            if (marker.NewMark(*lib))
+                target.AppendLiberty(*lib);
+    }
+    blocks[p] = &target;
+    if (bd.IsEmpty(p - SG_NS) && marker.NewMark(p - SG_NS))
+        target.AppendLiberty(p - SG_NS);
+    if (bd.IsEmpty(p - SG_WE) && marker.NewMark(p - SG_WE))
+        target.AppendLiberty(p - SG_WE);
+    if (bd.IsEmpty(p + SG_WE) && marker.NewMark(p + SG_WE))
+        target.AppendLiberty(p + SG_WE);
+    if (bd.IsEmpty(p + SG_NS) && marker.NewMark(p + SG_NS))
+        target.AppendLiberty(p + SG_NS);
+}
+
+template<class BOARD, class BLOCK>
+void GoBoardKernel<BOARD,BLOCK>::NeighborBlocks(const BOARD& bd, SgPoint p,
+                                                SgBlackWhite c,
+                                                SgPoint anchors[],
+                                                SgMarker& marker)
+{
+    SG_ASSERT(bd.IsEmpty(p));
+    SgReserveMarker reserve(marker);
+    SG_UNUSED(reserve);
+    marker.Clear();
+    int i = 0;
+    if (bd.NumNeighbors(p, c) > 0)
+    {
+        if (bd.IsColor(p - SG_NS, c) && marker.NewMark(bd.Anchor(p - SG_NS)))
+            anchors[i++] = bd.Anchor(p - SG_NS);
+        if (bd.IsColor(p - SG_WE, c) && marker.NewMark(bd.Anchor(p - SG_WE)))
+            anchors[i++] = bd.Anchor(p - SG_WE);
+        if (bd.IsColor(p + SG_WE, c) && marker.NewMark(bd.Anchor(p + SG_WE)))
+            anchors[i++] = bd.Anchor(p + SG_WE);
+        if (bd.IsColor(p + SG_NS, c) && marker.NewMark(bd.Anchor(p + SG_NS)))
+            anchors[i++] = bd.Anchor(p + SG_NS);
+    }
+    anchors[i] = SG_ENDPOINT;
+}
+
+template<class BOARD, class BLOCK>
+void GoBoardKernel<BOARD,BLOCK>::NeighborBlocks(const BOARD& bd, SgPoint p,
+                                                SgBlackWhite c, int maxLib,
+                                                SgPoint anchors[],
+                                                SgMarker& marker)
+{
+    SG_ASSERT(bd.IsEmpty(p));
+    SgReserveMarker reserve(marker);
+    SG_UNUSED(reserve);
+    marker.Clear();
+    int i = 0;
+    if (bd.NumNeighbors(p, c) > 0)
+    {
+        if (bd.IsColor(p - SG_NS, c) && marker.NewMark(bd.Anchor(p - SG_NS))
+            && bd.AtMostNumLibs(p - SG_NS, maxLib))
+            anchors[i++] = bd.Anchor(p - SG_NS);
+        if (bd.IsColor(p - SG_WE, c) && marker.NewMark(bd.Anchor(p - SG_WE))
+            && bd.AtMostNumLibs(p - SG_WE, maxLib))
+            anchors[i++] = bd.Anchor(p - SG_WE);
+        if (bd.IsColor(p + SG_WE, c) && marker.NewMark(bd.Anchor(p + SG_WE))
+            && bd.AtMostNumLibs(p + SG_WE, maxLib))
+            anchors[i++] = bd.Anchor(p + SG_WE);
+        if (bd.IsColor(p + SG_NS, c) && marker.NewMark(bd.Anchor(p + SG_NS))
+            && bd.AtMostNumLibs(p + SG_NS, maxLib))
+            anchors[i++] = bd.Anchor(p + SG_NS);
+    }
+    anchors[i] = SG_ENDPOINT;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_BOARDKERNEL_H
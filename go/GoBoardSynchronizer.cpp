@@ -67,6 +67,10 @@ void GoBoardSynchronizer::OnUndo()
 {
 }
 
+void GoBoardSynchronizer::OnUpdate()
+{
+}
+
 void GoBoardSynchronizer::UpdateFromInit()
 {
     m_subscriber->Init(m_publisher.Size(), m_publisher.Setup());
@@ -105,6 +109,7 @@ void GoBoardSynchronizer::UpdateSubscriber()
         UpdateIncremental();
     UpdateToPlay();
     SG_ASSERT(m_publisher.GetHashCode() == m_subscriber->GetHashCode());
+    OnUpdate();
 }
 
 void GoBoardSynchronizer::UpdateToPlay()
@@ -57,6 +57,11 @@ protected:
         Default implementation does nothing. */
     virtual void OnUndo();
 
+    /** Subscriber was updated.
+        Called at the end of each UpdateSubscriber(), after the other hooks,
+        if a subscriber is set. Default implementation does nothing. */
+    virtual void OnUpdate();
+
     // @}
 
 private:
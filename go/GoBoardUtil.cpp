@@ -342,18 +342,28 @@ void GoBoardUtil::ExpandToBlocks(const GoBoard& board, SgPointSet& pointSet)
     }
 }
 
-void GoBoardUtil::DiagonalsOfColor(const GoBoard& bd, SgPoint p, int c,
-                                   SgVector<SgPoint>* diagonals)
+SgArrayList<SgPoint,4> GoBoardUtil::DiagonalsOfColor(const GoBoard& bd,
+                                                     SgPoint p, int c)
 {
-    diagonals->Clear();
+    SgArrayList<SgPoint,4> result;
     if (bd.IsColor(p - SG_NS - SG_WE, c))
-        diagonals->PushBack(p - SG_NS - SG_WE);
+        result.PushBack(p - SG_NS - SG_WE);
     if (bd.IsColor(p - SG_NS + SG_WE, c))
-        diagonals->PushBack(p - SG_NS + SG_WE);
+        result.PushBack(p - SG_NS + SG_WE);
     if (bd.IsColor(p + SG_NS - SG_WE, c))
-        diagonals->PushBack(p + SG_NS - SG_WE);
+        result.PushBack(p + SG_NS - SG_WE);
     if (bd.IsColor(p + SG_NS + SG_WE, c))
-        diagonals->PushBack(p + SG_NS + SG_WE);
+        result.PushBack(p + SG_NS + SG_WE);
+    return result;
+}
+
+void GoBoardUtil::DiagonalsOfColor(const GoBoard& bd, SgPoint p, int c,
+                                   SgVector<SgPoint>* diagonals)
+{
+    diagonals->Clear();
+    SgArrayList<SgPoint,4> result = DiagonalsOfColor(bd, p, c);
+    for (SgArrayList<SgPoint,4>::Iterator it(result); it; ++it)
+        diagonals->PushBack(*it);
 }
 
 bool GoBoardUtil::EndOfGame(const GoBoard& bd)
@@ -549,14 +559,9 @@ void GoBoardUtil::NeighborsOfColor(const GoBoard& bd, SgPoint p, int c,
                                    SgVector<SgPoint>* neighbors)
 {
     neighbors->Clear();
-    if (bd.IsColor(p - SG_NS, c))
-        neighbors->PushBack(p - SG_NS);
-    if (bd.IsColor(p - SG_WE, c))
-        neighbors->PushBack(p - SG_WE);
-    if (bd.IsColor(p + SG_WE, c))
-        neighbors->PushBack(p + SG_WE);
-    if (bd.IsColor(p + SG_NS, c))
-        neighbors->PushBack(p + SG_NS);
+    SgArrayList<SgPoint,4> result = NeighborsOfColor(bd, p, c);
+    for (SgArrayList<SgPoint,4>::Iterator it(result); it; ++it)
+        neighbors->PushBack(*it);
 }
 
 bool GoBoardUtil::TrompTaylorPassWins(const GoBoard& bd, SgBlackWhite toPlay)
@@ -655,15 +660,10 @@ void GoBoardUtil::SharedLiberties(const GoBoard& bd,
     SG_ASSERT(sharedLibs);
     SG_ASSERT(bd.Occupied(block1));
     SG_ASSERT(bd.Occupied(block2));
-    block1 = bd.Anchor(block1);
-    block2 = bd.Anchor(block2);
     sharedLibs->Clear();
-    for (GoBoard::LibertyIterator libIter(bd, block1); libIter; ++libIter)
-    {
-        SgPoint lib = *libIter;
-        if (bd.IsLibertyOfBlock(lib, block2))
-            sharedLibs->PushBack(lib);
-    }
+    const SgPointSet shared = bd.LibertySet(block1) & bd.LibertySet(block2);
+    for (SgSetIterator it(shared); it; ++it)
+        sharedLibs->PushBack(*it);
 }
 
 void GoBoardUtil::SharedLibertyBlocks(const GoBoard& bd, SgPoint anchor,
@@ -717,19 +717,7 @@ bool GoBoardUtil::AtLeastTwoSharedLibs(const GoBoard& bd, SgPoint block1,
 {
     SG_ASSERT(bd.Occupied(block1));
     SG_ASSERT(bd.Occupied(block2));
-    //block1 = bd.Anchor(block1);
-    block2 = bd.Anchor(block2);
-    bool fHasOneShared = false;
-    for (GoBoard::LibertyIterator libIter(bd, block1); libIter; ++libIter)
-    {
-        if (bd.IsLibertyOfBlock(*libIter, block2))
-        {
-            if (fHasOneShared)
-                return true;
-            fHasOneShared = true;
-        }
-    }
-    return false;
+    return bd.LibertySet(block1).MinOverlap(bd.LibertySet(block2), 2);
 }
 
 void GoBoardUtil::TestForChain(GoBoard& bd, SgPoint block, SgPoint block2,
@@ -947,18 +935,17 @@ SgRect GoBoardUtil::GetDirtyRegion(const GoBoard& bd, SgMove move,
 int GoBoardUtil::Approx2Libs(const GoBoard& board, SgPoint block,
     SgPoint p, SgBlackWhite color)
 {
-    int libs2 = 0;
+    SgPointSet libs2;
     for (SgNb4Iterator inb(p); inb; ++inb)
     {
         SgPoint nb = *inb;
         if (board.IsEmpty(nb))
-            libs2++;
+            libs2.Include(nb);
         else if (board.IsColor(nb, color)
             && board.Anchor(nb) != board.Anchor(block))
-            libs2 += board.NumLiberties(nb); // May double count libs
+            libs2 |= board.LibertySet(nb);
     }
-
-    return libs2;
+    return libs2.Size();
 }
 
 //----------------------------------------------------------------------------
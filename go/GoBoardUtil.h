@@ -53,8 +53,10 @@ namespace GoBoardUtil
     void AdjacentBlocks(const GoBoard& bd, SgPoint p, int maxLib,
                         SgVector<SgPoint>* blocks);
 
-    /** Estimate second order liberties of point p for given block
-        This is fast and approximate, may double count libs */
+    /** Estimate second order liberties of point p for given block.
+        Counts the empty neighbors of p and the liberties of the adjacent
+        blocks of the given color other than 'block'. Liberties shared by
+        several of these blocks are counted once. */
     int Approx2Libs(const GoBoard& board, SgPoint block, SgPoint p,
                     SgBlackWhite color);
 
@@ -101,7 +103,17 @@ namespace GoBoardUtil
         anchor[] must be terminated by END_POINT. */
     bool ContainsAnchor(const SgPoint anchor[], const SgPoint p);
 
-   /** Get diagonal points with a color.
+    /** Get diagonal points with a color.
+        @param bd The board.
+        @param p The point.
+        @param c The color.
+        @return Resulting point list. */
+    SgArrayList<SgPoint,4> DiagonalsOfColor(const GoBoard& bd, SgPoint p,
+                                            int c);
+
+   /** Get diagonal points with a color (SgVector version).
+       Allocates memory, use the SgArrayList version in code that is called
+       during a search.
        @param bd The board.
        @param p The point.
        @param c The color.
@@ -227,6 +239,8 @@ namespace GoBoardUtil
                                             int c);
 
     /** Get adjacent points with a color (SgVector version).
+        Allocates memory, use the SgArrayList version in code that is called
+        during a search.
         @param bd The board.
         @param p The point.
         @param c The color.
@@ -389,6 +389,47 @@ inline bool ProcessStatus(GoEyeStatus status,
         makeNakade = true;
     return status != EYE_UNKNOWN;
 }
+
+/** See GoEyeUtil::IsSinglePointEye2(const GoBoard&, SgPoint, SgBlackWhite,
+    SgVector<SgPoint>&).
+    @tparam LIST SgVector or SgArrayList. The public version without
+    assumed eyes uses a GoPointList, which does not allocate memory. */
+template<class LIST>
+bool IsSinglePointEye2List(const GoBoard& board, SgPoint p,
+                           SgBlackWhite color, LIST& eyes)
+{
+    // Must be an empty point
+    if (! board.IsColor(p, SG_EMPTY))
+        return false;
+    // All adjacent neighbours must be friendly
+    SgBoardColor opp = SgOppBW(color);
+    for (SgNb4Iterator adj(p); adj; ++adj)
+    {
+        SgBoardColor adjColor = board.GetColor(*adj);
+        if (adjColor == opp || adjColor == SG_EMPTY)
+            return false;
+    }
+    // All diagonals (with up to one exception) must be friendly or an eye
+    int baddiags = 0;
+    int maxbaddiags = (board.Line(p) == 1 ? 0 : 1);
+    for (SgNb4DiagIterator it(p); it; ++it)
+    {
+        if (board.IsColor(*it, opp))
+            ++baddiags;
+        if (board.IsColor(*it, SG_EMPTY) && ! eyes.Contains(*it))
+        {
+            // Assume this point is an eye and recurse
+            eyes.PushBack(p);
+            if (! IsSinglePointEye2List(board, *it, color, eyes))
+                ++baddiags;
+            eyes.PopBack();
+        }
+        if (baddiags > maxbaddiags)
+            return false;
+    }
+    return true;
+}
+
 } // namespace
 //----------------------------------------------------------------------------
 
@@ -540,43 +581,14 @@ bool GoEyeUtil::NumberOfMoveToEye(const GoBoard& board, SgBlackWhite color,
 bool GoEyeUtil::IsSinglePointEye2(const GoBoard& board, SgPoint p, 
                                   SgBlackWhite color, SgVector<SgPoint>& eyes)
 {
-    // Must be an empty point
-    if (! board.IsColor(p, SG_EMPTY))
-        return false;
-    // All adjacent neighbours must be friendly
-    SgBoardColor opp = SgOppBW(color);
-    for (SgNb4Iterator adj(p); adj; ++adj)
-    {
-        SgBoardColor adjColor = board.GetColor(*adj);
-        if (adjColor == opp || adjColor == SG_EMPTY)
-            return false;
-    }
-    // All diagonals (with up to one exception) must be friendly or an eye
-    int baddiags = 0;
-    int maxbaddiags = (board.Line(p) == 1 ? 0 : 1);
-    for (SgNb4DiagIterator it(p); it; ++it)
-    {
-        if (board.IsColor(*it, opp))
-            ++baddiags;
-        if (board.IsColor(*it, SG_EMPTY) && ! eyes.Contains(*it))
-        {
-            // Assume this point is an eye and recurse
-            eyes.PushBack(p);
-            if (! IsSinglePointEye2(board, *it, color, eyes))
-                ++baddiags;
-            eyes.PopBack();
-        }
-        if (baddiags > maxbaddiags)
-            return false;
-    }
-    return true;
+    return IsSinglePointEye2List(board, p, color, eyes);
 }
 
 bool GoEyeUtil::IsSinglePointEye2(const GoBoard& board, SgPoint p, 
                                   SgBlackWhite color)
 {
-    SgVector<SgPoint> emptylist;
-    return IsSinglePointEye2(board, p, color, emptylist);
+    GoPointList emptylist;
+    return IsSinglePointEye2List(board, p, color, emptylist);
 }
 
 bool GoEyeUtil::NumberOfMoveToEye2(const GoBoard& board, SgBlackWhite color,
@@ -584,7 +596,7 @@ bool GoEyeUtil::NumberOfMoveToEye2(const GoBoard& board, SgBlackWhite color,
 {
     nummoves = 0;
     bool capturing = false;
-    SgVector<SgPoint> usedpoints;
+    GoPointList usedpoints;
     usedpoints.PushBack(p);
     SgPointSet counted;
 
@@ -638,7 +650,7 @@ bool GoEyeUtil::NumberOfMoveToEye2(const GoBoard& board, SgBlackWhite color,
             int cost = 0;
 
             if (  board.IsColor(diag, SG_EMPTY)
-               && ! IsSinglePointEye2(board, diag, color, usedpoints))
+               && ! IsSinglePointEye2List(board, diag, color, usedpoints))
             {
                 cost = 1;
             }
@@ -669,7 +681,7 @@ bool GoEyeUtil::NumberOfMoveToEye2(const GoBoard& board, SgBlackWhite color,
         
         // Empty points must be filled (unless they are eyes)
         if (  board.IsColor(diag, SG_EMPTY)
-           && ! IsSinglePointEye2(board, diag, color, usedpoints))
+           && ! IsSinglePointEye2List(board, diag, color, usedpoints))
         {
             counted.Include(diag);
         }
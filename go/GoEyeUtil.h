@@ -272,11 +272,11 @@ bool GoEyeUtil::MakesNakadeShape(const BOARD& bd, SgPoint p,
     SgPointSet area;
     area.Include(p);
     int nu = 1;
-    SgVector<SgPoint> toProcess;
+    SgArrayList<SgPoint,NAKADE_LIMIT + 1> toProcess;
     toProcess.PushBack(p);
-    while (toProcess.NonEmpty())
+    while (! toProcess.IsEmpty())
     {
-        SgPoint p = toProcess.Back();
+        SgPoint p = toProcess.Last();
         toProcess.PopBack();
         for (SgNb4Iterator it(p); it; ++it)
             if (bd.IsColor(*it, toPlay) && ! area.Contains(*it))
@@ -298,9 +298,10 @@ void GoGtpEngine::CmdAllLegal(GtpCommand& cmd)
 {
     cmd.CheckNuArg(1);
     SgBlackWhite color = BlackWhiteArg(cmd, 0);
+    const SgPointSet legal = Board().AllLegal(color);
     SgVector<SgPoint> allLegal;
     for (GoBoard::Iterator p(Board()); p; ++p)
-        if (Board().IsLegal(*p, color))
+        if (legal.Contains(*p))
             allLegal.PushBack(*p);
     cmd << SgWritePointList(allLegal, "", false);
 }
@@ -836,7 +837,13 @@ void GoGtpEngine::CmdParamRules(GtpCommand& cmd)
     @arg @c fast_open_factor See SgDefaultTimeControl::FastOpenFactor()
     @arg @c fast_open_moves See SgDefaultTimeControl::FastOpenMoves()
     @arg @c final_space See GoTimeControl::FinalSpace()
-    @arg @c remaining_constant See SgDefaultTimeControl::RemainingConstant() */
+    @arg @c max_extension See SgDefaultTimeControl::MaxExtension()
+    @arg @c remaining_constant See SgDefaultTimeControl::RemainingConstant()
+    @arg @c stability See SgDefaultTimeControl::StabilityControl()
+    @arg @c stable_count_gap See SgDefaultTimeControl::StableCountGap()
+    @arg @c stable_min_time See SgDefaultTimeControl::StableMinTime()
+    @arg @c volatile_value_drop See
+    SgDefaultTimeControl::VolatileValueDrop() */
 void GoGtpEngine::CmdParamTimecontrol(GtpCommand& cmd)
 {
     SgObjectWithDefaultTimeControl* object =
@@ -853,7 +860,12 @@ void GoGtpEngine::CmdParamTimecontrol(GtpCommand& cmd)
         cmd << "fast_open_factor " << c->FastOpenFactor() << '\n'
             << "fast_open_moves " << c->FastOpenMoves() << '\n'
             << "final_space " << c->FinalSpace() << '\n'
-            << "remaining_constant " << c->RemainingConstant() << '\n';
+            << "max_extension " << c->MaxExtension() << '\n'
+            << "remaining_constant " << c->RemainingConstant() << '\n'
+            << "stability " << c->StabilityControl() << '\n'
+            << "stable_count_gap " << c->StableCountGap() << '\n'
+            << "stable_min_time " << c->StableMinTime() << '\n'
+            << "volatile_value_drop " << c->VolatileValueDrop() << '\n';
     }
     else if (cmd.NuArg() == 2)
     {
@@ -864,8 +876,18 @@ void GoGtpEngine::CmdParamTimecontrol(GtpCommand& cmd)
             c->SetFastOpenMoves(cmd.ArgMin<int>(1, 0));
         else if (name == "final_space")
             c->SetFinalSpace(max(cmd.Arg<float>(1), 0.f));
+        else if (name == "max_extension")
+            c->SetMaxExtension(max(cmd.Arg<double>(1), 1.));
         else if (name == "remaining_constant")
             c->SetRemainingConstant(max(cmd.Arg<double>(1), 0.));
+        else if (name == "stability")
+            c->SetStabilityControl(cmd.Arg<bool>(1));
+        else if (name == "stable_count_gap")
+            c->SetStableCountGap(max(cmd.Arg<double>(1), 0.));
+        else if (name == "stable_min_time")
+            c->SetStableMinTime(max(cmd.Arg<double>(1), 0.));
+        else if (name == "volatile_value_drop")
+            c->SetVolatileValueDrop(max(cmd.Arg<double>(1), 0.));
         else
             throw GtpFailure() << "unknown parameter: " << name;
     }
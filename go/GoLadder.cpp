@@ -6,6 +6,7 @@
 #include "GoLadder.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
@@ -49,7 +50,7 @@ void GoLadder::InitMaxMoveNumber()
 
 /** Marks all stones in the block p as part of the prey.
     If 'stones' is not 0, then append the stones to the existing list. */
-void GoLadder::MarkStonesAsPrey(SgPoint p, SgVector<SgPoint>* stones)
+void GoLadder::MarkStonesAsPrey(SgPoint p, GoPointList* stones)
 {
     SG_ASSERT(m_bd->IsValidPoint(p));
     if (m_bd->Occupied(p))
@@ -158,13 +159,15 @@ int GoLadder::PlayPreyMove(int depth, SgPoint move, SgPoint lib1,
 {
     int result = 0;
     GoPointList newAdj(adjBlk);
-    SgVector<SgPoint> newLib;
-    SgVector<SgPoint> newStones;
-    SgVector<SgPoint> neighbors;
+    GoPointList newLib;
+    GoPointList newStones;
+    GoPointList neighbors;
     if (move == lib1)
     {
-        NeighborsOfColor(*m_bd, move, m_preyColor, &neighbors);
-        for (SgVectorIterator<SgPoint> iter(neighbors); iter; ++iter)
+        SgArrayList<SgPoint,4> preyNeighbors =
+            NeighborsOfColor(*m_bd, move, m_preyColor);
+        for (SgArrayList<SgPoint,4>::Iterator iter(preyNeighbors); iter;
+             ++iter)
         {
             SgPoint block = *iter;
             if (! m_partOfPrey[block])
@@ -183,8 +186,8 @@ int GoLadder::PlayPreyMove(int depth, SgPoint move, SgPoint lib1,
     {
         if (move == lib1)
         {
-            NeighborsOfColor(*m_bd, move, SG_EMPTY, &neighbors);
-            for (SgVectorIterator<SgPoint> iter(newLib); iter; ++iter)
+            neighbors.PushBackList(NeighborsOfColor(*m_bd, move, SG_EMPTY));
+            for (GoPointList::Iterator iter(newLib); iter; ++iter)
             {
                 SgPoint point = *iter;
                 // Test for Empty is necessary because newLib will include
@@ -241,7 +244,8 @@ int GoLadder::PlayPreyMove(int depth, SgPoint move, SgPoint lib1,
         result = GOOD_FOR_HUNTER + depth;
     }
     m_partOfPrey.Exclude(move);
-    m_partOfPrey.Exclude(newStones);
+    for (GoPointList::Iterator it(newStones); it; ++it)
+        m_partOfPrey.Exclude(*it);
 
     return result;
 }
@@ -438,7 +442,9 @@ int GoLadder::Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
                 // (;GM[1]SZ[19]FF[3]
                 // AB[qa][pa][pb][pd][pc][qe][re][rd][rc][se]
                 // AW[pe][pf][qf][qd][qc][rb][qb][sa][sc][rf][rg][sg])
-                SgVector<SgPoint> movesToTry;
+                // Each move is included only once, so that the moves fit
+                // into a GoPointList.
+                GoPointList movesToTry;
 
                 // Liberties of adj. blocks with at most two liberties.
                 adjBlk = GoBoardUtil::AdjacentStones(*m_bd, prey);
@@ -452,24 +458,26 @@ int GoLadder::Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
                     if (m_bd->NumLiberties(block) <= 2)
                         for (GoBoard::LibertyIterator it(*m_bd, block); it;
                              ++it)
-                            movesToTry.PushBack(*it);
+                            movesToTry.Include(*it);
                 }
 
                 // Liberties of blocks.
                 ++libit;
                 SgPoint lib2 = *libit;
-                movesToTry.PushBack(lib1);
-                movesToTry.PushBack(lib2);
+                movesToTry.Include(lib1);
+                movesToTry.Include(lib2);
 
                 // Moves one away from liberties.
-                SgVector<SgPoint> neighbors;
-                NeighborsOfColor(*m_bd, lib1, SG_EMPTY, &neighbors);
-                movesToTry.Concat(&neighbors);
-                NeighborsOfColor(*m_bd, lib2, SG_EMPTY, &neighbors);
-                movesToTry.Concat(&neighbors);
+                SgArrayList<SgPoint,4> neighbors =
+                    NeighborsOfColor(*m_bd, lib1, SG_EMPTY);
+                for (SgArrayList<SgPoint,4>::Iterator it(neighbors); it; ++it)
+                    movesToTry.Include(*it);
+                neighbors = NeighborsOfColor(*m_bd, lib2, SG_EMPTY);
+                for (SgArrayList<SgPoint,4>::Iterator it(neighbors); it; ++it)
+                    movesToTry.Include(*it);
 
                 // Try whether any of these moves lead to escape.
-                for (SgVectorIterator<SgPoint> it(movesToTry); it; ++it)
+                for (GoPointList::Iterator it(movesToTry); it; ++it)
                 {
                     if (PlayIfLegal(*m_bd, *it, m_preyColor))
                     {
@@ -534,6 +542,75 @@ bool GoLadder::IsSnapback(SgPoint prey)
 
 //----------------------------------------------------------------------------
 
+GoLadderReader::GoLadderReader()
+{
+    Clear();
+}
+
+void GoLadderReader::Clear()
+{
+    m_nuLookups = 0;
+    m_nuHits = 0;
+    for (int i = 0; i < CACHE_SIZE; ++i)
+        m_cache[i].m_size = 0;
+}
+
+int GoLadderReader::Depth(int result)
+{
+    return GOOD_FOR_PREY - abs(result);
+}
+
+bool GoLadderReader::IsLadderCaptureMove(const GoBoard& constBd,
+                                         SgPoint prey, SgPoint firstMove)
+{
+    SG_ASSERT(constBd.NumLiberties(prey) == 2);
+    SG_ASSERT(constBd.IsLibertyOfBlock(firstMove, constBd.Anchor(prey)));
+    GoModBoard mbd(constBd);
+    GoBoard& bd = mbd.Board();
+    const SgBlackWhite defender = bd.GetStone(prey);
+    const SgBlackWhite attacker = SgOppBW(defender);
+    GoRestoreToPlay r(bd);
+    bd.SetToPlay(attacker);
+    if (! PlayIfLegal(bd, firstMove, attacker))
+        return false;
+    const bool isCapture = IsCaptured(bd, prey, defender);
+    bd.Undo();
+    return isCapture;
+}
+
+int GoLadderReader::Ladder(const GoBoard& bd, SgPoint prey,
+                           SgBlackWhite toPlay, bool twoLibIsEscape)
+{
+    SG_ASSERT(bd.IsValidPoint(prey));
+    SG_ASSERT(bd.Occupied(prey));
+    ++m_nuLookups;
+    const SgHashCode& hash = bd.GetHashCode();
+    const SgPoint anchor = bd.Anchor(prey);
+    const SgPoint koPoint = bd.KoPoint();
+    Entry& entry = m_cache[(hash.Hash(CACHE_SIZE) + 2 * anchor + toPlay)
+                           % CACHE_SIZE];
+    if (entry.m_size == bd.Size() && entry.m_hash == hash
+        && entry.m_prey == anchor && entry.m_koPoint == koPoint
+        && entry.m_toPlay == toPlay
+        && entry.m_twoLibIsEscape == twoLibIsEscape)
+    {
+        ++m_nuHits;
+        return entry.m_result;
+    }
+    const int result = m_ladder.Ladder(bd, prey, toPlay, 0, twoLibIsEscape);
+    SG_ASSERT(result != 0);
+    entry.m_size = bd.Size();
+    entry.m_hash = hash;
+    entry.m_prey = anchor;
+    entry.m_koPoint = koPoint;
+    entry.m_toPlay = toPlay;
+    entry.m_twoLibIsEscape = twoLibIsEscape;
+    entry.m_result = result;
+    return result;
+}
+
+//----------------------------------------------------------------------------
+
 bool GoLadderUtil::Ladder(const GoBoard& bd, SgPoint prey,
                           SgBlackWhite toPlay, bool twoLibIsEscape,
                           SgVector<SgPoint>* sequence)
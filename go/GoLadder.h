@@ -13,6 +13,7 @@
 #include "GoBoard.h"
 #include "SgBoardColor.h"
 #include "GoModBoard.h"
+#include "SgHash.h"
 #include "SgPoint.h"
 #include "SgPointSet.h"
 #include "SgVector.h"
@@ -74,7 +75,7 @@ private:
 
     bool BlockIsAdjToPrey(SgPoint p, int numAdj);
 
-    void MarkStonesAsPrey(SgPoint p, SgVector<SgPoint>* stones = 0);
+    void MarkStonesAsPrey(SgPoint p, GoPointList* stones = 0);
 
     void FilterAdjacent(GoPointList& adjBlocks);
 
@@ -101,6 +102,96 @@ private:
 
 //----------------------------------------------------------------------------
 
+/** Ladder reader with a cache of the results, for use inside the search.
+    GoLadder keeps its state in members and modifies only the board it is
+    given. A search thread owns its GoLadderReader and uses it only with its
+    own board, so no locking is needed. The reader does not compute move
+    sequences and does not allocate memory after construction.
+    The cache is a direct-mapped table. The key is the prey block and the
+    position: hash code of the stones, board size, color to play and ko
+    point. The rules of the board are not part of the key. */
+class GoLadderReader
+{
+public:
+    GoLadderReader();
+
+    /** Same as GoLadder::Ladder() without a sequence.
+        The point at 'prey' must be occupied. */
+    int Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
+               bool twoLibIsEscape = false);
+
+    /** Same as GoLadderUtil::Ladder() without a sequence. */
+    bool IsCaptured(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
+                    bool twoLibIsEscape = false);
+
+    /** Same as GoLadderUtil::IsLadderCaptureMove() */
+    bool IsLadderCaptureMove(const GoBoard& bd, SgPoint prey,
+                             SgPoint firstMove);
+
+    /** Number of moves read until a ladder with this result of Ladder()
+        was decided. */
+    static int Depth(int result);
+
+    void Clear();
+
+    /** Number of calls of Ladder() since the last Clear(). */
+    std::size_t NuLookups() const;
+
+    /** Number of calls of Ladder() answered by the cache since the last
+        Clear(). */
+    std::size_t NuHits() const;
+
+private:
+    /** Number of entries of the cache, a power of two. */
+    static const int CACHE_SIZE = 4096;
+
+    struct Entry
+    {
+        /** Board size, 0 for an unused entry. */
+        int m_size;
+
+        SgHashCode m_hash;
+
+        /** Anchor of the prey block. */
+        SgPoint m_prey;
+
+        SgPoint m_koPoint;
+
+        SgBlackWhite m_toPlay;
+
+        bool m_twoLibIsEscape;
+
+        int m_result;
+    };
+
+    GoLadder m_ladder;
+
+    std::size_t m_nuLookups;
+
+    std::size_t m_nuHits;
+
+    Entry m_cache[CACHE_SIZE];
+};
+
+inline bool GoLadderReader::IsCaptured(const GoBoard& bd, SgPoint prey,
+                                       SgBlackWhite toPlay,
+                                       bool twoLibIsEscape)
+{
+    return Ladder(bd, prey, toPlay, twoLibIsEscape) < 0;
+}
+
+inline std::size_t GoLadderReader::NuHits() const
+{
+    return m_nuHits;
+}
+
+inline std::size_t GoLadderReader::NuLookups() const
+{
+    return m_nuLookups;
+}
+
+//----------------------------------------------------------------------------
+
 namespace GoLadderUtil {
 
 /** Return whether or not the block at 'prey' can be captured in a ladder when
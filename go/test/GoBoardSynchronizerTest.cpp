@@ -96,6 +96,41 @@ BOOST_AUTO_TEST_CASE(GoBoardSynchronizerTest_Update_Undo)
     BOOST_CHECK_EQUAL(subscriber.Move(2), GoPlayerMove(SG_WHITE, Pt(4, 4)));
 }
 
+/** Synchronizer that counts the calls of OnUpdate(). */
+class CountingSynchronizer
+    : public GoBoardSynchronizer
+{
+public:
+    int m_nuUpdates;
+
+    CountingSynchronizer(const GoBoard& publisher)
+        : GoBoardSynchronizer(publisher),
+          m_nuUpdates(0)
+    { }
+
+protected:
+    void OnUpdate()
+    {
+        ++m_nuUpdates;
+    }
+};
+
+/** Test that GoBoardSynchronizer::OnUpdate is called after each update
+    with the subscriber already updated. */
+BOOST_AUTO_TEST_CASE(GoBoardSynchronizerTest_OnUpdate)
+{
+    GoBoard publisher;
+    GoBoard subscriber;
+    CountingSynchronizer synchronizer(publisher);
+    synchronizer.SetSubscriber(subscriber);
+    publisher.Play(Pt(1, 1), SG_BLACK);
+    synchronizer.UpdateSubscriber();
+    BOOST_CHECK_EQUAL(synchronizer.m_nuUpdates, 1);
+    BOOST_CHECK_EQUAL(subscriber.MoveNumber(), 1);
+    synchronizer.UpdateSubscriber();
+    BOOST_CHECK_EQUAL(synchronizer.m_nuUpdates, 2);
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
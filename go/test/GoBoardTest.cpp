@@ -8,6 +8,7 @@
 #include <boost/test/auto_unit_test.hpp>
 #include "GoBoard.h"
 #include "GoSetupUtil.h"
+#include "GoTestUtil.h"
 #include "SgWrite.h"
 
 using namespace std;
@@ -36,6 +37,37 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_Constructor_Setup)
     bd.CheckConsistency();
 }
 
+/** Compare GoBoard::AllLegal() with GoBoard::IsLegal() in random games on a
+    small board under all ko rules, with and without suicide. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_AllLegal)
+{
+    const GoRules::KoRule koRules[3] =
+        { GoRules::SIMPLEKO, GoRules::POS_SUPERKO, GoRules::SUPERKO };
+    GoTestUtil::Random random;
+    for (int i = 0; i < 6; ++i)
+    {
+        GoBoard bd(5);
+        bd.Rules().SetKoRule(koRules[i % 3]);
+        bd.Rules().SetAllowSuicide(i >= 3);
+        for (int moveNumber = 0; moveNumber < 200; ++moveNumber)
+        {
+            for (SgBWIterator it; it; ++it)
+            {
+                const SgPointSet legal = bd.AllLegal(*it);
+                for (GoBoard::Iterator p(bd); p; ++p)
+                    BOOST_CHECK_EQUAL(legal.Contains(*p),
+                                      bd.IsLegal(*p, *it));
+            }
+            SgVector<SgPoint> moves;
+            for (SgSetIterator it(bd.AllLegal(bd.ToPlay())); it; ++it)
+                moves.PushBack(*it);
+            if (moves.IsEmpty())
+                break;
+            bd.Play(moves[random.Int(moves.Length())]);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(GoBoardTest_Anchor)
 {
     GoSetup setup;
@@ -168,6 +200,41 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_GetHashCode)
     BOOST_CHECK_EQUAL(bd.GetHashCode(), h1);
 }
 
+/** Test the hash code after capturing a block that was created by merging
+    blocks.
+    The board hash code is updated with the hash code of the captured block
+    and must be equal to the hash code of the same stones created by a
+    setup. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_GetHashCode_Capture)
+{
+    GoSetup setup;
+    setup.AddWhite(Pt(1, 1));
+    setup.AddWhite(Pt(1, 2));
+    setup.AddWhite(Pt(2, 2));
+    setup.AddBlack(Pt(1, 3));
+    setup.AddBlack(Pt(2, 3));
+    setup.AddBlack(Pt(3, 1));
+    setup.m_player = SG_WHITE;
+    GoBoard bd(9, setup);
+    bd.SetKoModifiesHash(false);
+    SgHashCode h1 = bd.GetHashCode();
+    bd.Play(Pt(2, 1), SG_WHITE);
+    SgHashCode h2 = bd.GetHashCode();
+    bd.Play(Pt(3, 2), SG_BLACK);
+    BOOST_CHECK_EQUAL(bd.NumPrisoners(SG_WHITE), 4);
+    GoSetup expectedSetup;
+    expectedSetup.AddBlack(Pt(1, 3));
+    expectedSetup.AddBlack(Pt(2, 3));
+    expectedSetup.AddBlack(Pt(3, 1));
+    expectedSetup.AddBlack(Pt(3, 2));
+    GoBoard expected(9, expectedSetup);
+    BOOST_CHECK_EQUAL(bd.GetHashCode(), expected.GetHashCode());
+    bd.Undo();
+    BOOST_CHECK_EQUAL(bd.GetHashCode(), h2);
+    bd.Undo();
+    BOOST_CHECK_EQUAL(bd.GetHashCode(), h1);
+}
+
 /** Tests that the hash code is 0 for the empty positions.
     If this is changed later, make sure no code relies on that fact. */
 BOOST_AUTO_TEST_CASE(GoBoardTest_GetHashCode_EmptyPosition)
@@ -274,6 +341,63 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_Init)
                             "Point " << SgWritePoint(*it) << " not empty");
 }
 
+/** Test GoBoard::Init(const GoBoard&).
+    Copies a position with a merge and a capture into a board of a different
+    size, checks the blocks, and undoes all moves on the copy. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_Init_Copy)
+{
+    // 3 . . .
+    // 2 X O .
+    // 1 . . O
+    //   A B C
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 2));
+    setup.AddWhite(Pt(2, 2));
+    setup.AddWhite(Pt(3, 1));
+    GoBoard bd(9, setup);
+    bd.Play(Pt(2, 1), SG_BLACK);
+    bd.Play(Pt(1, 1), SG_WHITE); // captures B1
+    bd.Play(Pt(1, 3), SG_BLACK);
+    bd.Play(Pt(2, 1), SG_WHITE); // merges A1, B2 and C1
+    GoBoard copy(13);
+    copy.Init(bd);
+    BOOST_CHECK_EQUAL(copy.Size(), 9);
+    BOOST_CHECK_EQUAL(copy.MoveNumber(), 4);
+    BOOST_CHECK_EQUAL(copy.ToPlay(), SG_BLACK);
+    BOOST_CHECK(copy.GetHashCode() == bd.GetHashCode());
+    BOOST_CHECK_EQUAL(copy.NumPrisoners(SG_BLACK), 1);
+    for (GoBoard::Iterator it(bd); it; ++it)
+    {
+        SgPoint p = *it;
+        BOOST_CHECK_EQUAL(copy.GetColor(p), bd.GetColor(p));
+        if (bd.Occupied(p))
+        {
+            BOOST_CHECK_EQUAL(copy.Anchor(p), bd.Anchor(p));
+            BOOST_CHECK_EQUAL(copy.NumLiberties(p), bd.NumLiberties(p));
+            BOOST_CHECK_EQUAL(copy.NumStones(p), bd.NumStones(p));
+        }
+    }
+    BOOST_CHECK_EQUAL(copy.NumStones(Pt(1, 1)), 4);
+    // The copy uses its own blocks
+    copy.Play(Pt(3, 2), SG_BLACK);
+    BOOST_CHECK_EQUAL(bd.NumLiberties(Pt(1, 1)), 3);
+    BOOST_CHECK_EQUAL(copy.NumLiberties(Pt(1, 1)), 2);
+    while (copy.MoveNumber() > 0)
+        copy.Undo();
+    for (GoBoard::Iterator it(copy); it; ++it)
+    {
+        SgPoint p = *it;
+        if (setup.m_stones[SG_BLACK].Contains(p))
+            BOOST_CHECK_EQUAL(copy.GetColor(p), SG_BLACK);
+        else if (setup.m_stones[SG_WHITE].Contains(p))
+            BOOST_CHECK_EQUAL(copy.GetColor(p), SG_WHITE);
+        else
+            BOOST_CHECK_EQUAL(copy.GetColor(p), SG_EMPTY);
+    }
+    BOOST_CHECK_EQUAL(copy.NumLiberties(Pt(1, 2)), 2);
+    BOOST_CHECK_EQUAL(bd.NumStones(Pt(1, 1)), 4);
+}
+
 BOOST_AUTO_TEST_CASE(GoBoardTest_IsFirst)
 {
     GoBoard bd;
@@ -408,6 +532,36 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_IsLegal_PositionalSuperko)
     BOOST_CHECK(bd.IsLegal(Pt(2, 9), SG_WHITE));
 }
 
+/** Test that positional superko is detected after Undo and
+    RestoreSnapshot.
+    Checks that the set of position keys used by the repetition check stays
+    in sync with the move stack. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_IsLegal_PositionalSuperko_Undo)
+{
+    GoBoard bd(9);
+    bd.Rules().SetKoRule(GoRules::POS_SUPERKO);
+    bd.TakeSnapshot();
+    for (int i = 0; i < 2; ++i)
+    {
+        bd.Play(Pt(2, 8), SG_BLACK);
+        bd.Play(Pt(1, 8), SG_WHITE);
+        bd.Play(Pt(3, 8), SG_BLACK);
+        bd.Play(Pt(2, 9), SG_WHITE);
+        bd.Play(Pt(4, 9), SG_BLACK);
+        bd.Play(Pt(3, 9), SG_WHITE);
+        bd.Play(Pt(1, 9), SG_BLACK);
+        BOOST_CHECK(! bd.IsLegal(Pt(2, 9), SG_WHITE));
+        bd.Undo();
+        bd.Undo();
+        BOOST_CHECK_EQUAL(bd.MoveNumber(), 5);
+        bd.Play(Pt(3, 9), SG_WHITE);
+        bd.Play(Pt(1, 9), SG_BLACK);
+        BOOST_CHECK(! bd.IsLegal(Pt(2, 9), SG_WHITE));
+        bd.RestoreSnapshot();
+        BOOST_CHECK_EQUAL(bd.MoveNumber(), 0);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(GoBoardTest_IsLegal_Occupied)
 {
     GoSetup setup;
@@ -994,6 +1148,137 @@ BOOST_AUTO_TEST_CASE(GoBoardTest_SetToPlay)
     BOOST_CHECK_EQUAL(bd.ToPlay(), SG_BLACK);
 }
 
+void GoBoardTest_CheckSame(const GoBoard& bd, const GoBoard& expected)
+{
+    BOOST_CHECK_EQUAL(bd.MoveNumber(), expected.MoveNumber());
+    BOOST_CHECK_EQUAL(bd.ToPlay(), expected.ToPlay());
+    BOOST_CHECK(bd.GetHashCode() == expected.GetHashCode());
+    BOOST_CHECK_EQUAL(bd.KoPoint(), expected.KoPoint());
+    BOOST_CHECK_EQUAL(bd.NumPrisoners(SG_BLACK),
+                      expected.NumPrisoners(SG_BLACK));
+    BOOST_CHECK_EQUAL(bd.NumPrisoners(SG_WHITE),
+                      expected.NumPrisoners(SG_WHITE));
+    for (GoBoard::Iterator it(bd); it; ++it)
+    {
+        SgPoint p = *it;
+        BOOST_REQUIRE_EQUAL(bd.GetColor(p), expected.GetColor(p));
+        BOOST_CHECK_EQUAL(bd.NumEmptyNeighbors(p),
+                          expected.NumEmptyNeighbors(p));
+        if (bd.Occupied(p))
+        {
+            BOOST_CHECK_EQUAL(bd.Anchor(p), expected.Anchor(p));
+            BOOST_CHECK_EQUAL(bd.NumLiberties(p), expected.NumLiberties(p));
+            BOOST_CHECK_EQUAL(bd.NumStones(p), expected.NumStones(p));
+        }
+        else
+            BOOST_CHECK_EQUAL(bd.IsFirst(p), expected.IsFirst(p));
+    }
+}
+
+/** Play random legal moves on two boards. */
+void GoBoardTest_PlayRandom(GoBoard& bd, GoBoard& expected, int nuMoves,
+                            GoTestUtil::Random& random)
+{
+    for (int i = 0; i < nuMoves; ++i)
+    {
+        SgPoint move = GoTestUtil::RandomMove(bd, random);
+        bd.Play(move);
+        expected.Play(move);
+    }
+}
+
+/** Test restoring a snapshot after a merge of blocks.
+    The stones A1 and A2 are not adjacent to the merging move, but their
+    block changes. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_Snapshot_Merge)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 1));
+    setup.AddBlack(Pt(1, 2));
+    setup.AddBlack(Pt(1, 3));
+    setup.AddBlack(Pt(2, 4));
+    GoBoard bd(9, setup);
+    bd.TakeSnapshot();
+    bd.Play(Pt(1, 4), SG_BLACK);
+    BOOST_CHECK_EQUAL(bd.NumStones(Pt(1, 1)), 5);
+    bd.Play(Pt(5, 5), SG_WHITE);
+    bd.RestoreSnapshot();
+    BOOST_CHECK_EQUAL(bd.NumStones(Pt(1, 1)), 3);
+    BOOST_CHECK_EQUAL(bd.NumLiberties(Pt(1, 1)), 4);
+    BOOST_CHECK_EQUAL(bd.NumStones(Pt(2, 4)), 1);
+    bd.Play(Pt(2, 2), SG_WHITE);
+    BOOST_CHECK_EQUAL(bd.NumLiberties(Pt(1, 1)), 3);
+    BOOST_CHECK_EQUAL(bd.NumLiberties(Pt(1, 3)), 3);
+}
+
+/** Test that TakeSnapshot() replaces the earlier snapshots. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_Snapshot_Replace)
+{
+    GoBoard bd(9);
+    bd.Play(Pt(1, 1), SG_BLACK);
+    bd.TakeSnapshot();
+    bd.Play(Pt(2, 2), SG_WHITE);
+    bd.TakeSnapshot();
+    BOOST_CHECK_EQUAL(bd.NuSnapshots(), 1);
+    bd.Play(Pt(3, 3), SG_BLACK);
+    bd.RestoreSnapshot();
+    BOOST_CHECK_EQUAL(bd.MoveNumber(), 2);
+    BOOST_CHECK_EQUAL(bd.GetColor(Pt(2, 2)), SG_WHITE);
+    BOOST_CHECK_EQUAL(bd.GetColor(Pt(3, 3)), SG_EMPTY);
+    bd.PushSnapshot();
+    bd.TakeSnapshot();
+    BOOST_CHECK_EQUAL(bd.NuSnapshots(), 1);
+}
+
+/** Test restoring nested snapshots after random move sequences.
+    The restored positions are compared with copies of the snapshot
+    positions, also after playing further moves from the restored
+    positions. */
+BOOST_AUTO_TEST_CASE(GoBoardTest_Snapshot_Nested)
+{
+    const int nuLevels = 3;
+    GoTestUtil::Random random(1);
+    GoBoard bd(7);
+    GoBoard copies[nuLevels];
+    GoBoard expected(7);
+    for (int game = 0; game < 20; ++game)
+    {
+        bd.Init(7);
+        for (int level = 0; level < nuLevels; ++level)
+        {
+            copies[level].Init(bd);
+            bd.PushSnapshot();
+            expected.Init(bd);
+            GoBoardTest_PlayRandom(bd, expected, 12, random);
+        }
+        BOOST_CHECK_EQUAL(bd.NuSnapshots(), nuLevels);
+        bd.RestoreSnapshot();
+        GoBoardTest_CheckSame(bd, copies[nuLevels - 1]);
+        expected.Init(bd);
+        GoBoardTest_PlayRandom(bd, expected, 12, random);
+        GoBoardTest_CheckSame(bd, expected);
+        bd.RestoreSnapshot(1);
+        BOOST_CHECK_EQUAL(bd.NuSnapshots(), 2);
+        GoBoardTest_CheckSame(bd, copies[1]);
+        bd.PopSnapshot();
+        expected.Init(bd);
+        GoBoardTest_PlayRandom(bd, expected, 12, random);
+        bd.RestoreSnapshot(0);
+        BOOST_CHECK_EQUAL(bd.NuSnapshots(), 1);
+        GoBoardTest_CheckSame(bd, copies[0]);
+        expected.Init(bd);
+        GoBoardTest_PlayRandom(bd, expected, 40, random);
+        while (bd.MoveNumber() > copies[0].MoveNumber() + 20)
+        {
+            bd.Undo();
+            expected.Undo();
+        }
+        GoBoardTest_CheckSame(bd, expected);
+        bd.PopSnapshot();
+        BOOST_CHECK_EQUAL(bd.NuSnapshots(), 0);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(GoBoardTest_ToPlay)
 {
     GoBoard bd(9);
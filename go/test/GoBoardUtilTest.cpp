@@ -118,6 +118,34 @@ BOOST_AUTO_TEST_CASE(GoBoardUtilTest_AdjacentBlocks_2)
 }
 
 BOOST_AUTO_TEST_CASE(GoBoardUtilTest_DiagonalsOfColor)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 1));
+    setup.AddWhite(Pt(2, 1));
+    setup.AddWhite(Pt(1, 2));
+    GoBoard bd(9, setup);
+    SgArrayList<SgPoint,4> diags;
+    diags = DiagonalsOfColor(bd, Pt(1, 1), SG_BLACK);
+    BOOST_CHECK_EQUAL(diags.Length(), 0);
+    diags = DiagonalsOfColor(bd, Pt(1, 1), SG_WHITE);
+    BOOST_CHECK_EQUAL(diags.Length(), 0);
+    diags = DiagonalsOfColor(bd, Pt(1, 1), SG_EMPTY);
+    BOOST_CHECK_EQUAL(diags.Length(), 1);
+    BOOST_CHECK(diags.Contains(Pt(2, 2)));
+    diags = DiagonalsOfColor(bd, Pt(2, 2), SG_BLACK);
+    BOOST_CHECK_EQUAL(diags.Length(), 1);
+    BOOST_CHECK(diags.Contains(Pt(1, 1)));
+    diags = DiagonalsOfColor(bd, Pt(2, 2), SG_WHITE);
+    BOOST_CHECK_EQUAL(diags.Length(), 0);
+    diags = DiagonalsOfColor(bd, Pt(2, 2), SG_EMPTY);
+    BOOST_CHECK_EQUAL(diags.Length(), 3);
+    BOOST_CHECK(diags.Contains(Pt(3, 1)));
+    BOOST_CHECK(diags.Contains(Pt(1, 3)));
+    BOOST_CHECK(diags.Contains(Pt(3, 3)));
+}
+
+/** Test GoBoardUtil::DiagonalsOfColor (SgVector version) */
+BOOST_AUTO_TEST_CASE(GoBoardUtilTest_DiagonalsOfColor_SgVector)
 {
     GoSetup setup;
     setup.AddBlack(Pt(1, 1));
@@ -633,6 +661,42 @@ BOOST_AUTO_TEST_CASE(GoBoardUtilTest_SelfAtari_3)
     //BOOST_CHECK(! GoBoardUtil::SelfAtari(bd, Pt(9, 9))); // atari on opp.
 }
 
+BOOST_AUTO_TEST_CASE(GoBoardUtilTest_SharedLiberties)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(3, 3));
+    setup.AddWhite(Pt(4, 4));
+    setup.AddBlack(Pt(1, 1));
+    setup.AddBlack(Pt(1, 2));
+    setup.AddWhite(Pt(2, 1));
+    GoBoard bd(9, setup);
+    SgVector<SgPoint> sharedLibs;
+    GoBoardUtil::SharedLiberties(bd, Pt(3, 3), Pt(4, 4), &sharedLibs);
+    BOOST_CHECK_EQUAL(sharedLibs.Length(), 2);
+    BOOST_CHECK(sharedLibs.Contains(Pt(4, 3)));
+    BOOST_CHECK(sharedLibs.Contains(Pt(3, 4)));
+    BOOST_CHECK(GoBoardUtil::AtLeastTwoSharedLibs(bd, Pt(3, 3), Pt(4, 4)));
+    GoBoardUtil::SharedLiberties(bd, Pt(1, 2), Pt(2, 1), &sharedLibs);
+    BOOST_CHECK_EQUAL(sharedLibs.Length(), 1);
+    BOOST_CHECK(sharedLibs.Contains(Pt(2, 2)));
+    BOOST_CHECK(! GoBoardUtil::AtLeastTwoSharedLibs(bd, Pt(1, 1), Pt(2, 1)));
+    GoBoardUtil::SharedLiberties(bd, Pt(1, 1), Pt(4, 4), &sharedLibs);
+    BOOST_CHECK_EQUAL(sharedLibs.Length(), 0);
+}
+
+/** Test that GoBoardUtil::Approx2Libs counts liberties shared by the
+    adjacent blocks only once. */
+BOOST_AUTO_TEST_CASE(GoBoardUtilTest_Approx2Libs)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(3, 3));
+    setup.AddBlack(Pt(5, 3));
+    setup.AddBlack(Pt(4, 4));
+    GoBoard bd(9, setup);
+    BOOST_CHECK_EQUAL(GoBoardUtil::Approx2Libs(bd, Pt(3, 3), Pt(4, 3),
+                                               SG_BLACK), 7);
+}
+
 BOOST_AUTO_TEST_CASE(GoBoardUtilTest_TrompTaylorScore)
 {
     // . . . . . . . . .
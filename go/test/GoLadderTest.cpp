@@ -320,6 +320,47 @@ BOOST_AUTO_TEST_CASE(GoLadderTest_IsLadderEscapeMove_3)
 }
 
 
+/** Test that GoLadderReader gives the results of GoLadder and answers
+    repeated reads in the same position from the cache. */
+BOOST_AUTO_TEST_CASE(GoLadderTest_Reader)
+{
+    std::string s("......\n"
+                  ".XO...\n"
+                  "..X...\n"
+                  "......\n"
+                  "......\n"
+                  "......");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    GoBoard bd(boardSize, setup);
+    GoLadderReader reader;
+
+    int result = reader.Ladder(bd, Pt(3, 5), SG_BLACK);
+    BOOST_CHECK(result < 0);
+    // Same as the length of the capturing sequence of GoLadder
+    BOOST_CHECK_EQUAL(GoLadderReader::Depth(result) + 1, 5);
+    BOOST_CHECK(! reader.IsCaptured(bd, Pt(3, 5), SG_WHITE));
+    BOOST_CHECK_EQUAL(reader.NuHits(), 0u);
+    BOOST_CHECK_EQUAL(reader.Ladder(bd, Pt(3, 5), SG_BLACK), result);
+    BOOST_CHECK_EQUAL(reader.NuHits(), 1u);
+    BOOST_CHECK_EQUAL(reader.NuLookups(), 3u);
+    bd.CheckConsistency();
+
+    BOOST_CHECK(reader.IsLadderCaptureMove(bd, Pt(3, 5), Pt(4, 5)));
+    BOOST_CHECK(! reader.IsLadderCaptureMove(bd, Pt(3, 5), Pt(3, 6)));
+    bd.CheckConsistency();
+
+    // Another position has another key in the cache
+    bd.Play(Pt(3, 6), SG_WHITE);
+    BOOST_CHECK(! reader.IsCaptured(bd, Pt(3, 5), SG_BLACK));
+    bd.Undo();
+    BOOST_CHECK(reader.IsCaptured(bd, Pt(3, 5), SG_BLACK));
+
+    reader.Clear();
+    BOOST_CHECK_EQUAL(reader.NuLookups(), 0u);
+}
+
 //----------------------------------------------------------------------------
 
 } // namespace
@@ -0,0 +1,69 @@
+//----------------------------------------------------------------------------
+/** @file GoTestUtil.h
+    Utilities for unit tests that play pseudo-random games.
+    Used by tests that compare incrementally updated board data with a
+    computation from scratch after each move. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_TESTUTIL_H
+#define GO_TESTUTIL_H
+
+#include "GoBoard.h"
+#include "GoBoardUtil.h"
+
+//----------------------------------------------------------------------------
+
+namespace GoTestUtil
+{
+    /** Linear congruential random generator for reproducible test games.
+        Does not depend on the global seed of SgRandom, so that a test
+        plays the same games independent of the order of the tests. */
+    class Random
+    {
+    public:
+        explicit Random(unsigned int seed = 12345);
+
+        /** Get a random number in [0..range - 1]. */
+        int Int(int range);
+
+    private:
+        unsigned int m_state;
+    };
+
+    /** Select a random legal move for the color to play.
+        Does not select points that are completely surrounded, so that the
+        games do not end with filling the own eyes.
+        @return A random move or SG_PASS if there are no candidate
+        moves. */
+    template<class BOARD>
+    SgPoint RandomMove(const BOARD& bd, Random& random);
+
+} // namespace GoTestUtil
+
+inline GoTestUtil::Random::Random(unsigned int seed)
+    : m_state(seed)
+{ }
+
+inline int GoTestUtil::Random::Int(int range)
+{
+    SG_ASSERT(range > 0);
+    m_state = m_state * 1103515245 + 12345;
+    return (m_state >> 16) % range;
+}
+
+template<class BOARD>
+SgPoint GoTestUtil::RandomMove(const BOARD& bd, Random& random)
+{
+    GoPointList moves;
+    for (typename BOARD::Iterator it(bd); it; ++it)
+        if (  bd.IsLegal(*it)
+           && ! GoBoardUtil::IsCompletelySurrounded(bd, *it))
+            moves.PushBack(*it);
+    if (moves.IsEmpty())
+        return SG_PASS;
+    return moves[random.Int(moves.Length())];
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_TESTUTIL_H
@@ -30,20 +30,53 @@ const bool CONSISTENCY = false;
 //----------------------------------------------------------------------------
 
 GoUctBoard::GoUctBoard(const GoBoard& bd)
-    : m_const(bd.Size())
+    : m_position(0),
+      m_const(bd.Size()),
+      m_undo(0)
 {
+    m_selfAtariPosition.Fill(0);
     m_size = -1;
     Init(bd);
 }
 
 GoUctBoard::~GoUctBoard()
 {
+    delete m_undo;
+}
+
+inline void GoUctBoard::XorStone(SgPoint p, SgBlackWhite c)
+{
+    // Same index as in GoBoard::HashCode::XorStone()
+    m_hash.Xor(SgHashZobristTable::GetTable().Get(p + c * SG_MAXPOINT));
+}
+
+void GoUctBoard::ClearUndo()
+{
+    if (m_undo != 0)
+        m_undo->Clear();
+    m_undoPoints.clear();
+}
+
+void GoUctBoard::EnableUndo(bool enable)
+{
+    if (enable)
+    {
+        if (m_undo == 0)
+            m_undo = new SgArrayList<UndoEntry,GO_MAX_NUM_MOVES>();
+    }
+    else
+    {
+        delete m_undo;
+        m_undo = 0;
+    }
+    ClearUndo();
 }
 
 void GoUctBoard::CheckConsistency() const
 {
     if (! CONSISTENCY)
         return;
+    int nuOpenPoints = 0;
     for (SgPoint p = 0; p < SG_MAXPOINT; ++p)
     {
         if (IsBorder(p))
@@ -68,8 +101,22 @@ void GoUctBoard::CheckConsistency() const
         if (c == SG_BLACK || c == SG_WHITE)
             CheckConsistencyBlock(p);
         if (c == SG_EMPTY)
+        {
             SG_ASSERT(m_block[p] == 0);
+            if (NumEmptyNeighbors(p) > 0)
+                ++nuOpenPoints;
+            for (SgBWIterator it; it; ++it)
+            {
+                const int known = 1 << (2 * *it);
+                if (  m_selfAtariPosition[p] == m_position
+                   && (m_selfAtari[p] & known) != 0
+                   )
+                    SG_ASSERT(((m_selfAtari[p] & (known << 1)) != 0)
+                         == GoBoardUtil::SelfAtariForColor(*this, p, *it));
+            }
+        }
     }
+    SG_ASSERT(nuOpenPoints == m_nuOpenPoints);
 }
 
 void GoUctBoard::CheckConsistencyBlock(SgPoint point) const
@@ -110,41 +157,16 @@ void GoUctBoard::CheckConsistencyBlock(SgPoint point) const
 
 void GoUctBoard::AddLibToAdjBlocks(SgPoint p, SgBlackWhite c)
 {
-    if (NumNeighbors(p, c) == 0)
-        return;
-    SgReserveMarker reserve(m_marker2);
-    m_marker2.Clear();
-    Block* b;
-    if (m_color[p - SG_NS] == c && (b = m_block[p - SG_NS]) != 0)
-    {
-        m_marker2.Include(b->m_anchor);
-        b->m_liberties.PushBack(p);
-    }
-    if (m_color[p + SG_NS] == c && (b = m_block[p + SG_NS]) != 0
-        && m_marker2.NewMark(b->m_anchor))
-        b->m_liberties.PushBack(p);
-    if (m_color[p - SG_WE] == c && (b = m_block[p - SG_WE]) != 0
-        && m_marker2.NewMark(b->m_anchor))
-        b->m_liberties.PushBack(p);
-    if (m_color[p + SG_WE] == c && (b = m_block[p + SG_WE]) != 0
-        && ! m_marker2.Contains(b->m_anchor))
-        b->m_liberties.PushBack(p);
+    // Uses m_marker2, because m_marker is reserved by RemoveLibAndKill()
+    Kernel::AddLibToAdjBlocks(*this, m_block, p, c, m_marker2);
 }
 
 void GoUctBoard::AddStoneToBlock(SgPoint p, Block* block)
 {
     // Stone already placed
     SG_ASSERT(IsColor(p, block->m_color));
-    block->m_stones.PushBack(p);
-    if (IsEmpty(p - SG_NS) && ! IsAdjacentTo(p - SG_NS, block))
-        block->m_liberties.PushBack(p - SG_NS);
-    if (IsEmpty(p - SG_WE) && ! IsAdjacentTo(p - SG_WE, block))
-        block->m_liberties.PushBack(p - SG_WE);
-    if (IsEmpty(p + SG_WE) && ! IsAdjacentTo(p + SG_WE, block))
-        block->m_liberties.PushBack(p + SG_WE);
-    if (IsEmpty(p + SG_NS) && ! IsAdjacentTo(p + SG_NS, block))
-        block->m_liberties.PushBack(p + SG_NS);
-    m_block[p] = block;
+    GoBoardKernelNoUndo undo;
+    Kernel::AddStoneToBlock(*this, m_block, p, block, undo);
 }
 
 void GoUctBoard::CreateSingleStoneBlock(SgPoint p, SgBlackWhite c)
@@ -154,31 +176,18 @@ void GoUctBoard::CreateSingleStoneBlock(SgPoint p, SgBlackWhite c)
     SG_ASSERT(NumNeighbors(p, c) == 0);
     Block& block = m_blockArray[p];
     block.InitSingleStoneBlock(c, p);
-    if (IsEmpty(p - SG_NS))
-        block.m_liberties.PushBack(p - SG_NS);
-    if (IsEmpty(p - SG_WE))
-        block.m_liberties.PushBack(p - SG_WE);
-    if (IsEmpty(p + SG_WE))
-        block.m_liberties.PushBack(p + SG_WE);
-    if (IsEmpty(p + SG_NS))
-        block.m_liberties.PushBack(p + SG_NS);
+    Kernel::AddSingleStoneLiberties(*this, p, block);
     m_block[p] = &block;
 }
 
-bool GoUctBoard::IsAdjacentTo(SgPoint p,
-                              const GoUctBoard::Block* block) const
-{
-    return   m_block[p - SG_NS] == block
-          || m_block[p - SG_WE] == block
-          || m_block[p + SG_WE] == block
-          || m_block[p + SG_NS] == block;
-}
-
-void GoUctBoard::MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks)
+template<bool UNDO>
+void GoUctBoard::MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks,
+                             UndoEntry* entry)
 {
     // Stone already placed
     SG_ASSERT(IsColor(p, adjBlocks[0]->m_color));
     SG_ASSERT(NumNeighbors(p, adjBlocks[0]->m_color) > 1);
+    // Merge into the largest block to move the fewest stones
     Block* largestBlock = 0;
     int largestBlockStones = 0;
     for (SgArrayList<Block*,4>::Iterator it(adjBlocks); it; ++it)
@@ -191,50 +200,72 @@ void GoUctBoard::MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks)
             largestBlock = adjBlock;
         }
     }
+    if (UNDO)
+    {
+        entry->m_target = largestBlock;
+        entry->m_targetStones = largestBlockStones;
+        entry->m_targetLiberties = largestBlock->m_liberties.Length();
+        SaveMergedBlocks(*entry, adjBlocks);
+    }
     largestBlock->m_stones.PushBack(p);
-    SgReserveMarker reserve(m_marker);
-    m_marker.Clear();
-    for (Block::LibertyIterator lib(largestBlock->m_liberties); lib; ++lib)
-        m_marker.Include(*lib);
+    Kernel::MergeBlocks(*this, m_block, p, *largestBlock, adjBlocks,
+                        m_marker);
+}
+
+/** Store the stones and liberties of the blocks merged into the target.
+    The storage of a merged block in m_blockArray can be reused after the
+    target block was captured, so Undo() cannot restore the merged blocks
+    from there. */
+void GoUctBoard::SaveMergedBlocks(UndoEntry& entry,
+                                  const SgArrayList<Block*,4>& adjBlocks)
+{
+    entry.m_merged.Clear();
     for (SgArrayList<Block*,4>::Iterator it(adjBlocks); it; ++it)
     {
         Block* adjBlock = *it;
-        if (adjBlock == largestBlock)
+        if (adjBlock == entry.m_target)
             continue;
+        int i = entry.m_merged.Length();
+        entry.m_merged.PushBack(adjBlock);
+        entry.m_mergedStones[i] = adjBlock->m_stones.Length();
+        entry.m_mergedLiberties[i] = adjBlock->m_liberties.Length();
         for (Block::StoneIterator stn(adjBlock->m_stones); stn; ++stn)
-        {
-            largestBlock->m_stones.PushBack(*stn);
-            m_block[*stn] = largestBlock;
-        }
+            m_undoPoints.push_back(*stn);
         for (Block::LibertyIterator lib(adjBlock->m_liberties); lib; ++lib)
-            if (m_marker.NewMark(*lib))
-                largestBlock->m_liberties.PushBack(*lib);
+            m_undoPoints.push_back(*lib);
     }
-    m_block[p] = largestBlock;
-    if (IsEmpty(p - SG_NS) && m_marker.NewMark(p - SG_NS))
-        largestBlock->m_liberties.PushBack(p - SG_NS);
-    if (IsEmpty(p - SG_WE) && m_marker.NewMark(p - SG_WE))
-        largestBlock->m_liberties.PushBack(p - SG_WE);
-    if (IsEmpty(p + SG_WE) && m_marker.NewMark(p + SG_WE))
-        largestBlock->m_liberties.PushBack(p + SG_WE);
-    if (IsEmpty(p + SG_NS) && m_marker.NewMark(p + SG_NS))
-        largestBlock->m_liberties.PushBack(p + SG_NS);
 }
 
+template<bool UNDO>
 void GoUctBoard::UpdateBlocksAfterAddStone(SgPoint p, SgBlackWhite c,
-                                        const SgArrayList<Block*,4>& adjBlocks)
+                                        const SgArrayList<Block*,4>& adjBlocks,
+                                        UndoEntry* entry)
 {
     // Stone already placed
     SG_ASSERT(IsColor(p, c));
     int n = adjBlocks.Length();
     if (n == 0)
+    {
+        if (UNDO)
+            entry->m_target = 0;
         CreateSingleStoneBlock(p, c);
+    }
     else
     {
         if (n == 1)
-            AddStoneToBlock(p, adjBlocks[0]);
+        {
+            Block* block = adjBlocks[0];
+            if (UNDO)
+            {
+                entry->m_target = block;
+                entry->m_targetStones = block->m_stones.Length();
+                entry->m_targetLiberties = block->m_liberties.Length();
+                entry->m_merged.Clear();
+            }
+            AddStoneToBlock(p, block);
+        }
         else
-            MergeBlocks(p, adjBlocks);
+            MergeBlocks<UNDO>(p, adjBlocks, entry);
     }
 }
 
@@ -248,16 +279,26 @@ void GoUctBoard::Init(const GoBoard& bd)
     m_lastMove = bd.GetLastMove();
     m_secondLastMove = bd.Get2ndLastMove();
     m_toPlay = bd.ToPlay();
+    m_nuOpenPoints = 0;
+    m_hash.Clear();
+    ClearUndo();
+    NextPosition();
     for (GoBoard::Iterator it(bd); it; ++it)
     {
         SgPoint p = *it;
         SgBoardColor c = bd.GetColor(p);
         m_color[p] = c;
+        if (c != SG_EMPTY)
+            XorStone(p, c);
         m_nuNeighbors[SG_BLACK][p] = bd.NumNeighbors(p, SG_BLACK);
         m_nuNeighbors[SG_WHITE][p] = bd.NumNeighbors(p, SG_WHITE);
         m_nuNeighborsEmpty[p] = bd.NumEmptyNeighbors(p);
         if (bd.IsEmpty(p))
+        {
             m_block[p] = 0;
+            if (m_nuNeighborsEmpty[p] > 0)
+                ++m_nuOpenPoints;
+        }
         else if (bd.Anchor(p) == p)
         {
             SgBoardColor c = m_color[p];
@@ -275,6 +316,46 @@ void GoUctBoard::Init(const GoBoard& bd)
     CheckConsistency();
 }
 
+void GoUctBoard::Init(const GoUctBoard& bd)
+{
+    SG_ASSERT(&bd != this);
+    if (bd.m_size != m_size)
+    {
+        m_size = bd.m_size;
+        m_isBorder = bd.m_isBorder;
+        m_const.ChangeSize(m_size);
+    }
+    m_prisoners = bd.m_prisoners;
+    m_koPoint = bd.m_koPoint;
+    m_lastMove = bd.m_lastMove;
+    m_secondLastMove = bd.m_secondLastMove;
+    m_toPlay = bd.m_toPlay;
+    m_capturedStones = bd.m_capturedStones;
+    m_color = bd.m_color;
+    m_nuNeighborsEmpty = bd.m_nuNeighborsEmpty;
+    m_nuNeighbors[SG_BLACK] = bd.m_nuNeighbors[SG_BLACK];
+    m_nuNeighbors[SG_WHITE] = bd.m_nuNeighbors[SG_WHITE];
+    m_nuOpenPoints = bd.m_nuOpenPoints;
+    m_hash = bd.m_hash;
+    ClearUndo();
+    NextPosition();
+    m_block.Fill(0);
+    for (Iterator it(bd); it; ++it)
+    {
+        SgPoint p = *it;
+        const Block* block = bd.m_block[p];
+        if (block == 0)
+            continue;
+        // Blocks are stored in m_blockArray at the index of their anchor
+        SgPoint anchor = block->m_anchor;
+        SG_ASSERT(block == &bd.m_blockArray[anchor]);
+        m_block[p] = &m_blockArray[anchor];
+        if (p == anchor)
+            m_blockArray[anchor] = *block;
+    }
+    CheckConsistency();
+}
+
 void GoUctBoard::InitSize(const GoBoard& bd)
 {
     m_size = bd.Size();
@@ -298,34 +379,29 @@ void GoUctBoard::InitSize(const GoBoard& bd)
 void GoUctBoard::NeighborBlocks(SgPoint p, SgBlackWhite c,
                                 SgPoint anchors[]) const
 {
-    SG_ASSERT(IsEmpty(p));
-    SgReserveMarker reserve(m_marker);
-    SG_UNUSED(reserve);
-    m_marker.Clear();
-    int i = 0;
-    if (NumNeighbors(p, c) > 0)
-    {
-        if (IsColor(p - SG_NS, c) && m_marker.NewMark(Anchor(p - SG_NS)))
-            anchors[i++] = Anchor(p - SG_NS);
-        if (IsColor(p - SG_WE, c) && m_marker.NewMark(Anchor(p - SG_WE)))
-            anchors[i++] = Anchor(p - SG_WE);
-        if (IsColor(p + SG_WE, c) && m_marker.NewMark(Anchor(p + SG_WE)))
-            anchors[i++] = Anchor(p + SG_WE);
-        if (IsColor(p + SG_NS, c) && m_marker.NewMark(Anchor(p + SG_NS)))
-            anchors[i++] = Anchor(p + SG_NS);
-    }
-    anchors[i] = SG_ENDPOINT;
+    Kernel::NeighborBlocks(*this, p, c, anchors, m_marker);
 }
 
 void GoUctBoard::AddStone(SgPoint p, SgBlackWhite c)
 {
     SG_ASSERT(IsEmpty(p));
     SG_ASSERT_BW(c);
+    if (m_nuNeighborsEmpty[p] > 0)
+        --m_nuOpenPoints;
     m_color[p] = c;
-    --m_nuNeighborsEmpty[p - SG_NS];
-    --m_nuNeighborsEmpty[p - SG_WE];
-    --m_nuNeighborsEmpty[p + SG_WE];
-    --m_nuNeighborsEmpty[p + SG_NS];
+    XorStone(p, c);
+    if (--m_nuNeighborsEmpty[p - SG_NS] == 0
+        && m_color[p - SG_NS] == SG_EMPTY)
+        --m_nuOpenPoints;
+    if (--m_nuNeighborsEmpty[p - SG_WE] == 0
+        && m_color[p - SG_WE] == SG_EMPTY)
+        --m_nuOpenPoints;
+    if (--m_nuNeighborsEmpty[p + SG_WE] == 0
+        && m_color[p + SG_WE] == SG_EMPTY)
+        --m_nuOpenPoints;
+    if (--m_nuNeighborsEmpty[p + SG_NS] == 0
+        && m_color[p + SG_NS] == SG_EMPTY)
+        --m_nuOpenPoints;
     SgArray<int,SG_MAXPOINT>& nuNeighbors = m_nuNeighbors[c];
     ++nuNeighbors[p - SG_NS];
     ++nuNeighbors[p - SG_WE];
@@ -333,12 +409,46 @@ void GoUctBoard::AddStone(SgPoint p, SgBlackWhite c)
     ++nuNeighbors[p + SG_NS];
 }
 
+/** Remove liberty from adjacent block and kill it, if it is an opponent
+    block without liberties.
+    Records the changes in the undo entry, if UNDO is true. */
+template<bool UNDO>
+inline void GoUctBoard::RemoveLibFromBlock(SgPoint p, SgBlackWhite opp,
+                                           Block* b,
+                                           SgArrayList<Block*,4>& ownAdjBlocks,
+                                           UndoEntry* entry)
+{
+    int i = 0;
+    if (UNDO)
+    {
+        i = entry->m_nuLibBlocks++;
+        entry->m_libBlock[i] = b;
+        entry->m_libIndex[i] = b->ExcludeLiberty(p);
+        entry->m_nuCaptured[i] = 0;
+    }
+    else
+        b->m_liberties.Exclude(p);
+    if (b->m_color == opp)
+    {
+        if (b->m_liberties.Length() == 0)
+        {
+            if (UNDO)
+                entry->m_nuCaptured[i] = b->m_stones.Length();
+            KillBlock(b);
+        }
+    }
+    else
+        ownAdjBlocks.PushBack(b);
+}
+
 /** Remove liberty from adjacent blocks and kill opponent blocks without
     liberties.
     As a side effect, computes adjacent blocks of own color to avoid a
     second call to GetAdjacentBlocks() in UpdateBlocksAfterAddStone(). */
+template<bool UNDO>
 void GoUctBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
-                                  SgArrayList<Block*,4>& ownAdjBlocks)
+                                  SgArrayList<Block*,4>& ownAdjBlocks,
+                                  UndoEntry* entry)
 {
     SgReserveMarker reserve(m_marker);
     m_marker.Clear();
@@ -346,48 +456,14 @@ void GoUctBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
     if ((b = m_block[p - SG_NS]) != 0)
     {
         m_marker.Include(b->m_anchor);
-        b->m_liberties.Exclude(p);
-        if (b->m_color == opp)
-        {
-            if (b->m_liberties.Length() == 0)
-                KillBlock(b);
-        }
-        else
-            ownAdjBlocks.PushBack(b);
+        RemoveLibFromBlock<UNDO>(p, opp, b, ownAdjBlocks, entry);
     }
     if ((b = m_block[p - SG_WE]) != 0 && m_marker.NewMark(b->m_anchor))
-    {
-        b->m_liberties.Exclude(p);
-        if (b->m_color == opp)
-        {
-            if (b->m_liberties.Length() == 0)
-                KillBlock(b);
-        }
-        else
-            ownAdjBlocks.PushBack(b);
-    }
+        RemoveLibFromBlock<UNDO>(p, opp, b, ownAdjBlocks, entry);
     if ((b = m_block[p + SG_WE]) != 0 && m_marker.NewMark(b->m_anchor))
-    {
-        b->m_liberties.Exclude(p);
-        if (b->m_color == opp)
-        {
-            if (b->m_liberties.Length() == 0)
-                KillBlock(b);
-        }
-        else
-            ownAdjBlocks.PushBack(b);
-    }
+        RemoveLibFromBlock<UNDO>(p, opp, b, ownAdjBlocks, entry);
     if ((b = m_block[p + SG_NS]) != 0 && ! m_marker.Contains(b->m_anchor))
-    {
-        b->m_liberties.Exclude(p);
-        if (b->m_color == opp)
-        {
-            if (b->m_liberties.Length() == 0)
-                KillBlock(b);
-        }
-        else
-            ownAdjBlocks.PushBack(b);
-    }
+        RemoveLibFromBlock<UNDO>(p, opp, b, ownAdjBlocks, entry);
 }
 
 void GoUctBoard::KillBlock(const Block* block)
@@ -400,14 +476,25 @@ void GoUctBoard::KillBlock(const Block* block)
         SgPoint p = *it;
         AddLibToAdjBlocks(p, opp);
         m_color[p] = SG_EMPTY;
-        ++m_nuNeighborsEmpty[p - SG_NS];
-        ++m_nuNeighborsEmpty[p - SG_WE];
-        ++m_nuNeighborsEmpty[p + SG_WE];
-        ++m_nuNeighborsEmpty[p + SG_NS];
+        if (m_nuNeighborsEmpty[p] > 0)
+            ++m_nuOpenPoints;
+        if (++m_nuNeighborsEmpty[p - SG_NS] == 1
+            && m_color[p - SG_NS] == SG_EMPTY)
+            ++m_nuOpenPoints;
+        if (++m_nuNeighborsEmpty[p - SG_WE] == 1
+            && m_color[p - SG_WE] == SG_EMPTY)
+            ++m_nuOpenPoints;
+        if (++m_nuNeighborsEmpty[p + SG_WE] == 1
+            && m_color[p + SG_WE] == SG_EMPTY)
+            ++m_nuOpenPoints;
+        if (++m_nuNeighborsEmpty[p + SG_NS] == 1
+            && m_color[p + SG_NS] == SG_EMPTY)
+            ++m_nuOpenPoints;
         --nuNeighbors[p - SG_NS];
         --nuNeighbors[p - SG_WE];
         --nuNeighbors[p + SG_WE];
         --nuNeighbors[p + SG_NS];
+        XorStone(p, c);
         m_capturedStones.PushBack(p);
         m_block[p] = 0;
     }
@@ -419,11 +506,49 @@ void GoUctBoard::KillBlock(const Block* block)
         m_koPoint = block->m_anchor;
 }
 
+void GoUctBoard::NextPosition()
+{
+    if (++m_position == 0)
+    {
+        // Counter overflow, invalidate all entries
+        m_selfAtariPosition.Fill(0);
+        m_position = 1;
+    }
+}
+
 void GoUctBoard::Play(SgPoint p)
 {
     SG_ASSERT(p >= 0); // No special move, see SgMove
     SG_ASSERT(p == SG_PASS || (IsValidPoint(p) && IsEmpty(p)));
     CheckConsistency();
+    if (m_undo == 0)
+        // Playouts, no undo information is written
+        PlayMove<false>(p, 0);
+    else
+    {
+        m_undo->Resize(m_undo->Length() + 1);
+        UndoEntry& entry = m_undo->Last();
+        entry.m_move = p;
+        entry.m_koPoint = m_koPoint;
+        entry.m_lastMove = m_lastMove;
+        entry.m_secondLastMove = m_secondLastMove;
+        entry.m_nuOpenPoints = m_nuOpenPoints;
+        entry.m_prisoners = m_prisoners;
+        entry.m_hash = m_hash;
+        entry.m_pointsIndex = static_cast<int>(m_undoPoints.size());
+        entry.m_nuLibBlocks = 0;
+        PlayMove<true>(p, &entry);
+    }
+    CheckConsistency();
+}
+
+/** Implementation of Play().
+    @tparam UNDO Record the changes in the undo entry
+    @param p The move
+    @param entry The undo entry of the move, 0 if UNDO is false */
+template<bool UNDO>
+void GoUctBoard::PlayMove(SgPoint p, UndoEntry* entry)
+{
     m_koPoint = SG_NULLPOINT;
     m_capturedStones.Clear();
     SgBlackWhite opp = SgOppBW(m_toPlay);
@@ -432,8 +557,11 @@ void GoUctBoard::Play(SgPoint p)
         AddStone(p, m_toPlay);
         SgArrayList<Block*,4> adjBlocks;
         if (NumNeighbors(p, SG_BLACK) > 0 || NumNeighbors(p, SG_WHITE) > 0)
-            RemoveLibAndKill(p, opp, adjBlocks);
-        UpdateBlocksAfterAddStone(p, m_toPlay, adjBlocks);
+            RemoveLibAndKill<UNDO>(p, opp, adjBlocks, entry);
+        if (UNDO)
+            for (GoPointList::Iterator it(m_capturedStones); it; ++it)
+                m_undoPoints.push_back(*it);
+        UpdateBlocksAfterAddStone<UNDO>(p, m_toPlay, adjBlocks, entry);
         if (m_koPoint != SG_NULLPOINT)
             if (NumStones(p) > 1 || NumLiberties(p) > 1)
                 m_koPoint = SG_NULLPOINT;
@@ -442,7 +570,127 @@ void GoUctBoard::Play(SgPoint p)
     m_secondLastMove = m_lastMove;
     m_lastMove = p;
     m_toPlay = opp;
+    NextPosition();
+}
+
+void GoUctBoard::Undo()
+{
+    SG_ASSERT(CanUndo());
+    CheckConsistency();
+    const UndoEntry& entry = m_undo->Last();
+    SgPoint p = entry.m_move;
+    SgBlackWhite opp = m_toPlay;
+    SgBlackWhite c = SgOppBW(opp);
+    if (p != SG_PASS)
+    {
+        // m_undoPoints contains the captured stones in the order of the
+        // adjacent blocks in m_libBlock, followed by the merged blocks
+        const SgPoint* captured =
+            (m_undoPoints.empty() ? 0 : &m_undoPoints[0])
+            + entry.m_pointsIndex
+            + (m_prisoners[opp] - entry.m_prisoners[opp]);
+        Block* target = entry.m_target;
+        if (target != 0)
+        {
+            target->m_stones.Resize(entry.m_targetStones);
+            target->m_liberties.Resize(entry.m_targetLiberties);
+            const SgPoint* merged = captured;
+            for (int i = 0; i < entry.m_merged.Length(); ++i)
+            {
+                Block* block = entry.m_merged[i];
+                block->m_color = c;
+                block->m_stones.Clear();
+                for (int j = 0; j < entry.m_mergedStones[i]; ++j, ++merged)
+                {
+                    block->m_stones.PushBack(*merged);
+                    m_block[*merged] = block;
+                }
+                block->m_liberties.Clear();
+                for (int j = 0; j < entry.m_mergedLiberties[i]; ++j, ++merged)
+                    block->m_liberties.PushBack(*merged);
+            }
+        }
+        m_block[p] = 0;
+        for (int i = entry.m_nuLibBlocks - 1; i >= 0; --i)
+        {
+            Block* block = entry.m_libBlock[i];
+            int nuCaptured = entry.m_nuCaptured[i];
+            if (nuCaptured > 0)
+            {
+                captured -= nuCaptured;
+                UndoKillBlock(block, opp, captured, nuCaptured);
+            }
+            block->RestoreLiberty(p, entry.m_libIndex[i]);
+        }
+        UndoAddStone(p, c);
+        m_undoPoints.resize(entry.m_pointsIndex);
+    }
+    m_koPoint = entry.m_koPoint;
+    m_lastMove = entry.m_lastMove;
+    m_secondLastMove = entry.m_secondLastMove;
+    m_toPlay = c;
+    m_nuOpenPoints = entry.m_nuOpenPoints;
+    m_prisoners = entry.m_prisoners;
+    m_hash = entry.m_hash;
+    m_capturedStones.Clear();
+    m_undo->PopBack();
+    NextPosition();
     CheckConsistency();
 }
 
+void GoUctBoard::UndoAddStone(SgPoint p, SgBlackWhite c)
+{
+    m_color[p] = SG_EMPTY;
+    ++m_nuNeighborsEmpty[p - SG_NS];
+    ++m_nuNeighborsEmpty[p - SG_WE];
+    ++m_nuNeighborsEmpty[p + SG_WE];
+    ++m_nuNeighborsEmpty[p + SG_NS];
+    SgArray<int,SG_MAXPOINT>& nuNeighbors = m_nuNeighbors[c];
+    --nuNeighbors[p - SG_NS];
+    --nuNeighbors[p - SG_WE];
+    --nuNeighbors[p + SG_WE];
+    --nuNeighbors[p + SG_NS];
+}
+
+/** Put back the stones of a captured block.
+    Reverse of KillBlock(). The liberties that KillBlock() added to the
+    adjacent blocks are at the end of their liberty lists. The block gets no
+    liberties, the liberty at the capturing move is restored by Undo().
+    @param block The storage of the block
+    @param c The color of the block
+    @param stones The stones in the order of the stone list of the block
+    @param nuStones The number of stones */
+void GoUctBoard::UndoKillBlock(Block* block, SgBlackWhite c,
+                               const SgPoint* stones, int nuStones)
+{
+    SgBlackWhite opp = SgOppBW(c);
+    SgArray<int,SG_MAXPOINT>& nuNeighbors = m_nuNeighbors[c];
+    block->m_color = c;
+    block->m_stones.Clear();
+    block->m_liberties.Clear();
+    for (int i = nuStones - 1; i >= 0; --i)
+    {
+        SgPoint p = stones[i];
+        for (SgNb4Iterator it(p); it; ++it)
+        {
+            Block* b = m_block[*it];
+            if (b != 0 && b->m_color == opp && ! b->m_liberties.IsEmpty()
+                && b->m_liberties.Last() == p)
+                b->m_liberties.PopBack();
+        }
+        m_color[p] = c;
+        m_block[p] = block;
+        --m_nuNeighborsEmpty[p - SG_NS];
+        --m_nuNeighborsEmpty[p - SG_WE];
+        --m_nuNeighborsEmpty[p + SG_WE];
+        --m_nuNeighborsEmpty[p + SG_NS];
+        ++nuNeighbors[p - SG_NS];
+        ++nuNeighbors[p - SG_WE];
+        ++nuNeighbors[p + SG_WE];
+        ++nuNeighbors[p + SG_NS];
+    }
+    for (int i = 0; i < nuStones; ++i)
+        block->m_stones.PushBack(stones[i]);
+}
+
 //----------------------------------------------------------------------------
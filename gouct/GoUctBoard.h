@@ -9,8 +9,10 @@
 #include <bitset>
 #include <cstring>
 #include <stdint.h>
+#include <vector>
 #include <boost/static_assert.hpp>
 #include "GoBoard.h"
+#include "GoBoardKernel.h"
 #include "GoBoardUtil.h"
 #include "GoPlayerMove.h"
 #include "SgArray.h"
@@ -19,6 +21,7 @@
 #include "SgBoardColor.h"
 #include "SgMarker.h"
 #include "SgBWArray.h"
+#include "SgHash.h"
 #include "SgNbIterator.h"
 #include "SgPoint.h"
 #include "SgPointArray.h"
@@ -29,7 +32,7 @@
 /** Go board optimized for Monte Carlo simulations.
     In contrast to class GoBoard, this board makes certain assumptions
     that are usually true for Monte Carlo simulations for better efficiency:
-    - No undo
+    - Undo only if enabled with EnableUndo()
     - Alternating play
     - Simple-Ko rule
     - Suicide not allowed
@@ -59,6 +62,34 @@ public:
     /** Re-initializes the board from GoBoard position. */
     void Init(const GoBoard& bd);
 
+    /** Re-initializes the board from another GoUctBoard.
+        Cheaper than Init(const GoBoard&), because the data structures can
+        be copied directly. The moves recorded for undo are not copied. */
+    void Init(const GoUctBoard& bd);
+
+    /** Enable or disable recording the moves for Undo().
+        Disabled by default, because most users of this board never take
+        back moves. Enabling allocates the undo log, disabling clears it.
+        Init() clears the recorded moves. */
+    void EnableUndo(bool enable);
+
+    /** Check if a move was recorded that can be taken back. */
+    bool CanUndo() const;
+
+    /** Take back the last move recorded since undo was enabled.
+        Restores the exact previous state including the order of the stones
+        and liberties of the blocks, so that a sequence of moves played
+        after the undo behaves like on a freshly initialized board.
+        CapturedStones() is undefined after an undo. */
+    void Undo();
+
+    /** Zobrist hash code of the stones on the board.
+        Uses the same codes for the stones as GoBoard, but in contrast to
+        GoBoard::GetHashCode(), captures are not hashed, so positions with the
+        same stones have the same code. Maintained incrementally by Play()
+        and Undo(). */
+    const SgHashCode& GetHashCode() const;
+
     /** Return the size of this board. */
     SgGrid Size() const;
 
@@ -114,6 +145,11 @@ public:
 
     int NumEmptyNeighbors(SgPoint p) const;
 
+    /** Number of empty points with at least one empty neighbor.
+        Maintained incrementally. If it is zero, all empty points are single
+        point regions (eyes or dame). */
+    int NumOpenPoints() const;
+
     /** Includes diagonals. */
     int Num8EmptyNeighbors(SgPoint p) const;
 
@@ -262,6 +298,15 @@ public:
         ignoring any possible repetition. */
     bool CanCapture(SgPoint p, SgBlackWhite c) const;
 
+    /** Check if playing color c at the empty point p is a self-atari.
+        Same result as GoBoardUtil::SelfAtariForColor(). Points with at most
+        one empty neighbor need the liberties of the adjacent blocks, so the
+        result for them is stored in a table that is valid until the next
+        move. The playout policy checks the same points several times in a
+        position (move generators, self-atari and clump correction), the
+        repeated checks are table reads. */
+    bool SelfAtari(SgPoint p, SgBlackWhite c) const;
+
     /** Checks whether all the board data structures are in a consistent
         state. */
     void CheckConsistency() const;
@@ -289,6 +334,46 @@ private:
 
         GoPointList m_stones;
 
+        SgPoint Anchor() const { return m_anchor; }
+
+        void AppendLiberty(SgPoint p) { m_liberties.PushBack(p); }
+
+        void AppendStone(SgPoint p) { m_stones.PushBack(p); }
+
+        void AppendStones(const Block& block)
+        {
+            for (StoneIterator it(block.m_stones); it; ++it)
+                m_stones.PushBack(*it);
+        }
+
+        /** Remove a liberty like SgArrayList::Exclude().
+            @return The index of the liberty, needed for RestoreLiberty() */
+        int ExcludeLiberty(SgPoint p)
+        {
+            int i = m_liberties.Length() - 1;
+            while (m_liberties[i] != p)
+                --i;
+            m_liberties[i] = m_liberties.Last();
+            m_liberties.PopBack();
+            return i;
+        }
+
+        /** Undo ExcludeLiberty(). */
+        void RestoreLiberty(SgPoint p, int index)
+        {
+            if (index == m_liberties.Length())
+                m_liberties.PushBack(p);
+            else
+            {
+                m_liberties.PushBack(m_liberties[index]);
+                m_liberties[index] = p;
+            }
+        }
+
+        const LibertyList& Liberties() const { return m_liberties; }
+
+        const GoPointList& Stones() const { return m_stones; }
+
         void InitSingleStoneBlock(SgBlackWhite c, SgPoint anchor)
         {
             SG_ASSERT_BW(c);
@@ -308,6 +393,63 @@ private:
         }
     };
 
+    /** Block update operations shared with GoBoard. */
+    typedef GoBoardKernel<GoUctBoard,Block> Kernel;
+
+    /** Changes of a move, which are needed for taking it back.
+        The contents of a block are not saved, because the blocks only grow
+        at the end of their stone and liberty lists or lose a liberty, which
+        can be put back at its old index. The exception are blocks whose
+        storage in m_blockArray can be reused after they were captured or
+        merged into another block; the stones of captured blocks and the
+        stones and liberties of merged blocks are stored in m_undoPoints. */
+    struct UndoEntry
+    {
+        SgPoint m_move;
+
+        SgPoint m_koPoint;
+
+        SgPoint m_lastMove;
+
+        SgPoint m_secondLastMove;
+
+        int m_nuOpenPoints;
+
+        SgBWArray<int> m_prisoners;
+
+        SgHashCode m_hash;
+
+        /** Start of the points of this move in m_undoPoints. */
+        int m_pointsIndex;
+
+        /** Number of adjacent blocks that lost the liberty at m_move. */
+        int m_nuLibBlocks;
+
+        /** Adjacent blocks that lost the liberty at m_move in this order. */
+        Block* m_libBlock[4];
+
+        /** Index of the liberty m_move in the liberty list of the block. */
+        int m_libIndex[4];
+
+        /** Number of stones of the block, if it was captured, 0 otherwise. */
+        int m_nuCaptured[4];
+
+        /** Block that the new stone was added to.
+            0, if a single stone block was created. */
+        Block* m_target;
+
+        int m_targetStones;
+
+        int m_targetLiberties;
+
+        /** Blocks that were merged into m_target. */
+        SgArrayList<Block*,3> m_merged;
+
+        int m_mergedStones[3];
+
+        int m_mergedLiberties[3];
+    };
+
     SgPoint m_lastMove;
 
     SgPoint m_secondLastMove;
@@ -332,6 +474,21 @@ private:
     /** Number of black and white neighbors. */
     SgBWArray<SgArray<int,SG_MAXPOINT> > m_nuNeighbors;
 
+    /** See NumOpenPoints() */
+    int m_nuOpenPoints;
+
+    /** Counter for the positions on this board.
+        Incremented by each move, used for invalidating m_selfAtari. */
+    unsigned int m_position;
+
+    /** Position for which the entry in m_selfAtari is valid. */
+    mutable SgArray<unsigned int,SG_MAXPOINT> m_selfAtariPosition;
+
+    /** Cached results of SelfAtari().
+        Bit 2 * c is set if the result for color c is known, bit 2 * c + 1
+        contains the result. */
+    mutable SgArray<int,SG_MAXPOINT> m_selfAtari;
+
     /** Data that's constant for this board size. */
     SgBoardConst m_const;
 
@@ -348,6 +505,18 @@ private:
 
     SgArray<bool,SG_MAXPOINT> m_isBorder;
 
+    /** See GetHashCode() */
+    SgHashCode m_hash;
+
+    /** Moves recorded for Undo().
+        0, if undo is not enabled. Allocated on the heap, because it is
+        large and not needed by most boards. */
+    SgArrayList<UndoEntry,GO_MAX_NUM_MOVES>* m_undo;
+
+    /** Points needed for Undo() that are not stored in UndoEntry.
+        See UndoEntry */
+    std::vector<SgPoint> m_undoPoints;
+
     /** Not implemented. */
     GoUctBoard(const GoUctBoard&);
 
@@ -362,24 +531,50 @@ private:
 
     void InitSize(const GoBoard& bd);
 
-    bool IsAdjacentTo(SgPoint p, const Block* block) const;
+    void ClearUndo();
+
+    template<bool UNDO>
+    void MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks,
+                     UndoEntry* entry);
 
-    void MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks);
+    template<bool UNDO>
+    void PlayMove(SgPoint p, UndoEntry* entry);
 
+    template<bool UNDO>
     void RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
-                          SgArrayList<Block*,4>& ownAdjBlocks);
+                          SgArrayList<Block*,4>& ownAdjBlocks,
+                          UndoEntry* entry);
+
+    template<bool UNDO>
+    void RemoveLibFromBlock(SgPoint p, SgBlackWhite opp, Block* b,
+                            SgArrayList<Block*,4>& ownAdjBlocks,
+                            UndoEntry* entry);
 
+    template<bool UNDO>
     void UpdateBlocksAfterAddStone(SgPoint p, SgBlackWhite c,
-                                   const SgArrayList<Block*,4>& adjBlocks);
+                                   const SgArrayList<Block*,4>& adjBlocks,
+                                   UndoEntry* entry);
 
     void CheckConsistencyBlock(SgPoint p) const;
 
+    void NextPosition();
+
     bool FullBoardRepetition() const;
 
     void AddStone(SgPoint p, SgBlackWhite c);
 
     void KillBlock(const Block* block);
 
+    void SaveMergedBlocks(UndoEntry& entry,
+                          const SgArrayList<Block*,4>& adjBlocks);
+
+    void UndoAddStone(SgPoint p, SgBlackWhite c);
+
+    void UndoKillBlock(Block* block, SgBlackWhite c, const SgPoint* stones,
+                       int nuStones);
+
+    void XorStone(SgPoint p, SgBlackWhite c);
+
     bool HasLiberties(SgPoint p) const;
 
 public:
@@ -615,6 +810,16 @@ inline SgBoardColor GoUctBoard::GetColor(SgPoint p) const
     return m_color[p];
 }
 
+inline bool GoUctBoard::CanUndo() const
+{
+    return m_undo != 0 && m_undo->Length() > 0;
+}
+
+inline const SgHashCode& GoUctBoard::GetHashCode() const
+{
+    return m_hash;
+}
+
 inline SgPoint GoUctBoard::GetLastMove() const
 {
     return m_lastMove;
@@ -782,27 +987,7 @@ inline SgGrid GoUctBoard::Line(SgPoint p) const
 inline void GoUctBoard::NeighborBlocks(SgPoint p, SgBlackWhite c, int maxLib,
                                        SgPoint anchors[]) const
 {
-    SG_ASSERT(IsEmpty(p));
-    SgReserveMarker reserve(m_marker);
-    SG_UNUSED(reserve);
-    m_marker.Clear();
-    int i = 0;
-    if (NumNeighbors(p, c) > 0)
-    {
-        if (IsColor(p - SG_NS, c) && m_marker.NewMark(Anchor(p - SG_NS))
-            && AtMostNumLibs(p - SG_NS, maxLib))
-            anchors[i++] = Anchor(p - SG_NS);
-        if (IsColor(p - SG_WE, c) && m_marker.NewMark(Anchor(p - SG_WE))
-            && AtMostNumLibs(p - SG_WE, maxLib))
-            anchors[i++] = Anchor(p - SG_WE);
-        if (IsColor(p + SG_WE, c) && m_marker.NewMark(Anchor(p + SG_WE))
-            && AtMostNumLibs(p + SG_WE, maxLib))
-            anchors[i++] = Anchor(p + SG_WE);
-        if (IsColor(p + SG_NS, c) && m_marker.NewMark(Anchor(p + SG_NS))
-            && AtMostNumLibs(p + SG_NS, maxLib))
-            anchors[i++] = Anchor(p + SG_NS);
-    }
-    anchors[i] = SG_ENDPOINT;
+    Kernel::NeighborBlocks(*this, p, c, maxLib, anchors, m_marker);
 }
 
 inline int GoUctBoard::Num8Neighbors(SgPoint p, SgBlackWhite c) const
@@ -844,6 +1029,34 @@ inline int GoUctBoard::NumEmptyNeighbors(SgPoint p) const
     return m_nuNeighborsEmpty[p];
 }
 
+inline int GoUctBoard::NumOpenPoints() const
+{
+    return m_nuOpenPoints;
+}
+
+inline bool GoUctBoard::SelfAtari(SgPoint p, SgBlackWhite c) const
+{
+    SG_ASSERT(IsEmpty(p));
+    SG_ASSERT_BW(c);
+    if (m_nuNeighborsEmpty[p] >= 2)
+        return false;
+    const int known = 1 << (2 * c);
+    const int isSelfAtari = known << 1;
+    int& entry = m_selfAtari[p];
+    if (m_selfAtariPosition[p] != m_position)
+    {
+        m_selfAtariPosition[p] = m_position;
+        entry = 0;
+    }
+    if ((entry & known) == 0)
+    {
+        entry |= known;
+        if (GoBoardUtil::SelfAtariForColor(*this, p, c))
+            entry |= isSelfAtari;
+    }
+    return (entry & isSelfAtari) != 0;
+}
+
 inline int GoUctBoard::NumLiberties(SgPoint p) const
 {
     SG_ASSERT(IsValidPoint(p));
@@ -14,6 +14,7 @@
 #include "GoUctDefaultPriorKnowledge.h"
 #include "GoUctDefaultMoveFilter.h"
 #include "GoUctEstimatorStat.h"
+#include "GoUctFeatureTrainer.h"
 #include "GoUctGlobalSearch.h"
 #include "GoUctPatterns.h"
 #include "GoUctPlayer.h"
@@ -183,6 +184,7 @@ void GoUctCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "none/Deterministic Mode/deterministic_mode\n"
         "gfx/Uct Bounds/uct_bounds\n"
         "plist/Uct Default Policy/uct_default_policy\n"
+        "string/Uct Feature Weights/uct_feature_weights %r\n"
         "gfx/Uct Gfx/uct_gfx\n"
         "none/Uct Max Memory/uct_max_memory %s\n"
         "plist/Uct Moves/uct_moves\n"
@@ -204,6 +206,7 @@ void GoUctCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "none/Uct Stat Player Clear/uct_stat_player_clear\n"
         "hstring/Uct Stat Policy/uct_stat_policy\n"
         "none/Uct Stat Policy Clear/uct_stat_policy_clear\n"
+        "hstring/Uct Stat Policy Profile/uct_stat_policy_profile\n"
         "hstring/Uct Stat Search/uct_stat_search\n"
         "dboard/Uct Stat Territory/uct_stat_territory\n";
 }
@@ -245,7 +248,9 @@ void GoUctCommands::CmdBounds(GtpCommand& cmd)
 void GoUctCommands::CmdDefaultPolicy(GtpCommand& cmd)
 {
     cmd.CheckArgNone();
-    GoUctDefaultPriorKnowledge knowledge(m_bd, GoUctPlayoutPolicyParam());
+    GoUctPlayoutPolicyParam policyParam;
+    GoUctDefaultPriorKnowledgeParam param;
+    GoUctDefaultPriorKnowledge knowledge(m_bd, policyParam, param);
     SgPointSet pattern;
     SgPointSet atari;
     GoPointList empty;
@@ -299,6 +304,83 @@ void GoUctCommands::CmdEstimatorStat(GtpCommand& cmd)
                                 stepSize, fileName);
 }
 
+/** Train the weights of GoUctFeatureKnowledge on a collection of games.
+    Starts from the current weights. The weights are written to the output
+    file and used by the search, which enables
+    GoUctGlobalSearchStateParam::m_useFeatureKnowledge.<br>
+    Arguments: file with one SGF file name per line, output file,
+    number of passes over the collection (default 1), learning rate
+    (default 0.01)<br>
+    Returns: mean log-likelihood of the played moves in each pass */
+void GoUctCommands::CmdFeatureTrain(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(4);
+    if (cmd.NuArg() < 2)
+        throw GtpFailure("need at least 2 arguments");
+    const string listFile = cmd.Arg(0);
+    const string outFile = cmd.Arg(1);
+    const int nuPasses = (cmd.NuArg() > 2 ? cmd.ArgMin<int>(2, 1) : 1);
+    vector<string> files;
+    {
+        ifstream in(listFile.c_str());
+        if (! in)
+            throw GtpFailure() << "could not open " << listFile;
+        string fileName;
+        while (getline(in, fileName))
+            if (! fileName.empty())
+                files.push_back(fileName);
+    }
+    GoUctGlobalSearchStateParam& param = GlobalSearch().m_param;
+    GoUctFeatureWeights weights = param.m_featureKnowledge.m_weights;
+    GoUctFeatureTrainer trainer(weights);
+    if (cmd.NuArg() > 3)
+        trainer.SetLearningRate(cmd.Arg<float>(3));
+    for (int i = 0; i < nuPasses; ++i)
+    {
+        trainer.ClearStatistics();
+        try
+        {
+            for (vector<string>::const_iterator it = files.begin();
+                 it != files.end(); ++it)
+                trainer.TrainFile(*it);
+        }
+        catch (const SgException& e)
+        {
+            throw GtpFailure(e.what());
+        }
+        cmd << trainer.MeanLogLikelihood() << ' ';
+    }
+    ofstream out(outFile.c_str(), ios::binary);
+    weights.Write(out);
+    if (! out)
+        throw GtpFailure() << "could not write " << outFile;
+    param.m_featureKnowledge.m_weights = weights;
+    param.m_useFeatureKnowledge = true;
+}
+
+/** Load the weights of GoUctFeatureKnowledge.
+    Enables GoUctGlobalSearchStateParam::m_useFeatureKnowledge.<br>
+    Arguments: weights file as written by uct_feature_train */
+void GoUctCommands::CmdFeatureWeights(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    const string fileName = cmd.Arg(0);
+    ifstream in(fileName.c_str(), ios::binary);
+    if (! in)
+        throw GtpFailure() << "could not open " << fileName;
+    GoUctGlobalSearchStateParam& param = GlobalSearch().m_param;
+    try
+    {
+        param.m_featureKnowledge.m_weights.Read(in);
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+    param.m_useFeatureKnowledge = true;
+    cmd << param.m_featureKnowledge.m_weights.NuPatterns() << " patterns";
+}
+
 /** Return final score.
     Does a small search and uses the territory statistics to determine the
     status of blocks. */
@@ -397,9 +479,15 @@ void GoUctCommands::CmdMoves(GtpCommand& cmd)
 
     Parameters:
     @arg @c live_gfx See GoUctGlobalSearch::GlobalSearchLiveGfx
+    @arg @c early_termination See
+        GoUctGlobalSearchStateParam::m_earlyTermination
+    @arg @c ladder_attacks See
+        GoUctDefaultPriorKnowledgeParam::m_ladderAttacks
     @arg @c mercy_rule See GoUctGlobalSearchStateParam::m_mercyRule
     @arg @c territory_statistics See
         GoUctGlobalSearchStateParam::m_territoryStatistics
+    @arg @c use_feature_knowledge See
+        GoUctGlobalSearchStateParam::m_useFeatureKnowledge
     @arg @c length_modification See
         GoUctGlobalSearchStateParam::m_langthModification
     @arg @c score_modification See
@@ -415,10 +503,15 @@ void GoUctCommands::CmdParamGlobalSearch(GtpCommand& cmd)
     {
         // Boolean parameters first for better layout of GoGui parameter
         // dialog, alphabetically otherwise
-        cmd << "[bool] live_gfx " << s.GlobalSearchLiveGfx() << '\n'
+        cmd << "[bool] early_termination " << p.m_earlyTermination << '\n'
+            << "[bool] ladder_attacks " << p.m_defaultKnowledge.m_ladderAttacks
+            << '\n'
+            << "[bool] live_gfx " << s.GlobalSearchLiveGfx() << '\n'
             << "[bool] mercy_rule " << p.m_mercyRule << '\n'
             << "[bool] territory_statistics " << p.m_territoryStatistics
             << '\n'
+            << "[bool] use_feature_knowledge " << p.m_useFeatureKnowledge
+            << '\n'
             << "[bool] use_tree_filter " << p.m_useTreeFilter << '\n'
             << "[string] length_modification " << p.m_lengthModification
             << '\n'
@@ -428,10 +521,16 @@ void GoUctCommands::CmdParamGlobalSearch(GtpCommand& cmd)
     else if (cmd.NuArg() == 2)
     {
         string name = cmd.Arg(0);
-        if (name == "live_gfx")
+        if (name == "early_termination")
+            p.m_earlyTermination = cmd.Arg<bool>(1);
+        else if (name == "ladder_attacks")
+            p.m_defaultKnowledge.m_ladderAttacks = cmd.Arg<bool>(1);
+        else if (name == "live_gfx")
             s.SetGlobalSearchLiveGfx(cmd.Arg<bool>(1));
         else if (name == "mercy_rule")
             p.m_mercyRule = cmd.Arg<bool>(1);
+        else if (name == "use_feature_knowledge")
+            p.m_useFeatureKnowledge = cmd.Arg<bool>(1);
         else if (name == "use_tree_filter")
             p.m_useTreeFilter = cmd.BoolArg(1);
         else if (name == "territory_statistics")
@@ -457,10 +556,12 @@ void GoUctCommands::CmdParamGlobalSearch(GtpCommand& cmd)
     @arg @c forced_opening_moves See GoUctPlayer::ForcedOpeningMoves
     @arg @c ignore_clock See GoUctPlayer::IgnoreClock
     @arg @c ponder See GoUctPlayer::EnablePonder
+    @arg @c prepare_init_tree See GoUctPlayer::PrepareInitTree
     @arg @c reuse_subtree See GoUctPlayer::ReuseSubtree
     @arg @c use_root_filter See GoUctPlayer::UseRootFilter
     @arg @c max_games See GoUctPlayer::MaxGames
     @arg @c max_ponder_time See GoUctPlayer::MaxPonderTime
+    @arg @c ponder_candidates See GoUctPlayer::PonderCandidates
     @arg @c resign_min_games See GoUctPlayer::ResignMinGames
     @arg @c resign_threshold See GoUctPlayer::ResignThreshold
     @arg @c search_mode @c playout|uct|one_ply See GoUctPlayer::SearchMode */
@@ -477,10 +578,12 @@ void GoUctCommands::CmdParamPlayer(GtpCommand& cmd)
             << "[bool] forced_opening_moves " << p.ForcedOpeningMoves() << '\n'
             << "[bool] ignore_clock " << p.IgnoreClock() << '\n'
             << "[bool] ponder " << p.EnablePonder() << '\n'
+            << "[bool] prepare_init_tree " << p.PrepareInitTree() << '\n'
             << "[bool] reuse_subtree " << p.ReuseSubtree() << '\n'
             << "[bool] use_root_filter " << p.UseRootFilter() << '\n'
             << "[string] max_games " << p.MaxGames() << '\n'
             << "[string] max_ponder_time " << p.MaxPonderTime() << '\n'
+            << "[string] ponder_candidates " << p.PonderCandidates() << '\n'
             << "[string] resign_min_games " << p.ResignMinGames() << '\n'
             << "[string] resign_threshold " << p.ResignThreshold() << '\n'
             << "[list/playout_policy/uct/one_ply] search_mode "
@@ -505,6 +608,8 @@ void GoUctCommands::CmdParamPlayer(GtpCommand& cmd)
             p.SetIgnoreClock(cmd.Arg<bool>(1));
         else if (name == "ponder")
             p.SetEnablePonder(cmd.Arg<bool>(1));
+        else if (name == "prepare_init_tree")
+            p.SetPrepareInitTree(cmd.Arg<bool>(1));
         else if (name == "reuse_subtree")
             p.SetReuseSubtree(cmd.Arg<bool>(1));
         else if (name == "use_root_filter")
@@ -513,6 +618,8 @@ void GoUctCommands::CmdParamPlayer(GtpCommand& cmd)
             p.SetMaxGames(cmd.ArgMin<SgUctValue>(1, SgUctValue(1)));
         else if (name == "max_ponder_time")
             p.SetMaxPonderTime(cmd.ArgMin<SgUctValue>(1, 0));
+        else if (name == "ponder_candidates")
+            p.SetPonderCandidates(cmd.ArgMin<int>(1, 0));
         else if (name == "resign_min_games")
             p.SetResignMinGames(cmd.ArgMin<SgUctValue>(1, SgUctValue(0)));
         else if (name == "resign_threshold")
@@ -538,7 +645,9 @@ void GoUctCommands::CmdParamPlayer(GtpCommand& cmd)
     @arg @c nakade_heuristic
         See GoUctPlayoutPolicyParam::m_useNakadeHeuristic
     @arg @c fillboard_tries
-        See GoUctPlayoutPolicyParam::m_fillboardTries */
+        See GoUctPlayoutPolicyParam::m_fillboardTries
+    @arg @c profile_interval
+        See GoUctPlayoutPolicyParam::m_profileInterval */
 void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
 {
     cmd.CheckNuArgLessEqual(2);
@@ -549,7 +658,8 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
         // dialog, alphabetically otherwise
         cmd << "[bool] nakade_heuristic " << p.m_useNakadeHeuristic << '\n'
             << "[bool] statistics_enabled " << p.m_statisticsEnabled << '\n'
-            << "fillboard_tries " << p.m_fillboardTries << '\n';
+            << "fillboard_tries " << p.m_fillboardTries << '\n'
+            << "profile_interval " << p.m_profileInterval << '\n';
     }
     else if (cmd.NuArg() == 2)
     {
@@ -560,6 +670,8 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
             p.m_statisticsEnabled = cmd.Arg<bool>(1);
         else if (name == "fillboard_tries")
             p.m_fillboardTries = cmd.Arg<int>(1);
+        else if (name == "profile_interval")
+            p.m_profileInterval = cmd.ArgMin<int>(1, 0);
         else
             throw GtpFailure() << "unknown parameter: " << name;
     }
@@ -574,7 +686,8 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
     @arg @c check_ladders See GoUctDefaultMoveFilter::CheckLadders() 
     @arg @c check_offensive_ladders See GoUctDefaultMoveFilter::CheckOffensiveLadders() 
     @arg @c check_safety See GoUctDefaultMoveFilter::CheckSafety()
-    @arg @c check_filter_first_line See GoUctDefaultMoveFilter::FilterFirstLine() */
+    @arg @c check_filter_first_line See GoUctDefaultMoveFilter::FilterFirstLine()
+    @arg @c ladder_threads See GoUctDefaultMoveFilterParam::LadderThreads() */
 void GoUctCommands::CmdParamRootFilter(GtpCommand& cmd)
 {
     cmd.CheckNuArgLessEqual(2);
@@ -587,6 +700,7 @@ void GoUctCommands::CmdParamRootFilter(GtpCommand& cmd)
         cmd << "[bool] check_offensive_ladders " << p.CheckOffensiveLadders() << '\n';
         cmd << "[bool] check_safety " << p.CheckSafety() << '\n';
         cmd << "[bool] filter_first_line " << p.FilterFirstLine() << '\n';
+        cmd << "[string] ladder_threads " << p.LadderThreads() << '\n';
     }
     else if (cmd.NuArg() == 2)
     {
@@ -599,6 +713,8 @@ void GoUctCommands::CmdParamRootFilter(GtpCommand& cmd)
             p.SetCheckSafety(cmd.Arg<bool>(1));
         else if (name == "filter_first_line")
             p.SetFilterFirstLine(cmd.Arg<bool>(1));
+        else if (name == "ladder_threads")
+            p.SetLadderThreads(cmd.ArgMin<int>(1, 1));
         else
             throw GtpFailure() << "unknown parameter: " << name;
     }
@@ -613,7 +729,8 @@ void GoUctCommands::CmdParamRootFilter(GtpCommand& cmd)
     @arg @c check_ladders See GoUctDefaultMoveFilter::CheckLadders() 
     @arg @c check_offensive_ladders See GoUctDefaultMoveFilter::CheckOffensiveLadders() 
     @arg @c check_safety See GoUctDefaultMoveFilter::CheckSafety()
-    @arg @c check_filter_first_line See GoUctDefaultMoveFilter::FilterFirstLine() */
+    @arg @c check_filter_first_line See GoUctDefaultMoveFilter::FilterFirstLine()
+    @arg @c incremental See GoUctDefaultMoveFilter::Incremental() */
 void GoUctCommands::CmdParamTreeFilter(GtpCommand& cmd)
 {
     cmd.CheckNuArgLessEqual(2);
@@ -626,6 +743,7 @@ void GoUctCommands::CmdParamTreeFilter(GtpCommand& cmd)
         cmd << "[bool] check_offensive_ladders " << p.CheckOffensiveLadders() << '\n';
         cmd << "[bool] check_safety " << p.CheckSafety() << '\n';
         cmd << "[bool] filter_first_line " << p.FilterFirstLine() << '\n';
+        cmd << "[bool] incremental " << p.Incremental() << '\n';
     }
     else if (cmd.NuArg() == 2)
     {
@@ -638,6 +756,8 @@ void GoUctCommands::CmdParamTreeFilter(GtpCommand& cmd)
             p.SetCheckSafety(cmd.Arg<bool>(1));
         else if (name == "filter_first_line")
             p.SetFilterFirstLine(cmd.Arg<bool>(1));
+        else if (name == "incremental")
+            p.SetIncremental(cmd.Arg<bool>(1));
         else
             throw GtpFailure() << "unknown parameter: " << name;
     }
@@ -658,6 +778,7 @@ void GoUctCommands::CmdParamTreeFilter(GtpCommand& cmd)
     @arg @c weight_rave_updates SgUctSearch::WeightRaveUpdates
     @arg @c bias_term_constant See SgUctSearch::BiasTermConstant
     @arg @c bias_term_frequency See SgUctSearch::BiasTermFrequency
+    @arg @c deferred_expansion See SgUctSearch::DeferredExpansion
     @arg @c expand_threshold See SgUctSearch::ExpandThreshold
     @arg @c first_play_urgency See SgUctSearch::FirstPlayUrgency
     @arg @c knowledge_threshold See SgUctSearch::KnowledgeThreshold
@@ -667,9 +788,14 @@ void GoUctCommands::CmdParamTreeFilter(GtpCommand& cmd)
     @arg @c move_select @c value|count|bound|rave See SgUctSearch::MoveSelect
     @arg @c number_threads See SgUctSearch::NumberThreads
     @arg @c number_playouts See SgUctSearch::NumberPlayouts
+    @arg @c progressive_bias See SgUctSearch::ProgressiveBiasConstant
+    @arg @c progressive_widening See SgUctSearch::ProgressiveWidening
     @arg @c prune_min_count See SgUctSearch::PruneMinCount
     @arg @c rave_weight_final See SgUctSearch::RaveWeightFinal
-    @arg @c rave_weight_initial See SgUctSearch::RaveWeightInitial */
+    @arg @c rave_weight_initial See SgUctSearch::RaveWeightInitial
+    @arg @c widening_base See SgUctSearch::WideningBase
+    @arg @c widening_factor See SgUctSearch::WideningFactor
+    @arg @c widening_initial See SgUctSearch::WideningInitial */
 void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
 {
     cmd.CheckNuArgLessEqual(2);
@@ -680,9 +806,12 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
         // dialog, alphabetically otherwise
         cmd << "[bool] check_float_precision " << s.CheckFloatPrecision()
             << '\n'
+            << "[bool] deferred_expansion " << s.DeferredExpansion() << '\n'
             << "[bool] keep_games " << s.KeepGames() << '\n'
             << "[bool] lock_free " << s.LockFree() << '\n'
             << "[bool] log_games " << s.LogGames() << '\n'
+            << "[bool] progressive_widening " << s.ProgressiveWidening()
+            << '\n'
             << "[bool] prune_full_tree " << s.PruneFullTree() << '\n'
             << "[bool] rave " << s.Rave() << '\n'
             << "[bool] virtual_loss " << s.VirtualLoss() << '\n'
@@ -704,12 +833,17 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
             << MoveSelectToString(s.MoveSelect()) << '\n'
             << "[string] number_threads " << s.NumberThreads() << '\n'
             << "[string] number_playouts " << s.NumberPlayouts() << '\n'
+            << "[string] progressive_bias " << s.ProgressiveBiasConstant()
+            << '\n'
             << "[string] prune_min_count " << s.PruneMinCount() << '\n'
             << "[string] randomize_rave_frequency " 
             << s.RandomizeRaveFrequency() << '\n'
             << "[string] rave_weight_final " << s.RaveWeightFinal() << '\n'
             << "[string] rave_weight_initial "
-            << s.RaveWeightInitial() << '\n';
+            << s.RaveWeightInitial() << '\n'
+            << "[string] widening_base " << s.WideningBase() << '\n'
+            << "[string] widening_factor " << s.WideningFactor() << '\n'
+            << "[string] widening_initial " << s.WideningInitial() << '\n';
 
     }
     else if (cmd.NuArg() == 2)
@@ -723,6 +857,8 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
 
         if (name == "check_float_precision")
             s.SetCheckFloatPrecision(cmd.Arg<bool>(1));
+        else if (name == "deferred_expansion")
+            s.SetDeferredExpansion(cmd.Arg<bool>(1));
         else if (name == "keep_games")
             s.SetKeepGames(cmd.Arg<bool>(1));
         else if (name == "knowledge_threshold")
@@ -733,6 +869,8 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
             s.SetLockFree(cmd.Arg<bool>(1));
         else if (name == "log_games")
             s.SetLogGames(cmd.Arg<bool>(1));
+        else if (name == "progressive_widening")
+            s.SetProgressiveWidening(cmd.Arg<bool>(1));
         else if (name == "prune_full_tree")
             s.SetPruneFullTree(cmd.Arg<bool>(1));
         else if (name == "randomize_rave_frequency")
@@ -765,12 +903,30 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
              s.SetNumberThreads(cmd.ArgMin<unsigned int>(1, 1));
         else if (name == "number_playouts")
             s.SetNumberPlayouts(cmd.ArgMin<int>(1, 1));
+        else if (name == "progressive_bias")
+            s.SetProgressiveBiasConstant(cmd.ArgMin<SgUctValue>(1, 0));
         else if (name == "prune_min_count")
             s.SetPruneMinCount(cmd.ArgMin<SgUctValue>(1, SgUctValue(1)));
         else if (name == "rave_weight_final")
             s.SetRaveWeightFinal(cmd.Arg<float>(1));
         else if (name == "rave_weight_initial")
             s.SetRaveWeightInitial(cmd.Arg<float>(1));
+        else if (name == "widening_base")
+        {
+            const SgUctValue base = cmd.Arg<SgUctValue>(1);
+            if (base <= 0)
+                throw GtpFailure() << "widening_base must be positive";
+            s.SetWideningBase(base);
+        }
+        else if (name == "widening_factor")
+        {
+            const SgUctValue factor = cmd.Arg<SgUctValue>(1);
+            if (factor <= 1)
+                throw GtpFailure() << "widening_factor must be greater than 1";
+            s.SetWideningFactor(factor);
+        }
+        else if (name == "widening_initial")
+            s.SetWideningInitial(cmd.ArgMin<int>(1, 1));
         else
             throw GtpFailure() << "unknown parameter: " << name;
 
@@ -1004,6 +1160,20 @@ void GoUctCommands::CmdStatPolicyClear(GtpCommand& cmd)
     Policy(0).ClearStatistics();
 }
 
+/** Write time and hit rate of the stages of the playout policy.
+    Arguments: none <br>
+    Needs enabling the profiling with
+    <code>uct_param_policy profile_interval</code>.
+    Contains the merged profiles of all threads' policies in the last search.
+    @see GoUctPlayoutPolicyProfile */
+void GoUctCommands::CmdStatPolicyProfile(GtpCommand& cmd)
+{
+    cmd.CheckArgNone();
+    if (Player().m_playoutPolicyParam.m_profileInterval == 0)
+        SgWarning() << "profiling not enabled in policy parameters\n";
+    GlobalSearch().PolicyProfile().Write(cmd);
+}
+
 /** Write statistics of search and tree.
     Arguments: none
     @see SgUctSearch::WriteStatistics() */
@@ -1191,6 +1361,8 @@ void GoUctCommands::Register(GtpEngine& e)
     Register(e, "uct_bounds", &GoUctCommands::CmdBounds);
     Register(e, "uct_default_policy", &GoUctCommands::CmdDefaultPolicy);
     Register(e, "uct_estimator_stat", &GoUctCommands::CmdEstimatorStat);
+    Register(e, "uct_feature_train", &GoUctCommands::CmdFeatureTrain);
+    Register(e, "uct_feature_weights", &GoUctCommands::CmdFeatureWeights);
     Register(e, "uct_gfx", &GoUctCommands::CmdGfx);
     Register(e, "uct_max_memory", &GoUctCommands::CmdMaxMemory);
     Register(e, "uct_moves", &GoUctCommands::CmdMoves);
@@ -1214,6 +1386,8 @@ void GoUctCommands::Register(GtpEngine& e)
     Register(e, "uct_stat_player_clear", &GoUctCommands::CmdStatPlayerClear);
     Register(e, "uct_stat_policy", &GoUctCommands::CmdStatPolicy);
     Register(e, "uct_stat_policy_clear", &GoUctCommands::CmdStatPolicyClear);
+    Register(e, "uct_stat_policy_profile",
+             &GoUctCommands::CmdStatPolicyProfile);
     Register(e, "uct_stat_search", &GoUctCommands::CmdStatSearch);
     Register(e, "uct_stat_territory", &GoUctCommands::CmdStatTerritory);
     Register(e, "uct_value", &GoUctCommands::CmdValue);
@@ -41,6 +41,8 @@ public:
         - @link CmdDefaultPolicy() @c uct_default_policy @endlink
         - @link CmdDeterministicMode() @c deterministic_mode @endlink
         - @link CmdEstimatorStat() @c uct_estimator_stat @endlink
+        - @link CmdFeatureTrain() @c uct_feature_train @endlink
+        - @link CmdFeatureWeights() @c uct_feature_weights @endlink
         - @link CmdGfx() @c uct_gfx @endlink
         - @link CmdMaxMemory() @c uct_max_memory @endlink
         - @link CmdMoves() @c uct_moves @endlink
@@ -63,6 +65,7 @@ public:
         - @link CmdStatPlayerClear() @c uct_stat_player_clear @endlink
         - @link CmdStatPolicy() @c uct_stat_policy @endlink
         - @link CmdStatPolicyClear() @c uct_stat_policy_clear @endlink
+        - @link CmdStatPolicyProfile() @c uct_stat_policy_profile @endlink
         - @link CmdStatSearch() @c uct_stat_search @endlink
         - @link CmdStatTerritory() @c uct_stat_territory @endlink
         - @link CmdValue() @c uct_value @endlink
@@ -74,6 +77,8 @@ public:
     void CmdDefaultPolicy(GtpCommand& cmd);
     void CmdDeterministicMode(GtpCommand&);
     void CmdEstimatorStat(GtpCommand& cmd);
+    void CmdFeatureTrain(GtpCommand& cmd);
+    void CmdFeatureWeights(GtpCommand& cmd);
     void CmdFinalScore(GtpCommand&);
     void CmdFinalStatusList(GtpCommand&);
     void CmdGfx(GtpCommand& cmd);
@@ -98,6 +103,7 @@ public:
     void CmdStatPlayerClear(GtpCommand& cmd);
     void CmdStatPolicy(GtpCommand& cmd);
     void CmdStatPolicyClear(GtpCommand& cmd);
+    void CmdStatPolicyProfile(GtpCommand& cmd);
     void CmdStatSearch(GtpCommand& cmd);
     void CmdStatTerritory(GtpCommand& cmd);
     void CmdValue(GtpCommand& cmd);
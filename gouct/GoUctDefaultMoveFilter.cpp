@@ -6,9 +6,14 @@
 #include "SgSystem.h"
 #include "GoUctDefaultMoveFilter.h"
 
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
 #include "GoBensonSolver.h"
 #include "GoBoard.h"
+#include "GoBoardSynchronizer.h"
 #include "GoBoardUtil.h"
+#include "GoLadder.h"
 #include "GoModBoard.h"
 #include "GoSafetySolver.h"
 #include "SgWrite.h"
@@ -17,31 +22,93 @@ using namespace std;
 
 //----------------------------------------------------------------------------
 
-/** Return true, if point is on edge line and no stone is within a
-    Manhattan distance of 4. */
-bool IsEmptyEdge(const GoBoard& bd, SgPoint p)
+namespace {
+
+/** Reads every step-th ladder starting at the first on one board.
+    Losing ladder defenses are read with a GoLadderReader, whose cache is
+    kept if the reader is owned by the filter. Winning ladder attacks need
+    the first move of the sequence and are read with GoLadder. */
+class LadderWorker
+{
+public:
+    /** @param reader The reader to use or 0, if the worker should use its
+        own reader. */
+    LadderWorker(const GoBoard& bd, GoLadderReader* reader,
+                 vector<GoUctDefaultMoveFilter::LadderRead>& reads,
+                 size_t first, size_t step, int minLadderLength);
+
+    void operator()();
+
+private:
+    const GoBoard* m_bd;
+
+    GoLadderReader* m_reader;
+
+    vector<GoUctDefaultMoveFilter::LadderRead>* m_reads;
+
+    size_t m_first;
+
+    size_t m_step;
+
+    int m_minLadderLength;
+
+    void Read(GoLadderReader& reader);
+};
+
+LadderWorker::LadderWorker(const GoBoard& bd, GoLadderReader* reader,
+                           vector<GoUctDefaultMoveFilter::LadderRead>& reads,
+                           size_t first, size_t step, int minLadderLength)
+    : m_bd(&bd),
+      m_reader(reader),
+      m_reads(&reads),
+      m_first(first),
+      m_step(step),
+      m_minLadderLength(minLadderLength)
+{ }
+
+void LadderWorker::operator()()
 {
-    if (bd.Occupied(p))
-        return false;
-    int size = bd.Size();
-    int col = SgPointUtil::Col(p);
-    int row = SgPointUtil::Row(p);
-    if (! (col == 1 || col == size || row == 1 || row == size))
-        return false;
-    for (int deltaCol = -4; deltaCol <= 4; ++deltaCol)
-        for (int deltaRow = -4; deltaRow <= 4; ++deltaRow)
+    if (m_reader != 0)
+        Read(*m_reader);
+    else
+    {
+        GoLadderReader reader;
+        Read(reader);
+    }
+}
+
+void LadderWorker::Read(GoLadderReader& reader)
+{
+    GoLadder ladder;
+    SgVector<SgPoint> sequence;
+    const SgBlackWhite toPlay = m_bd->ToPlay();
+    for (size_t i = m_first; i < m_reads->size(); i += m_step)
+    {
+        GoUctDefaultMoveFilter::LadderRead& read = (*m_reads)[i];
+        if (read.m_isDefense)
         {
-            if (col + deltaCol < 1 || col + deltaCol > size
-                || row + deltaRow < 1 || row + deltaRow > size
-                || abs(deltaCol) + abs(deltaRow) > 4)
-                continue;
-            if (bd.Occupied(SgPointUtil::Pt(col + deltaCol,
-                                            row + deltaRow)))
-                return false;
+            // The capturing sequence contains the moves read until the
+            // ladder was decided and the capturing move
+            const int result = reader.Ladder(*m_bd, read.m_prey, toPlay);
+            if (result < 0
+                && GoLadderReader::Depth(result) + 1 >= m_minLadderLength)
+                read.m_filtered = m_bd->TheLiberty(read.m_prey);
         }
-    return true;
+        else if (ladder.Ladder(*m_bd, read.m_prey, toPlay, &sequence,
+                               false/*twoLibIsEscape*/) > 0
+                 && sequence.Length() >= m_minLadderLength)
+            read.m_filtered = sequence[0];
+    }
 }
 
+void IncludeStones(const GoBoard& bd, SgPoint block, SgPointSet& stones)
+{
+    for (GoBoard::StoneIterator it(bd, block); it; ++it)
+        stones.Include(*it);
+}
+
+} // namespace
+
 //----------------------------------------------------------------------------
 
 GoUctDefaultMoveFilterParam::GoUctDefaultMoveFilterParam()
@@ -49,7 +116,9 @@ GoUctDefaultMoveFilterParam::GoUctDefaultMoveFilterParam()
        m_checkOffensiveLadders(false),
        m_minLadderLength(6),
        m_filterFirstLine(true),
-       m_checkSafety(true)
+       m_checkSafety(true),
+       m_ladderThreads(1),
+       m_incremental(false)
 {
 }
 
@@ -57,8 +126,9 @@ GoUctDefaultMoveFilterParam::GoUctDefaultMoveFilterParam()
 
 GoUctDefaultMoveFilter::GoUctDefaultMoveFilter(const GoBoard& bd, const GoUctDefaultMoveFilterParam &param)
     : m_bd(bd),
-      m_param(param)
-
+      m_param(param),
+      m_isSafetyValid(false),
+      m_isLadderValid(false)
 {
 }
 
@@ -69,37 +139,23 @@ vector<SgPoint> GoUctDefaultMoveFilter::Get()
     SgBlackWhite opp = SgOppBW(toPlay);
 
     // Safe territory
-    if (m_param.m_checkSafety) {
-        GoModBoard modBoard(m_bd);
-        GoBoard& bd = modBoard.Board();
-        SgBWSet alternateSafe;
-        bool isAllAlternateSafe = false;
-        // Alternate safety is used to prune moves only in opponent territory
-        // and only if everything is alive under alternate play. This ensures that
-        // capturing moves that are not liberties of dead blocks and ko threats
-        // will not be pruned. This alternate safety pruning is not going to
-        // improve or worsen playing strength, but may cause earlier passes,
-        // which is nice in games against humans
-        GoSafetySolver safetySolver(bd);
-        safetySolver.FindSafePoints(&alternateSafe);
-        isAllAlternateSafe = (alternateSafe.Both() == bd.AllPoints());
-
-        // Benson solver guarantees that capturing moves of dead blocks are
-        // liberties of the dead blocks and that no move in Benson safe territory
-        // is a ko threat
-        GoBensonSolver bensonSolver(bd);
-        SgBWSet unconditionalSafe;
-        bensonSolver.FindSafePoints(&unconditionalSafe);
-
-        for (GoBoard::Iterator it(bd); it; ++it)
+    if (m_param.m_checkSafety)
+    {
+        UpdateSafety();
+        bool isAllAlternateSafe =
+            (m_alternateSafe.Both() == m_bd.AllPoints());
+        const SgPointSet legal = m_bd.AllLegal(toPlay);
+        for (GoBoard::Iterator it(m_bd); it; ++it)
         {
             SgPoint p = *it;
-            if (m_bd.IsLegal(p))
+            if (legal.Contains(p))
             {
-                bool isUnconditionalSafe = unconditionalSafe[toPlay].Contains(p);
-                bool isUnconditionalSafeOpp = unconditionalSafe[opp].Contains(p);
-                bool isAlternateSafeOpp = alternateSafe[opp].Contains(p);
-                bool hasOppNeighbors = bd.HasNeighbors(p, opp);
+                bool isUnconditionalSafe =
+                    m_unconditionalSafe[toPlay].Contains(p);
+                bool isUnconditionalSafeOpp =
+                    m_unconditionalSafe[opp].Contains(p);
+                bool isAlternateSafeOpp = m_alternateSafe[opp].Contains(p);
+                bool hasOppNeighbors = m_bd.HasNeighbors(p, opp);
                 // Always generate capturing moves in own safe territory, even
                 // if current rules do no use CaptureDead(), because the UCT
                 // player always scores with Tromp-Taylor after two passes in the
@@ -112,56 +168,184 @@ vector<SgPoint> GoUctDefaultMoveFilter::Get()
         }
     }
 
-    // Loosing ladder defense moves
-    if (m_param.m_checkLadders)
+    // Loosing ladder defense moves and winning offensive ladder moves
+    if (m_param.m_checkLadders || m_param.m_checkOffensiveLadders)
     {
-        for (GoBlockIterator it(m_bd); it; ++it)
-        {
-            SgPoint p = *it;
-            if (m_bd.GetStone(p) == toPlay && m_bd.InAtari(p))
-            {
-                if (m_ladder.Ladder(m_bd, p, toPlay, &m_ladderSequence,
-                                    false/*twoLibIsEscape*/) < 0)
-                {
-                    if (m_ladderSequence.Length() >= m_param.m_minLadderLength)
-                        rootFilter.push_back(m_bd.TheLiberty(p));
-                }
-            }
+        UpdateLadders();
+        rootFilter.insert(rootFilter.end(), m_ladderFilter.begin(),
+                          m_ladderFilter.end());
+    }
 
-        }
+    if (m_param.m_filterFirstLine)
+    {
+        // Moves on edge line, if no stone is within a Manhattan distance
+        // of 4
+        const int size = m_bd.Size();
+        SgPointSet near = m_bd.Occupied();
+        for (int i = 0; i < 4; ++i)
+            near.Grow(size);
+        SgPointSet edge = m_bd.LineSet(1);
+        edge -= near;
+        for (SgSetIterator it(edge); it; ++it)
+            rootFilter.push_back(*it);
     }
 
-    if (m_param.m_checkOffensiveLadders)
+    return rootFilter;
+}
+
+/** Read all ladders of the filter.
+    If more than one thread is used, each thread except the current one reads
+    on its own copy of the board. The copies are created in the current
+    thread, because the construction of GoBoard is not thread-safe. */
+void GoUctDefaultMoveFilter::ReadLadders(vector<LadderRead>& reads)
+{
+    const size_t nuThreads =
+        min(reads.size(), static_cast<size_t>(m_param.m_ladderThreads));
+    if (nuThreads <= 1)
+    {
+        LadderWorker(m_bd, &m_ladderReader, reads, 0, 1,
+                     m_param.m_minLadderLength)();
+        return;
+    }
+    vector<boost::shared_ptr<GoBoard> > boards;
+    for (size_t i = 1; i < nuThreads; ++i)
     {
+        boost::shared_ptr<GoBoard> bd(new GoBoard(m_bd.Size()));
+        bd->Rules() = m_bd.Rules();
+        GoBoardSynchronizer synchronizer(m_bd);
+        synchronizer.SetSubscriber(*bd);
+        synchronizer.UpdateSubscriber();
+        boards.push_back(bd);
+    }
+    boost::thread_group threads;
+    for (size_t i = 1; i < nuThreads; ++i)
+        threads.create_thread(LadderWorker(*boards[i - 1], 0, reads, i,
+                                           nuThreads,
+                                           m_param.m_minLadderLength));
+    LadderWorker(m_bd, &m_ladderReader, reads, 0, nuThreads,
+                 m_param.m_minLadderLength)();
+    threads.join_all();
+}
+
+/** Points whose ladder defense reads are repeated in the incremental mode.
+    See GoUctDefaultMoveFilterParam::Incremental() */
+SgPointSet
+GoUctDefaultMoveFilter::ChangedRegion(const DefenseReads& defense) const
+{
+    const int size = m_bd.Size();
+    SgPointSet changed = m_bd.All(SG_BLACK);
+    changed ^= defense.m_stones[SG_BLACK];
+    SgPointSet changedWhite = m_bd.All(SG_WHITE);
+    changedWhite ^= defense.m_stones[SG_WHITE];
+    changed |= changedWhite;
+    changed.Grow(size);
+    changed.Grow(size);
+    return changed;
+}
+
+/** Recompute the ladder moves of the filter if the position or the ladder
+    parameters changed since the last call. */
+void GoUctDefaultMoveFilter::UpdateLadders()
+{
+    const SgHashCode hash = m_bd.GetHashCodeInclToPlay();
+    if (m_isLadderValid && m_ladderHash == hash
+        && m_ladderKoPoint == m_bd.KoPoint()
+        && m_ladderSize == m_bd.Size()
+        && m_ladderParam.m_checkLadders == m_param.m_checkLadders
+        && m_ladderParam.m_checkOffensiveLadders
+           == m_param.m_checkOffensiveLadders
+        && m_ladderParam.m_minLadderLength == m_param.m_minLadderLength)
+        return;
+    const SgBlackWhite toPlay = m_bd.ToPlay();
+    const SgBlackWhite opp = SgOppBW(toPlay);
+    DefenseReads& defense = m_defenseReads[toPlay];
+    const bool isIncremental =
+        m_param.m_incremental && defense.m_isValid
+        && defense.m_size == m_bd.Size()
+        && m_ladderParam.m_minLadderLength == m_param.m_minLadderLength;
+    SgPointSet changed;
+    if (isIncremental)
+        changed = ChangedRegion(defense);
+    m_ladderFilter.clear();
+    SgPointSet read;
+    SgPointSet filtered;
+    vector<LadderRead> reads;
+    if (m_param.m_checkLadders)
         for (GoBlockIterator it(m_bd); it; ++it)
-        {
-            SgPoint p = *it;
-            if (m_bd.GetStone(p) == opp && m_bd.NumStones(p) >= 5 && m_bd.NumLiberties(p) == 2)
+            if (m_bd.GetStone(*it) == toPlay && m_bd.InAtari(*it))
             {
-                if (m_ladder.Ladder(m_bd, p, toPlay, &m_ladderSequence,
-                                    false/*twoLibIsEscape*/) > 0)
+                const SgPoint liberty = m_bd.TheLiberty(*it);
+                bool isChanged = (! isIncremental
+                                  || ! defense.m_read.Contains(*it)
+                                  || changed.Contains(liberty));
+                for (GoBoard::StoneIterator stn(m_bd, *it); stn; ++stn)
+                {
+                    read.Include(*stn);
+                    if (changed.Contains(*stn))
+                        isChanged = true;
+                }
+                if (isChanged)
+                    reads.push_back(LadderRead(*it, true));
+                else if (defense.m_filtered.Contains(*it))
                 {
-                    if (m_ladderSequence.Length() >= m_param.m_minLadderLength) 
-                        rootFilter.push_back(m_ladderSequence[0]);
+                    m_ladderFilter.push_back(liberty);
+                    IncludeStones(m_bd, *it, filtered);
                 }
             }
-        }
-    }
-
-
-
-    if (m_param.m_filterFirstLine)
-    {
-        // Moves on edge line, if no stone is near
-        for (GoBoard::Iterator it(m_bd); it; ++it)
+    if (m_param.m_checkOffensiveLadders)
+        for (GoBlockIterator it(m_bd); it; ++it)
+            if (m_bd.GetStone(*it) == opp && m_bd.NumStones(*it) >= 5
+                && m_bd.NumLiberties(*it) == 2)
+                reads.push_back(LadderRead(*it, false));
+    ReadLadders(reads);
+    for (vector<LadderRead>::const_iterator it = reads.begin();
+         it != reads.end(); ++it)
+        if (it->m_filtered != SG_NULLPOINT)
         {
-            SgPoint p = *it;
-            if (IsEmptyEdge(m_bd, p))
-                rootFilter.push_back(p);
+            m_ladderFilter.push_back(it->m_filtered);
+            if (it->m_isDefense)
+                IncludeStones(m_bd, it->m_prey, filtered);
         }
-    }
+    defense.m_isValid = true;
+    defense.m_size = m_bd.Size();
+    defense.m_stones[SG_BLACK] = m_bd.All(SG_BLACK);
+    defense.m_stones[SG_WHITE] = m_bd.All(SG_WHITE);
+    defense.m_read = read;
+    defense.m_filtered = filtered;
+    m_isLadderValid = true;
+    m_ladderHash = hash;
+    m_ladderKoPoint = m_bd.KoPoint();
+    m_ladderSize = m_bd.Size();
+    m_ladderParam = m_param;
+}
 
-    return rootFilter;
+/** Recompute the safe points if the stones changed since the last call.
+    Alternate safety is used to prune moves only in opponent territory and
+    only if everything is alive under alternate play. This ensures that
+    capturing moves that are not liberties of dead blocks and ko threats will
+    not be pruned. This alternate safety pruning is not going to improve or
+    worsen playing strength, but may cause earlier passes, which is nice in
+    games against humans.
+    Benson solver guarantees that capturing moves of dead blocks are
+    liberties of the dead blocks and that no move in Benson safe territory is
+    a ko threat. */
+void GoUctDefaultMoveFilter::UpdateSafety()
+{
+    const SgHashCode& hash = m_bd.GetHashCode();
+    if (m_isSafetyValid && m_safetyHash == hash
+        && m_safetySize == m_bd.Size())
+        return;
+    GoModBoard modBoard(m_bd);
+    GoBoard& bd = modBoard.Board();
+    m_alternateSafe.Clear();
+    GoSafetySolver safetySolver(bd);
+    safetySolver.FindSafePoints(&m_alternateSafe);
+    m_unconditionalSafe.Clear();
+    GoBensonSolver bensonSolver(bd);
+    bensonSolver.FindSafePoints(&m_unconditionalSafe);
+    m_isSafetyValid = true;
+    m_safetyHash = hash;
+    m_safetySize = m_bd.Size();
 }
 
 //----------------------------------------------------------------------------
@@ -7,6 +7,9 @@
 
 #include "GoLadder.h"
 #include "GoUctMoveFilter.h"
+#include "SgBWArray.h"
+#include "SgBWSet.h"
+#include "SgHash.h"
 
 class GoBoard;
 
@@ -50,6 +53,27 @@ class GoUctDefaultMoveFilterParam
     /** See CheckSafety() */
     void SetCheckSafety(bool enable);
 
+    /** Number of threads for reading the ladders.
+        Each thread reads on its own copy of the board. Should be 1 for
+        filters that are used by the search threads. */
+    int LadderThreads() const;
+
+    /** See LadderThreads() */
+    void SetLadderThreads(int number);
+
+    /** Repeat the ladder defense reads only for blocks near the stones that
+        changed since the last position with the same color to play.
+        Blocks, whose stones and liberty are further than 2 points away from
+        all changed stones, keep their last result, so a change of a distant
+        ladder breaker is not noticed. Intended for the tree filter, whose
+        positions differ only by a few moves from each other. The results
+        depend on the history of the filter, so GoUctGlobalSearchState does
+        not store them in the GoUctMoveFilterCache. Default is false. */
+    bool Incremental() const;
+
+    /** See Incremental() */
+    void SetIncremental(bool enable);
+
  public:
 
     /** See CheckLadders() */
@@ -66,6 +90,12 @@ class GoUctDefaultMoveFilterParam
 
     /** See CheckSafety() */
     bool m_checkSafety;
+
+    /** See LadderThreads() */
+    int m_ladderThreads;
+
+    /** See Incremental() */
+    bool m_incremental;
 };
 
 inline bool GoUctDefaultMoveFilterParam::CheckLadders() const
@@ -108,6 +138,27 @@ inline void GoUctDefaultMoveFilterParam::SetCheckSafety(bool flag)
     m_checkSafety = flag;
 }
 
+inline bool GoUctDefaultMoveFilterParam::Incremental() const
+{
+    return m_incremental;
+}
+
+inline void GoUctDefaultMoveFilterParam::SetIncremental(bool enable)
+{
+    m_incremental = enable;
+}
+
+inline int GoUctDefaultMoveFilterParam::LadderThreads() const
+{
+    return m_ladderThreads;
+}
+
+inline void GoUctDefaultMoveFilterParam::SetLadderThreads(int number)
+{
+    SG_ASSERT(number >= 1);
+    m_ladderThreads = number;
+}
+
 inline int GoUctDefaultMoveFilterParam::MinLadderLength() const
 {
     return m_minLadderLength;
@@ -120,11 +171,31 @@ inline void GoUctDefaultMoveFilterParam::SetMinLadderLength(int length)
 
 //----------------------------------------------------------------------------
 
-/** Default root filter used by GoUctPlayer. */
+/** Default root filter used by GoUctPlayer.
+    The results of the safety solvers and of the ladder reads are cached, so
+    repeated calls in the same position (e.g. a search after pondering) do
+    not repeat the static analysis. The safety results are keyed by the hash
+    code of the stones, the ladder results by the hash code including the
+    color to play and the ko point. */
 class GoUctDefaultMoveFilter
     : public GoUctMoveFilter
 {
 public:
+    /** A ladder read of the filter. */
+    struct LadderRead
+    {
+        /** A block in the ladder */
+        SgPoint m_prey;
+
+        /** Is the prey a block of the color to play? */
+        bool m_isDefense;
+
+        /** Move to filter or SG_NULLPOINT. */
+        SgPoint m_filtered;
+
+        LadderRead(SgPoint prey, bool isDefense);
+    };
+
     GoUctDefaultMoveFilter(const GoBoard& bd, const GoUctDefaultMoveFilterParam &param);
 
     /** @name Pure virtual functions of GoUctMoveFilter */
@@ -142,13 +213,86 @@ private:
 
     const GoUctDefaultMoveFilterParam &m_param;
 
-    GoLadder m_ladder;
+    /** Are m_alternateSafe and m_unconditionalSafe valid for
+        m_safetyHash? */
+    bool m_isSafetyValid;
+
+    /** Board size of the cached safety results. */
+    int m_safetySize;
 
-    /** Local variable in Get().
-        Reused for efficiency. */
-    mutable SgVector<SgPoint> m_ladderSequence;
+    SgHashCode m_safetyHash;
+
+    /** Safe points found by GoSafetySolver. */
+    SgBWSet m_alternateSafe;
+
+    /** Safe points found by GoBensonSolver. */
+    SgBWSet m_unconditionalSafe;
+
+    /** Is m_ladderFilter valid for m_ladderHash, m_ladderKoPoint and
+        m_ladderParam? */
+    bool m_isLadderValid;
+
+    /** Board size of the cached ladder results. */
+    int m_ladderSize;
+
+    SgHashCode m_ladderHash;
+
+    /** Ko point of the position of the cached ladder results.
+        The ladder reads depend on the ko point, like in GoLadderReader. */
+    SgPoint m_ladderKoPoint;
+
+    /** Parameters used for the cached ladder results. */
+    GoUctDefaultMoveFilterParam m_ladderParam;
+
+    /** Cached moves filtered by ladder reads. */
+    std::vector<SgPoint> m_ladderFilter;
+
+    /** Reads the ladder defenses in the current thread.
+        Keeps its results between calls, so the tree filter does not read
+        the ladders again in transpositions of the search tree. */
+    GoLadderReader m_ladderReader;
+
+    /** Ladder defense reads of the last position with a color to play.
+        See GoUctDefaultMoveFilterParam::Incremental() */
+    struct DefenseReads
+    {
+        bool m_isValid;
+
+        int m_size;
+
+        SgBWSet m_stones;
+
+        /** Stones of the blocks whose ladder defense was read. */
+        SgPointSet m_read;
+
+        /** Stones of the blocks whose liberty was filtered. */
+        SgPointSet m_filtered;
+
+        DefenseReads();
+    };
+
+    SgBWArray<DefenseReads> m_defenseReads;
+
+    SgPointSet ChangedRegion(const DefenseReads& defense) const;
+
+    void ReadLadders(std::vector<LadderRead>& reads);
+
+    void UpdateLadders();
+
+    void UpdateSafety();
 };
 
+inline GoUctDefaultMoveFilter::LadderRead::LadderRead(SgPoint prey,
+                                                      bool isDefense)
+    : m_prey(prey),
+      m_isDefense(isDefense),
+      m_filtered(SG_NULLPOINT)
+{ }
+
+inline GoUctDefaultMoveFilter::DefenseReads::DefenseReads()
+    : m_isValid(false)
+{ }
+
 //----------------------------------------------------------------------------
 
 #endif // GOUCT_DEFAULTROOTFILTER_H
@@ -124,10 +124,19 @@ void GoUctKnowledge::TransferValues(std::vector<SgUctMoveInfo>& outmoves) const
 
 //----------------------------------------------------------------------------
 
+GoUctDefaultPriorKnowledgeParam::GoUctDefaultPriorKnowledgeParam()
+    : m_ladderAttacks(false)
+{ }
+
+//----------------------------------------------------------------------------
+
 GoUctDefaultPriorKnowledge::GoUctDefaultPriorKnowledge(const GoBoard& bd,
-                              const GoUctPlayoutPolicyParam& param)
+                              const GoUctPlayoutPolicyParam& policyParam,
+                              const GoUctDefaultPriorKnowledgeParam& param)
     : GoUctKnowledge(bd),
-      m_policy(bd, param)
+      m_param(param),
+      m_policy(bd, policyParam),
+      m_featuresValid(false)
 { }
 
 void GoUctDefaultPriorKnowledge::AddLocalityBonus(GoPointList& emptyPoints,
@@ -170,27 +179,85 @@ void GoUctDefaultPriorKnowledge::AddLocalityBonus(GoPointList& emptyPoints,
 bool GoUctDefaultPriorKnowledge::FindGlobalPatternAndAtariMoves(
                                                      SgPointSet& pattern,
                                                      SgPointSet& atari,
-                                                     GoPointList& empty) const
+                                                     GoPointList& empty)
 {
     SG_ASSERT(empty.IsEmpty());
-    const GoUctPatterns<GoBoard>& patterns = m_policy.Patterns();
-    bool result = false;
+    UpdateFeatures();
     for (GoBoard::Iterator it(m_bd); it; ++it)
         if (m_bd.IsEmpty(*it))
-        {
             empty.PushBack(*it);
-            if (patterns.MatchAny(*it))
-            {
-                pattern.Include(*it);
-                result = true;
-            }
-            if (SetsAtari(m_bd, *it))
-            {
-                atari.Include(*it);
-                result = true;
-            }
-        }
-    return result;
+    pattern |= m_pattern;
+    atari |= m_atari;
+    return m_pattern.NonEmpty() || m_atari.NonEmpty();
+}
+
+/** Points whose features can differ from the cached ones.
+    The features of an empty point depend on the colors of the points within
+    distance 2 (patterns use the 8-neighborhood, InSmallEyeSpace() the
+    neighbors of the neighbors) and on the liberties and sizes of the
+    adjacent blocks. A block can only have changed if one of its stones is
+    on or next to a changed point. */
+SgPointSet GoUctDefaultPriorKnowledge::FeatureRegion() const
+{
+    SG_ASSERT(m_featuresValid);
+    const int size = m_bd.Size();
+    SgPointSet changed = m_bd.All(SG_BLACK);
+    changed ^= m_featureStones[SG_BLACK];
+    SgPointSet changedWhite = m_bd.All(SG_WHITE);
+    changedWhite ^= m_featureStones[SG_WHITE];
+    changed |= changedWhite;
+    if (changed.IsEmpty())
+        return changed;
+    SgPointSet region = changed;
+    region.Grow(size);
+    SgPointSet blocks;
+    for (SgSetIterator it(region & m_bd.Occupied()); it; ++it)
+        if (! blocks.Contains(*it))
+            for (GoBoard::StoneIterator stn(m_bd, *it); stn; ++stn)
+                blocks.Include(*stn);
+    region.Grow(size);
+    blocks.Grow(size);
+    region |= blocks;
+    return region;
+}
+
+/** Bring the cached features up to date with the current position. */
+void GoUctDefaultPriorKnowledge::UpdateFeatures()
+{
+    SgPointSet region;
+    if (m_featuresValid && m_featureSize == m_bd.Size()
+        && m_featureToPlay == m_bd.ToPlay())
+    {
+        region = FeatureRegion();
+        if (region.IsEmpty())
+            return;
+        m_pattern -= region;
+        m_atari -= region;
+        m_badSelfAtari -= region;
+    }
+    else
+    {
+        region = m_bd.AllPoints();
+        m_pattern.Clear();
+        m_atari.Clear();
+        m_badSelfAtari.Clear();
+    }
+    const GoUctPatterns<GoBoard>& patterns = m_policy.Patterns();
+    for (SgSetIterator it(region & m_bd.AllEmpty()); it; ++it)
+    {
+        const SgPoint p = *it;
+        if (patterns.MatchAny(p))
+            m_pattern.Include(p);
+        if (SetsAtari(m_bd, p))
+            m_atari.Include(p);
+        if (BadSelfAtari(m_bd, p))
+            m_badSelfAtari.Include(p);
+    }
+    m_featuresValid = true;
+    m_featureSize = m_bd.Size();
+    m_featureToPlay = m_bd.ToPlay();
+    m_featureStones[SG_BLACK] = m_bd.All(SG_BLACK);
+    m_featureStones[SG_WHITE] = m_bd.All(SG_WHITE);
 }
 
 void 
@@ -204,7 +271,7 @@ GoUctDefaultPriorKnowledge::InitializeForGlobalHeuristic(
     {
         const SgPoint p = *it;
         SG_ASSERT (m_bd.IsEmpty(p));
-        if (BadSelfAtari(m_bd, p))
+        if (m_badSelfAtari.Contains(p))
             Initialize(p, 0.1f, nuSimulations);
         else if (atari[p])
             Initialize(p, 1.0f, 3);
@@ -215,6 +282,28 @@ GoUctDefaultPriorKnowledge::InitializeForGlobalHeuristic(
     }
 }
 
+/** Initialize the moves that capture an opponent block with two liberties
+    in a ladder.
+    The liberties are collected before reading, because the ladder reader
+    plays moves on the board. */
+void GoUctDefaultPriorKnowledge::InitializeForLadderAttacks(int nuSimulations)
+{
+    const SgBlackWhite opp = m_bd.Opponent();
+    GoPointList prey;
+    GoPointList moves;
+    for (GoBlockIterator it(m_bd); it; ++it)
+        if (m_bd.GetStone(*it) == opp && m_bd.NumLiberties(*it) == 2)
+            for (GoBoard::LibertyIterator lib(m_bd, *it); lib; ++lib)
+                if (! m_badSelfAtari.Contains(*lib))
+                {
+                    prey.PushBack(*it);
+                    moves.PushBack(*lib);
+                }
+    for (int i = 0; i < moves.Length(); ++i)
+        if (m_ladder.IsLadderCaptureMove(m_bd, prey[i], moves[i]))
+            Initialize(moves[i], 1.0f, nuSimulations);
+}
+
 void 
 GoUctDefaultPriorKnowledge::InitializeForNonRandomPolicyMove(
 	const GoPointList& empty,
@@ -226,7 +315,7 @@ GoUctDefaultPriorKnowledge::InitializeForNonRandomPolicyMove(
     {
         const SgPoint p = *it;
         SG_ASSERT (m_bd.IsEmpty(p));
-        if (BadSelfAtari(m_bd, p))
+        if (m_badSelfAtari.Contains(p))
             Initialize(p, 0.1f, nuSimulations);
         else if (atari[p])
             Initialize(p, 0.8f, nuSimulations);
@@ -250,7 +339,7 @@ GoUctDefaultPriorKnowledge::InitializeForRandomPolicyMove(
     {
         const SgPoint p = *it;
         SG_ASSERT (m_bd.IsEmpty(p));
-        if (BadSelfAtari(m_bd, p))
+        if (m_badSelfAtari.Contains(p))
             Initialize(*it, 0.1f, nuSimulations);
         else
             m_values[p].Clear(); // Don't initialize
@@ -286,8 +375,17 @@ GoUctDefaultPriorKnowledge::ProcessPosition(std::vector<SgUctMoveInfo>& outmoves
     else
     	InitializeForNonRandomPolicyMove(empty, pattern, atari, defaultNuSimulations);
 
-    AddLocalityBonus(empty, isSmallBoard);
-    m_policy.EndPlayout();
+    if (m_param.m_ladderAttacks)
+    {
+        m_policy.EndPlayout();
+        InitializeForLadderAttacks(defaultNuSimulations);
+        AddLocalityBonus(empty, isSmallBoard);
+    }
+    else
+    {
+        AddLocalityBonus(empty, isSmallBoard);
+        m_policy.EndPlayout();
+    }
 
     TransferValues(outmoves);
 }
@@ -5,7 +5,9 @@
 #ifndef GOUCT_DEFAULTPRIORKNOWLEDGE_H
 #define GOUCT_DEFAULTPRIORKNOWLEDGE_H
 
+#include "GoLadder.h"
 #include "GoUctPlayoutPolicy.h"
+#include "SgBWSet.h"
 #include "SgUctSearch.h"
 
 //----------------------------------------------------------------------------
@@ -36,24 +38,80 @@ protected:
 
 //----------------------------------------------------------------------------
 
+/** Parameters for GoUctDefaultPriorKnowledge; shared by all threads. */
+class GoUctDefaultPriorKnowledgeParam
+{
+public:
+    /** Initialize moves that capture an opponent block in a ladder with the
+        highest prior value.
+        The ladders are read with a GoLadderReader on the board of the search
+        thread in every expanded node. Default is false. */
+    bool m_ladderAttacks;
+
+    GoUctDefaultPriorKnowledgeParam();
+};
+
+//----------------------------------------------------------------------------
+
 /** Default prior knowledge heuristic.
-    Mainly uses GoUctPlayoutPolicy to generate prior knowledge. */
+    Mainly uses GoUctPlayoutPolicy to generate prior knowledge.
+    The per-point features (pattern match, atari move, bad self-atari) of the
+    last processed position are cached. Nodes are usually expanded close to
+    the previously expanded node, so only the points near the stones that
+    differ from the cached position are recomputed; see UpdateFeatures().
+    Optionally, moves that capture an opponent block in a ladder get the
+    highest prior value; see GoUctDefaultPriorKnowledgeParam::m_ladderAttacks.
+*/
 class GoUctDefaultPriorKnowledge 
 : public GoUctKnowledge
 {
 public:
     GoUctDefaultPriorKnowledge(const GoBoard& bd,
-                               const GoUctPlayoutPolicyParam& param);
+                               const GoUctPlayoutPolicyParam& policyParam,
+                               const GoUctDefaultPriorKnowledgeParam& param);
 
     void ProcessPosition(std::vector<SgUctMoveInfo>& moves);
 
     bool FindGlobalPatternAndAtariMoves(SgPointSet& pattern,
                                         SgPointSet& atari,
-                                        GoPointList& empty) const;
+                                        GoPointList& empty);
+
+    /** Moves that are a bad self-atari for the color to play.
+        Valid after a call to FindGlobalPatternAndAtariMoves(). */
+    const SgPointSet& BadSelfAtariMoves() const;
+
 private:
+    const GoUctDefaultPriorKnowledgeParam& m_param;
 
     GoUctPlayoutPolicy<GoBoard> m_policy;
 
+    /** Are the cached features valid for m_featureStones? */
+    bool m_featuresValid;
+
+    /** Board size of the cached features. */
+    int m_featureSize;
+
+    /** Color to play in the position of the cached features. */
+    SgBlackWhite m_featureToPlay;
+
+    /** Stones of the position of the cached features. */
+    SgBWSet m_featureStones;
+
+    /** Cached empty points that match a playout pattern. */
+    SgPointSet m_pattern;
+
+    /** Cached empty points that set an opponent block into atari. */
+    SgPointSet m_atari;
+
+    /** Cached empty points that are a bad self-atari. */
+    SgPointSet m_badSelfAtari;
+
+    GoLadderReader m_ladder;
+
+    SgPointSet FeatureRegion() const;
+
+    void UpdateFeatures();
+
     void AddLocalityBonus(GoPointList& emptyPoints, bool isSmallBoard);
 
     void InitializeForRandomPolicyMove(const GoPointList& empty,
@@ -64,6 +122,8 @@ private:
                                       const SgPointSet& atari,
                                       int nuSimulations);
 
+    void InitializeForLadderAttacks(int nuSimulations);
+
 	void InitializeForNonRandomPolicyMove(const GoPointList& empty,
                                           const SgPointSet& pattern,
                                           const SgPointSet& atari,
@@ -71,6 +131,11 @@ private:
 
 };
 
+inline const SgPointSet& GoUctDefaultPriorKnowledge::BadSelfAtariMoves() const
+{
+    return m_badSelfAtari;
+}
+
 //----------------------------------------------------------------------------
 
 #endif // GOUCT_DEFAULTPRIORKNOWLEDGE_H
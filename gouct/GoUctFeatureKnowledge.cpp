@@ -0,0 +1,350 @@
+//----------------------------------------------------------------------------
+/** @file GoUctFeatureKnowledge.cpp
+    See GoUctFeatureKnowledge.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctFeatureKnowledge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "GoBoardUtil.h"
+#include "SgException.h"
+
+using namespace std;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Points of the local pattern as column and row offsets.
+    The first four are the neighbors. */
+const int PATTERN_OFFSET[12][2] = {
+    {  1,  0 }, {  0,  1 }, { -1,  0 }, {  0, -1 },
+    {  1,  1 }, { -1,  1 }, { -1, -1 }, {  1, -1 },
+    {  2,  0 }, {  0,  2 }, { -2,  0 }, {  0, -2 }
+};
+
+const int NU_PATTERN_POINTS = 12;
+
+const int NU_NEIGHBORS = 4;
+
+const int NU_SYMMETRIES = 8;
+
+const char WEIGHTS_MAGIC[4] = { 'F', 'G', 'F', 'W' };
+
+const uint32_t WEIGHTS_VERSION = 1;
+
+/** Code of a neighbor point (3 bits): empty, border or color and liberty
+    class (1, 2, 3 or more) of the block. */
+uint32_t NeighborCode(const GoBoard& bd, SgPoint p, SgBlackWhite toPlay)
+{
+    if (bd.IsEmpty(p))
+        return 0;
+    const int nuLib = min(bd.NumLiberties(p), 3);
+    return (bd.GetColor(p) == toPlay ? 1 : 4) + nuLib;
+}
+
+/** Code of a point in the outer ring of the pattern (2 bits). */
+uint32_t ColorCode(const GoBoard& bd, SgPoint p, SgBlackWhite toPlay)
+{
+    if (bd.IsEmpty(p))
+        return 0;
+    return bd.GetColor(p) == toPlay ? 2 : 3;
+}
+
+void WriteUInt32(ostream& out, uint32_t value)
+{
+    char buffer[4];
+    for (int i = 0; i < 4; ++i)
+        buffer[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    out.write(buffer, 4);
+}
+
+void WriteFloat(ostream& out, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteUInt32(out, bits);
+}
+
+uint32_t ReadUInt32(istream& in)
+{
+    unsigned char buffer[4];
+    if (! in.read(reinterpret_cast<char*>(buffer), 4))
+        throw SgException("GoUctFeatureWeights: unexpected end of file");
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i)
+        value = (value << 8) | buffer[i];
+    return value;
+}
+
+float ReadFloat(istream& in)
+{
+    const uint32_t bits = ReadUInt32(in);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoUctMoveFeatures GoUctFeatureUtil::FindFeatures(const GoBoard& bd,
+                                                 SgPoint p)
+{
+    GoUctMoveFeatures features;
+    if (p == SG_PASS)
+    {
+        features.m_tactical = (1u << GOUCT_FEATURE_PASS);
+        return features;
+    }
+    SG_ASSERT(bd.IsEmpty(p));
+    const SgBlackWhite toPlay = bd.ToPlay();
+    const SgBlackWhite opp = SgOppBW(toPlay);
+    unsigned int& tactical = features.m_tactical;
+    const bool selfAtari = GoBoardUtil::SelfAtari(bd, p);
+    if (selfAtari)
+        tactical |= (1u << GOUCT_FEATURE_SELF_ATARI);
+    for (SgNb4Iterator it(p); it; ++it)
+    {
+        const SgPoint nb = *it;
+        if (bd.IsColor(nb, opp))
+        {
+            const int nuLib = bd.NumLiberties(nb);
+            if (nuLib == 1)
+                tactical |= (1u << GOUCT_FEATURE_CAPTURE);
+            else if (nuLib == 2)
+                tactical |= (1u << GOUCT_FEATURE_ATARI);
+        }
+        else if (bd.IsColor(nb, toPlay) && ! selfAtari && bd.InAtari(nb))
+            tactical |= (1u << GOUCT_FEATURE_EXTENSION);
+    }
+    const int line = bd.Line(p);
+    if (line <= 4)
+        tactical |= (1u << (GOUCT_FEATURE_LINE_1 + line - 1));
+    const SgPoint last = bd.GetLastMove();
+    if (last != SG_NULLMOVE && last != SG_PASS)
+    {
+        const int dx = abs(SgPointUtil::Col(p) - SgPointUtil::Col(last));
+        const int dy = abs(SgPointUtil::Row(p) - SgPointUtil::Row(last));
+        const int distance = dx + dy + max(dx, dy);
+        if (distance <= 4)
+            tactical |= (1u << (GOUCT_FEATURE_DIST_LAST_2 + distance - 2));
+        else if (distance <= 8)
+            tactical |= (1u << GOUCT_FEATURE_DIST_LAST_5);
+    }
+    features.m_hasPattern = true;
+    features.m_pattern = PatternCode(bd, p);
+    return features;
+}
+
+uint32_t GoUctFeatureUtil::PatternCode(const GoBoard& bd, SgPoint p)
+{
+    SG_ASSERT(bd.IsEmpty(p));
+    const SgBlackWhite toPlay = bd.ToPlay();
+    const int size = bd.Size();
+    const int col = SgPointUtil::Col(p);
+    const int row = SgPointUtil::Row(p);
+    uint32_t minCode = 0xffffffffu;
+    for (int s = 0; s < NU_SYMMETRIES; ++s)
+    {
+        uint32_t code = 0;
+        for (int i = 0; i < NU_PATTERN_POINTS; ++i)
+        {
+            int dx = PATTERN_OFFSET[i][0];
+            int dy = PATTERN_OFFSET[i][1];
+            if (s & 4)
+                swap(dx, dy);
+            if (s & 1)
+                dx = -dx;
+            if (s & 2)
+                dy = -dy;
+            const int c = col + dx;
+            const int r = row + dy;
+            const bool isBorder = (c < 1 || c > size || r < 1 || r > size);
+            if (i < NU_NEIGHBORS)
+                code = (code << 3)
+                     | (isBorder ? 1 : NeighborCode(bd, Pt(c, r), toPlay));
+            else
+                code = (code << 2)
+                     | (isBorder ? 1 : ColorCode(bd, Pt(c, r), toPlay));
+        }
+        minCode = min(minCode, code);
+    }
+    return minCode;
+}
+
+//----------------------------------------------------------------------------
+
+GoUctFeatureWeights::GoUctFeatureWeights()
+{
+    Clear();
+}
+
+void GoUctFeatureWeights::Clear()
+{
+    for (int i = 0; i < _GOUCT_NU_FEATURES; ++i)
+        m_weights[i] = 0;
+    m_nuPatterns = 0;
+    Entry empty;
+    empty.m_code = EMPTY_CODE;
+    empty.m_weight = 0;
+    m_table.assign(1024, empty);
+}
+
+float& GoUctFeatureWeights::AddPattern(uint32_t code)
+{
+    SG_ASSERT(code != EMPTY_CODE);
+    if (2 * (m_nuPatterns + 1) > static_cast<int>(m_table.size()))
+        Resize(2 * m_table.size());
+    size_t i = Index(code);
+    if (m_table[i].m_code == EMPTY_CODE)
+    {
+        m_table[i].m_code = code;
+        m_table[i].m_weight = 0;
+        ++m_nuPatterns;
+    }
+    return m_table[i].m_weight;
+}
+
+float GoUctFeatureWeights::Evaluate(const GoUctMoveFeatures& features) const
+{
+    float logGamma = 0;
+    for (int i = 0; i < _GOUCT_NU_FEATURES; ++i)
+        if (features.Has(static_cast<GoUctFeature>(i)))
+            logGamma += m_weights[i];
+    if (features.m_hasPattern)
+        logGamma += PatternWeight(features.m_pattern);
+    return logGamma;
+}
+
+float* GoUctFeatureWeights::FindPattern(uint32_t code)
+{
+    Entry& entry = m_table[Index(code)];
+    return entry.m_code == code ? &entry.m_weight : 0;
+}
+
+/** Slot of a pattern or the empty slot where it would be inserted. */
+size_t GoUctFeatureWeights::Index(uint32_t code) const
+{
+    const size_t mask = m_table.size() - 1;
+    uint32_t hash = code * 2654435761u;
+    hash ^= (hash >> 16);
+    size_t i = hash & mask;
+    while (m_table[i].m_code != code && m_table[i].m_code != EMPTY_CODE)
+        i = (i + 1) & mask;
+    return i;
+}
+
+float GoUctFeatureWeights::PatternWeight(uint32_t code) const
+{
+    const Entry& entry = m_table[Index(code)];
+    if (entry.m_code == code)
+        return entry.m_weight;
+    return m_weights[GOUCT_FEATURE_UNKNOWN_PATTERN];
+}
+
+void GoUctFeatureWeights::Read(istream& in)
+{
+    char magic[4];
+    if (! in.read(magic, 4) || ! equal(magic, magic + 4, WEIGHTS_MAGIC))
+        throw SgException("GoUctFeatureWeights: not a weights file");
+    if (ReadUInt32(in) != WEIGHTS_VERSION)
+        throw SgException("GoUctFeatureWeights: unknown version");
+    if (ReadUInt32(in) != static_cast<uint32_t>(_GOUCT_NU_FEATURES))
+        throw SgException("GoUctFeatureWeights: wrong number of features");
+    GoUctFeatureWeights weights;
+    for (int i = 0; i < _GOUCT_NU_FEATURES; ++i)
+        weights.m_weights[i] = ReadFloat(in);
+    const uint32_t nuPatterns = ReadUInt32(in);
+    for (uint32_t i = 0; i < nuPatterns; ++i)
+    {
+        const uint32_t code = ReadUInt32(in);
+        if (code == EMPTY_CODE)
+            throw SgException("GoUctFeatureWeights: invalid pattern code");
+        weights.AddPattern(code) = ReadFloat(in);
+    }
+    *this = weights;
+}
+
+void GoUctFeatureWeights::Resize(size_t size)
+{
+    SG_ASSERT((size & (size - 1)) == 0);
+    vector<Entry> old;
+    old.swap(m_table);
+    Entry empty;
+    empty.m_code = EMPTY_CODE;
+    empty.m_weight = 0;
+    m_table.assign(size, empty);
+    for (vector<Entry>::const_iterator it = old.begin(); it != old.end();
+         ++it)
+        if (it->m_code != EMPTY_CODE)
+            m_table[Index(it->m_code)] = *it;
+}
+
+void GoUctFeatureWeights::Write(ostream& out) const
+{
+    out.write(WEIGHTS_MAGIC, 4);
+    WriteUInt32(out, WEIGHTS_VERSION);
+    WriteUInt32(out, _GOUCT_NU_FEATURES);
+    for (int i = 0; i < _GOUCT_NU_FEATURES; ++i)
+        WriteFloat(out, m_weights[i]);
+    WriteUInt32(out, m_nuPatterns);
+    for (vector<Entry>::const_iterator it = m_table.begin();
+         it != m_table.end(); ++it)
+        if (it->m_code != EMPTY_CODE)
+        {
+            WriteUInt32(out, it->m_code);
+            WriteFloat(out, it->m_weight);
+        }
+}
+
+//----------------------------------------------------------------------------
+
+GoUctFeatureKnowledgeParam::GoUctFeatureKnowledgeParam()
+{ }
+
+//----------------------------------------------------------------------------
+
+GoUctFeatureKnowledge::GoUctFeatureKnowledge(const GoBoard& bd,
+                                  const GoUctFeatureKnowledgeParam& param)
+    : GoUctAdditiveKnowledge(bd),
+      m_param(param)
+{
+    // Knowledge applies to all moves
+    SetMoveRange(0, 10000);
+}
+
+void GoUctFeatureKnowledge::ProcessPosition(std::vector<SgUctMoveInfo>& moves)
+{
+    if (moves.empty())
+        return;
+    const GoBoard& bd = Board();
+    const GoUctFeatureWeights& weights = m_param.m_weights;
+    m_logGamma.resize(moves.size());
+    float maxLogGamma = 0;
+    for (size_t i = 0; i < moves.size(); ++i)
+    {
+        const GoUctMoveFeatures features =
+            GoUctFeatureUtil::FindFeatures(bd, moves[i].m_move);
+        m_logGamma[i] = weights.Evaluate(features);
+        if (i == 0 || m_logGamma[i] > maxLogGamma)
+            maxLogGamma = m_logGamma[i];
+    }
+    float sum = 0;
+    for (size_t i = 0; i < moves.size(); ++i)
+    {
+        // Relative to the strongest move to avoid overflow of exp()
+        moves[i].m_gamma = exp(m_logGamma[i] - maxLogGamma);
+        sum += moves[i].m_gamma;
+    }
+    for (size_t i = 0; i < moves.size(); ++i)
+        moves[i].m_prior = moves[i].m_gamma / sum;
+}
+
+//----------------------------------------------------------------------------
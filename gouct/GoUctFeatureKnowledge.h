@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------------
+/** @file GoUctFeatureKnowledge.h
+    Additive knowledge from move features with trained weights.
+    Each legal move is described by a set of tactical features and a local
+    pattern. The strength (gamma) of a move is the exponential of the sum of
+    the weights of its features, and the prior of a move is its strength
+    divided by the sum of the strengths of all moves (generalized
+    Bradley-Terry model, see Remi Coulom: Computing Elo Ratings of Move
+    Patterns in the Game of Go, ICGA Journal 30(4), 2007).
+    The weights are learned offline with GoUctFeatureTrainer. */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_FEATUREKNOWLEDGE_H
+#define GOUCT_FEATUREKNOWLEDGE_H
+
+#include <iosfwd>
+#include <stdint.h>
+#include <vector>
+#include "GoUctAdditiveKnowledge.h"
+#include "SgArray.h"
+
+//----------------------------------------------------------------------------
+
+/** Tactical features of a move. */
+enum GoUctFeature
+{
+    GOUCT_FEATURE_PASS,
+
+    /** Captures an adjacent opponent block. */
+    GOUCT_FEATURE_CAPTURE,
+
+    /** Extends an own block in atari without being a self-atari. */
+    GOUCT_FEATURE_EXTENSION,
+
+    /** Puts an adjacent opponent block into atari. */
+    GOUCT_FEATURE_ATARI,
+
+    GOUCT_FEATURE_SELF_ATARI,
+
+    /** First line (distance to the edge of the board). */
+    GOUCT_FEATURE_LINE_1,
+
+    GOUCT_FEATURE_LINE_2,
+
+    GOUCT_FEATURE_LINE_3,
+
+    GOUCT_FEATURE_LINE_4,
+
+    /** Distance 2 to the last move.
+        The distance is dx + dy + max(dx, dy), so 2 is a neighbor and 3 a
+        diagonal neighbor. */
+    GOUCT_FEATURE_DIST_LAST_2,
+
+    GOUCT_FEATURE_DIST_LAST_3,
+
+    GOUCT_FEATURE_DIST_LAST_4,
+
+    /** Distance 5 to 8 to the last move. */
+    GOUCT_FEATURE_DIST_LAST_5,
+
+    /** The local pattern is not in the pattern dictionary.
+        Not set by GoUctFeatureUtil::FindFeatures(), the weight is used by
+        GoUctFeatureWeights::PatternWeight() for unknown patterns. */
+    GOUCT_FEATURE_UNKNOWN_PATTERN,
+
+    _GOUCT_NU_FEATURES
+};
+
+/** Features of a move. */
+struct GoUctMoveFeatures
+{
+    /** Bit i is set if the move has GoUctFeature i. */
+    unsigned int m_tactical;
+
+    /** Does the move have a local pattern? (false for pass) */
+    bool m_hasPattern;
+
+    /** See GoUctFeatureUtil::PatternCode() */
+    uint32_t m_pattern;
+
+    GoUctMoveFeatures();
+
+    bool Has(GoUctFeature feature) const;
+};
+
+inline GoUctMoveFeatures::GoUctMoveFeatures()
+    : m_tactical(0),
+      m_hasPattern(false),
+      m_pattern(0)
+{ }
+
+inline bool GoUctMoveFeatures::Has(GoUctFeature feature) const
+{
+    return (m_tactical & (1u << feature)) != 0;
+}
+
+//----------------------------------------------------------------------------
+
+namespace GoUctFeatureUtil
+{
+    /** Compute the features of a legal move or pass for the color to
+        play. */
+    GoUctMoveFeatures FindFeatures(const GoBoard& bd, SgPoint p);
+
+    /** Code of the local pattern around an empty point.
+        The pattern contains the points within Manhattan distance 2. The four
+        neighbors are encoded with the number of liberties of their block
+        (1, 2, 3 or more), the other points with their color only. Colors are
+        relative to the color to play. The code is the minimum over the eight
+        symmetries of the board, so that equivalent patterns have the same
+        code. Uses 28 bits. */
+    uint32_t PatternCode(const GoBoard& bd, SgPoint p);
+}
+
+//----------------------------------------------------------------------------
+
+/** Weights of the tactical features and the pattern dictionary.
+    The pattern weights are stored in an open addressing hash table with
+    linear probing, so the lookup of a pattern takes constant time. */
+class GoUctFeatureWeights
+{
+public:
+    GoUctFeatureWeights();
+
+    /** Remove all patterns and set all weights to zero. */
+    void Clear();
+
+    float Weight(GoUctFeature feature) const;
+
+    float& Weight(GoUctFeature feature);
+
+    /** Weight of a pattern or of GOUCT_FEATURE_UNKNOWN_PATTERN if the
+        pattern is not in the dictionary. */
+    float PatternWeight(uint32_t code) const;
+
+    /** Weight of a pattern in the dictionary.
+        @return The weight or 0, if the pattern is not in the dictionary. */
+    float* FindPattern(uint32_t code);
+
+    /** Add a pattern with weight zero, if not already in the dictionary.
+        @return The weight of the pattern. */
+    float& AddPattern(uint32_t code);
+
+    int NuPatterns() const;
+
+    /** Logarithm of the strength of a move. */
+    float Evaluate(const GoUctMoveFeatures& features) const;
+
+    /** Read weights in the binary format written by Write().
+        @throws SgException If the stream does not contain valid weights */
+    void Read(std::istream& in);
+
+    /** Write weights in a compact binary format.
+        Contains a header with a version and the number of tactical features,
+        the tactical weights and the code and weight of each pattern in
+        little-endian byte order. */
+    void Write(std::ostream& out) const;
+
+private:
+    struct Entry
+    {
+        uint32_t m_code;
+
+        float m_weight;
+    };
+
+    /** Marks an unused entry; not a valid pattern code (uses 28 bits). */
+    static const uint32_t EMPTY_CODE = 0xffffffffu;
+
+    SgArray<float,_GOUCT_NU_FEATURES> m_weights;
+
+    int m_nuPatterns;
+
+    /** Hash table of patterns. Size is a power of two. */
+    std::vector<Entry> m_table;
+
+    std::size_t Index(uint32_t code) const;
+
+    void Resize(std::size_t size);
+};
+
+inline float GoUctFeatureWeights::Weight(GoUctFeature feature) const
+{
+    return m_weights[feature];
+}
+
+inline float& GoUctFeatureWeights::Weight(GoUctFeature feature)
+{
+    return m_weights[feature];
+}
+
+inline int GoUctFeatureWeights::NuPatterns() const
+{
+    return m_nuPatterns;
+}
+
+//----------------------------------------------------------------------------
+
+/** Parameters for GoUctFeatureKnowledge; shared by all threads. */
+class GoUctFeatureKnowledgeParam
+    : public GoUctAdditiveKnowledgeParam
+{
+public:
+    GoUctFeatureKnowledgeParam();
+
+    GoUctFeatureWeights m_weights;
+};
+
+//----------------------------------------------------------------------------
+
+/** Additive knowledge from feature weights.
+    Sets SgUctMoveInfo::m_gamma and SgUctMoveInfo::m_prior, which are used by
+    the progressive bias term of SgUctSearch (see
+    SgUctSearch::ProgressiveBiasConstant()). The gammas are scaled such that
+    the strongest move has gamma 1. */
+class GoUctFeatureKnowledge
+    : public GoUctAdditiveKnowledge
+{
+public:
+    GoUctFeatureKnowledge(const GoBoard& bd,
+                          const GoUctFeatureKnowledgeParam& param);
+
+    void ProcessPosition(std::vector<SgUctMoveInfo>& moves);
+
+private:
+    const GoUctFeatureKnowledgeParam& m_param;
+
+    /** Log strengths of the moves; member to avoid reallocation. */
+    std::vector<float> m_logGamma;
+};
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_FEATUREKNOWLEDGE_H
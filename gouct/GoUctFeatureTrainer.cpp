@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------
+/** @file GoUctFeatureTrainer.cpp
+    See GoUctFeatureTrainer.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctFeatureTrainer.h"
+
+#include <cmath>
+#include <fstream>
+#include "GoGame.h"
+#include "SgDebug.h"
+#include "SgException.h"
+#include "SgGameReader.h"
+#include "SgNode.h"
+#include "SgProp.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+GoUctFeatureTrainer::GoUctFeatureTrainer(GoUctFeatureWeights& weights)
+    : m_weights(weights),
+      m_learningRate(0.01f)
+{
+    ClearStatistics();
+}
+
+/** Add the features and log-strength of a candidate move of a position.
+    @param bd The position
+    @param p The move
+    @param[in,out] maxLogGamma The maximum log-strength of the candidates */
+void GoUctFeatureTrainer::AddCandidate(const GoBoard& bd, SgPoint p,
+                                       float& maxLogGamma)
+{
+    const GoUctMoveFeatures features = GoUctFeatureUtil::FindFeatures(bd, p);
+    const float logGamma = m_weights.Evaluate(features);
+    if (m_features.empty() || logGamma > maxLogGamma)
+        maxLogGamma = logGamma;
+    m_features.push_back(features);
+    m_probability.push_back(logGamma);
+}
+
+void GoUctFeatureTrainer::AddToWeights(const GoUctMoveFeatures& features,
+                                       float delta)
+{
+    for (int i = 0; i < _GOUCT_NU_FEATURES; ++i)
+        if (features.Has(static_cast<GoUctFeature>(i)))
+            m_weights.Weight(static_cast<GoUctFeature>(i)) += delta;
+    if (features.m_hasPattern)
+    {
+        float* weight = m_weights.FindPattern(features.m_pattern);
+        if (weight != 0)
+            *weight += delta;
+        else
+            m_weights.Weight(GOUCT_FEATURE_UNKNOWN_PATTERN) += delta;
+    }
+}
+
+void GoUctFeatureTrainer::ClearStatistics()
+{
+    m_nuPositions = 0;
+    m_sumLogLikelihood = 0;
+}
+
+double GoUctFeatureTrainer::MeanLogLikelihood() const
+{
+    if (m_nuPositions == 0)
+        return 0;
+    return m_sumLogLikelihood / m_nuPositions;
+}
+
+void GoUctFeatureTrainer::TrainFile(const string& fileName)
+{
+    ifstream in(fileName.c_str());
+    if (! in)
+        throw SgException("could not open " + fileName);
+    SgGameReader reader(in);
+    SgNode* root;
+    while ((root = reader.ReadGame()) != 0)
+    {
+        if (reader.GetWarnings().any())
+        {
+            SgWarning() << fileName << ":\n";
+            reader.PrintWarnings(SgDebug());
+        }
+        TrainGame(root);
+    }
+}
+
+void GoUctFeatureTrainer::TrainGame(SgNode* root)
+{
+    GoGame game;
+    game.Init(root);
+    const SgNode* node = &game.Root();
+    while (node->HasSon())
+    {
+        node = node->LeftMostSon();
+        if (node->HasProp(SG_PROP_MOVE))
+        {
+            const SgPropMove* prop =
+                static_cast<const SgPropMove*>(node->Get(SG_PROP_MOVE));
+            const GoBoard& bd = game.Board();
+            if (prop->Player() == bd.ToPlay()
+                && (prop->Value() == SG_PASS || bd.IsLegal(prop->Value())))
+                TrainPosition(bd, prop->Value());
+        }
+        game.GoToNode(node);
+    }
+}
+
+void GoUctFeatureTrainer::TrainPosition(const GoBoard& bd, SgPoint move)
+{
+    // Add the pattern before taking pointers to weights, adding can
+    // reallocate the dictionary
+    const GoUctMoveFeatures moveFeatures =
+        GoUctFeatureUtil::FindFeatures(bd, move);
+    if (moveFeatures.m_hasPattern)
+        m_weights.AddPattern(moveFeatures.m_pattern);
+    m_features.clear();
+    m_probability.clear();
+    float maxLogGamma = 0;
+    for (SgSetIterator it(bd.AllLegal(bd.ToPlay())); it; ++it)
+        AddCandidate(bd, *it, maxLogGamma);
+    // Pass is a candidate as in GoUctFeatureKnowledge::ProcessPosition()
+    AddCandidate(bd, SG_PASS, maxLogGamma);
+    float sum = 0;
+    for (size_t i = 0; i < m_probability.size(); ++i)
+    {
+        m_probability[i] = exp(m_probability[i] - maxLogGamma);
+        sum += m_probability[i];
+    }
+    const float logGammaMove = m_weights.Evaluate(moveFeatures);
+    m_sumLogLikelihood += logGammaMove - maxLogGamma - log(sum);
+    ++m_nuPositions;
+    for (size_t i = 0; i < m_features.size(); ++i)
+        AddToWeights(m_features[i],
+                     -m_learningRate * m_probability[i] / sum);
+    AddToWeights(moveFeatures, m_learningRate);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+//----------------------------------------------------------------------------
+/** @file GoUctFeatureTrainer.h
+    Offline training of the weights of GoUctFeatureKnowledge. */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_FEATURETRAINER_H
+#define GOUCT_FEATURETRAINER_H
+
+#include <string>
+#include <vector>
+#include "GoUctFeatureKnowledge.h"
+
+class SgNode;
+
+//----------------------------------------------------------------------------
+
+/** Learns feature weights from the moves of game records.
+    Maximizes the likelihood of the game moves under the generalized
+    Bradley-Terry model of GoUctFeatureKnowledge by stochastic gradient
+    ascent: for each position, the weights of the features of the played
+    move are increased and the weights of the features of all legal moves and
+    pass are decreased by their probability, both times the learning rate.
+    Pass is a candidate and a training move like any other move, because
+    GoUctFeatureKnowledge also evaluates it (with GOUCT_FEATURE_PASS).
+    Patterns that occur in played moves are added to the pattern dictionary;
+    all other patterns share the weight of GOUCT_FEATURE_UNKNOWN_PATTERN.
+    Training over a collection usually takes several passes. */
+class GoUctFeatureTrainer
+{
+public:
+    GoUctFeatureTrainer(GoUctFeatureWeights& weights);
+
+    /** Learning rate of the gradient ascent.
+        Default is 0.01. */
+    float LearningRate() const;
+
+    /** See LearningRate() */
+    void SetLearningRate(float rate);
+
+    /** Train on the moves of the main variation of a game.
+        Takes the ownership of the tree. */
+    void TrainGame(SgNode* root);
+
+    /** Train on all games of a SGF file.
+        @throws SgException If the file cannot be read */
+    void TrainFile(const std::string& fileName);
+
+    /** Number of positions trained since the last ClearStatistics(). */
+    int NuPositions() const;
+
+    /** Mean log-likelihood of the played moves before their update since
+        the last ClearStatistics(). */
+    double MeanLogLikelihood() const;
+
+    void ClearStatistics();
+
+private:
+    GoUctFeatureWeights& m_weights;
+
+    float m_learningRate;
+
+    int m_nuPositions;
+
+    double m_sumLogLikelihood;
+
+    /** Features of the legal moves and pass; member to avoid reallocation. */
+    std::vector<GoUctMoveFeatures> m_features;
+
+    /** Probabilities of the legal moves and pass; member to avoid
+        reallocation. */
+    std::vector<float> m_probability;
+
+    void AddCandidate(const GoBoard& bd, SgPoint p, float& maxLogGamma);
+
+    void AddToWeights(const GoUctMoveFeatures& features, float delta);
+
+    void TrainPosition(const GoBoard& bd, SgPoint move);
+};
+
+inline float GoUctFeatureTrainer::LearningRate() const
+{
+    return m_learningRate;
+}
+
+inline int GoUctFeatureTrainer::NuPositions() const
+{
+    return m_nuPositions;
+}
+
+inline void GoUctFeatureTrainer::SetLearningRate(float rate)
+{
+    m_learningRate = rate;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_FEATURETRAINER_H
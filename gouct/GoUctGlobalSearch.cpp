@@ -11,10 +11,12 @@ using namespace std;
 
 GoUctGlobalSearchStateParam::GoUctGlobalSearchStateParam()
     : m_mercyRule(true),
+      m_earlyTermination(true),
       m_territoryStatistics(false),
       m_lengthModification(0),
       m_scoreModification(0.02f),
-      m_useTreeFilter(false)
+      m_useTreeFilter(false),
+      m_useFeatureKnowledge(false)
 {
 }
 
@@ -15,9 +15,13 @@
 #include "GoRegionBoard.h"
 #include "GoSafetySolver.h"
 #include "GoUctDefaultPriorKnowledge.h"
+#include "GoUctFeatureKnowledge.h"
+#include "GoUctPlayoutPolicy.h"
 #include "GoUctSearch.h"
+#include "GoUctSizedKernel.h"
 #include "GoUctUtil.h"
 #include "GoUctDefaultMoveFilter.h"
+#include "GoUctMoveFilterCache.h"
 
 #define BOOST_VERSION_MAJOR (BOOST_VERSION / 100000)
 #define BOOST_VERSION_MINOR (BOOST_VERSION / 100 % 1000)
@@ -41,6 +45,15 @@ struct GoUctGlobalSearchStateParam
         exceeds a threshold of 30% of the total number of points on board. */
     bool m_mercyRule;
 
+    /** Stop playouts in settled positions.
+        Ends a playout as soon as GoUctUtil::IsSettledPosition() is true and
+        scores it with GoUctUtil::ScoreSettledPosition(). This skips the
+        remaining moves that only fill dame; their alternating fill is
+        accounted for in the score, so a cut-off playout has the same result
+        as the finished playout. Used in addition to the mercy rule. Default
+        is true. */
+    bool m_earlyTermination;
+
     /** Compute probabilities of territory in terminal positions. */
     bool m_territoryStatistics;
 
@@ -71,6 +84,17 @@ struct GoUctGlobalSearchStateParam
 
     bool m_useTreeFilter;
 
+    /** Parameters for GoUctDefaultPriorKnowledge. */
+    GoUctDefaultPriorKnowledgeParam m_defaultKnowledge;
+
+    /** Use GoUctFeatureKnowledge with the weights in m_featureKnowledge to
+        set the priors of new nodes.
+        The priors are only used if SgUctSearch::ProgressiveBiasConstant()
+        is not zero. */
+    bool m_useFeatureKnowledge;
+
+    GoUctFeatureKnowledgeParam m_featureKnowledge;
+
     GoUctGlobalSearchStateParam();
 };
 
@@ -126,6 +150,9 @@ public:
         the search is used.
         @param param Parameters. Stores a reference to the argument.
         @param policyParam Stores a reference to the argument.
+        @param treeFilterParam Stores a reference to the argument.
+        @param treeFilterCache Results of the tree filter shared by all
+        threads. Stores a reference to the argument.
         @param safe Safety information. Stores a reference to the argument.
         @param allSafe Safety information. Stores a reference to the argument. */
     GoUctGlobalSearchState(unsigned int threadId, const GoBoard& bd,
@@ -133,6 +160,7 @@ public:
                            const GoUctGlobalSearchStateParam& param,
                            const GoUctPlayoutPolicyParam& policyParam,
                            const GoUctDefaultMoveFilterParam& treeFilterParam,
+                           GoUctMoveFilterCache& treeFilterCache,
                            const SgBWSet& safe,
                            const SgPointArray<bool>& allSafe);
 
@@ -172,9 +200,15 @@ private:
 
     const GoUctDefaultMoveFilterParam& m_treeFilterParam;
 
+    GoUctMoveFilterCache& m_treeFilterCache;
+
     /** See SetMercyRule() */
     bool m_mercyRuleTriggered;
 
+    /** Playout was stopped in a settled position.
+        See GoUctGlobalSearchStateParam::m_earlyTermination */
+    bool m_earlyTerminationTriggered;
+
     /** Number of pass moves played in a row in the playout phase. */
     int m_passMovesPlayoutPhase;
 
@@ -188,6 +222,12 @@ private:
     /** Board move number at root node of search. */
     int m_initialMoveNumber;
 
+    /** Board size of the specialized playout kernels to use.
+        Selected at the start of each search, so that a change of the board
+        size switches the kernels; 0 if the size has no specialized kernels.
+        See GoUctSizedKernel. */
+    int m_kernelSize;
+
     /** The area in which moves should be generated. */
     GoPointList m_area;
 
@@ -202,6 +242,8 @@ private:
 
     GoUctDefaultPriorKnowledge m_priorKnowledge;
 
+    GoUctFeatureKnowledge m_featureKnowledge;
+
     boost::scoped_ptr<POLICY> m_policy;
 
     GoUctDefaultMoveFilter m_treeFilter;
@@ -230,7 +272,8 @@ GoUctGlobalSearchState<POLICY>::GoUctGlobalSearchState(unsigned int threadId,
          const GoBoard& bd, POLICY* policy,
          const GoUctGlobalSearchStateParam& param,
          const GoUctPlayoutPolicyParam& policyParam,
-         const GoUctDefaultMoveFilterParam& treeFilterParam,                                                   
+         const GoUctDefaultMoveFilterParam& treeFilterParam,
+         GoUctMoveFilterCache& treeFilterCache,
          const SgBWSet& safe, const SgPointArray<bool>& allSafe)
     : GoUctState(threadId, bd),
       m_safe(safe),
@@ -238,7 +281,10 @@ GoUctGlobalSearchState<POLICY>::GoUctGlobalSearchState(unsigned int threadId,
       m_param(param),
       m_policyParam(policyParam),
       m_treeFilterParam(treeFilterParam),
-      m_priorKnowledge(Board(), m_policyParam),
+      m_treeFilterCache(treeFilterCache),
+      m_kernelSize(0),
+      m_priorKnowledge(Board(), m_policyParam, m_param.m_defaultKnowledge),
+      m_featureKnowledge(Board(), m_param.m_featureKnowledge),
       m_policy(policy),
       m_treeFilter(Board(), m_treeFilterParam)
 {
@@ -272,19 +318,34 @@ bool GoUctGlobalSearchState<POLICY>::CheckMercyRule()
     return m_mercyRuleTriggered;
 }
 
+/** Remove the moves of the tree filter.
+    The result of the tree filter is looked up in the cache shared by the
+    threads first, because the same position can be expanded in several
+    nodes (transpositions) or by several threads. */
 template<class POLICY>
 void GoUctGlobalSearchState<POLICY>::ApplyFilter(std::vector<SgUctMoveInfo>& moves)
 {
-    std::vector<SgPoint> filtered = m_treeFilter.Get();
-    
-    if (filtered.size() > 0) {
+    const GoBoard& bd = Board();
+    // Incremental results depend on the previously filtered positions of
+    // this thread, not only on the position, so they are not cached
+    const bool useCache = ! m_treeFilterParam.Incremental();
+    SgPointSet filtered;
+    if (! useCache || ! m_treeFilterCache.Lookup(bd, filtered))
+    {
+        const std::vector<SgPoint> filteredMoves = m_treeFilter.Get();
+        for (std::vector<SgPoint>::const_iterator it = filteredMoves.begin();
+             it != filteredMoves.end(); ++it)
+            filtered.Include(*it);
+        if (useCache)
+            m_treeFilterCache.Store(bd, filtered);
+    }
+    if (filtered.NonEmpty()) {
         // Filter without changing the order of the unfiltered moves.
         // Copied from SgUctSearch::ApplyRootFilter()
         std::vector<SgUctMoveInfo> filteredMoves;
         for (std::vector<SgUctMoveInfo>::const_iterator it = moves.begin();
              it != moves.end(); ++it)
-            if (find(filtered.begin(), filtered.end(), it->m_move)
-                == filtered.end())
+            if (it->m_move == SG_PASS || ! filtered.Contains(it->m_move))
                 filteredMoves.push_back(*it);
         moves = filteredMoves;
     }
@@ -308,11 +369,7 @@ void GoUctGlobalSearchState<POLICY>::EndPlayout()
 template<class POLICY>
 SgUctValue GoUctGlobalSearchState<POLICY>::Evaluate()
 {
-    float komi = GetKomi();
-    if (IsInPlayout())
-        return EvaluateBoard(UctBoard(), komi);
-    else
-        return EvaluateBoard(Board(), komi);
+    return EvaluateBoard(UctBoard(), GetKomi());
 }
 
 template<class POLICY>
@@ -329,16 +386,17 @@ SgUctValue GoUctGlobalSearchState<POLICY>::EvaluateBoard(const BOARD& bd,
         scoreBoardPtr = 0;
     if (m_param.m_mercyRule && m_mercyRuleTriggered)
         return m_mercyRuleResult;
+    else if (m_earlyTerminationTriggered)
+        score = SgUctValue(GoUctUtil::ScoreSettledPosition(bd, komi, m_safe,
+                                                           scoreBoardPtr));
     else if (m_passMovesPlayoutPhase < 2)
         // Two passes not in playout phase, see comment in GenerateAllMoves()
         score = (SgUctValue)GoBoardUtil::TrompTaylorScore(bd, komi, scoreBoardPtr);
     else
-    {
         score =
-            SgUctValue(GoBoardUtil::ScoreSimpleEndPosition(bd, komi, m_safe,
-                                                           false,
-                                                           scoreBoardPtr));
-    }
+            SgUctValue(GoUctSizedKernelUtil::ScoreSimpleEndPosition(
+                                         m_kernelSize, bd, komi, m_safe,
+                                         false, scoreBoardPtr));
     if (m_param.m_territoryStatistics)
         for (typename BOARD::Iterator it(bd); it; ++it)
             switch (scoreBoard[*it])
@@ -392,6 +450,7 @@ void GoUctGlobalSearchState<POLICY>::GameStart()
     GoUctState::GameStart();
     m_passMovesPlayoutPhase = 0;
     m_mercyRuleTriggered = false;
+    m_earlyTerminationTriggered = false;
 }
 
 template<class POLICY>
@@ -417,13 +476,13 @@ void GoUctGlobalSearchState<POLICY>::GenerateLegalMoves(
             return;
 
     SgBlackWhite toPlay = bd.ToPlay();
+    const SgPointSet legal = bd.AllLegal(toPlay);
     for (GoBoard::Iterator it(bd); it; ++it)
     {
         SgPoint p = *it;
-        if (bd.IsEmpty(p)
+        if (legal.Contains(p)
             && ! GoEyeUtil::IsSimpleEye(bd, p, toPlay)
-            && ! m_allSafe[p]
-            && bd.IsLegal(p, toPlay))
+            && ! m_allSafe[p])
             moves.push_back(SgUctMoveInfo(p));
     }
 
@@ -444,6 +503,18 @@ bool GoUctGlobalSearchState<POLICY>::GenerateAllMoves(SgUctValue count,
 {
     provenType = SG_NOT_PROVEN;
     moves.clear();  // FIXME: needed?
+    if (count < 0 && GameLength() >= 2)
+    {
+        // Only the check for a terminal position is needed, which does not
+        // need the in-tree GoBoard if two moves were played in the search
+        // (see GenerateLegalMoves())
+        const GoUctBoard& bd = UctBoard();
+        if (  bd.GetLastMove() != SG_PASS
+           || bd.Get2ndLastMove() != SG_PASS)
+            moves.push_back(SgUctMoveInfo(SG_PASS));
+        return false;
+    }
+    SyncBoard();
     GenerateLegalMoves(moves);
     if (! moves.empty())
     {
@@ -452,6 +523,9 @@ bool GoUctGlobalSearchState<POLICY>::GenerateAllMoves(SgUctValue count,
             if (m_param.m_useTreeFilter)
                 ApplyFilter(moves);
             m_priorKnowledge.ProcessPosition(moves);
+            if (m_param.m_useFeatureKnowledge
+                && m_featureKnowledge.InMoveRange(Board().MoveNumber()))
+                m_featureKnowledge.ProcessPosition(moves);
         }
     }
     return false;
@@ -464,6 +538,12 @@ SgMove GoUctGlobalSearchState<POLICY>::GeneratePlayoutMove(
     SG_ASSERT(IsInPlayout());
     if (m_param.m_mercyRule && CheckMercyRule())
         return SG_NULLMOVE;
+    if (m_param.m_earlyTermination
+        && GoUctUtil::IsSettledPosition(UctBoard()))
+    {
+        m_earlyTerminationTriggered = true;
+        return SG_NULLMOVE;
+    }
     SgPoint move = m_policy->GenerateMove();
     SG_ASSERT(move != SG_NULLMOVE);
 #ifndef NDEBUG
@@ -528,8 +608,14 @@ void GoUctGlobalSearchState<POLICY>::StartPlayout()
     GoUctState::StartPlayout();
     m_passMovesPlayoutPhase = 0;
     m_mercyRuleTriggered = false;
-    const GoBoard& bd = Board();
-    m_stoneDiff = bd.All(SG_BLACK).Size() - bd.All(SG_WHITE).Size();
+    m_earlyTerminationTriggered = false;
+    const GoUctBoard& bd = UctBoard();
+    m_stoneDiff = 0;
+    for (GoUctBoard::Iterator it(bd); it; ++it)
+        if (bd.IsColor(*it, SG_BLACK))
+            ++m_stoneDiff;
+        else if (bd.IsColor(*it, SG_WHITE))
+            --m_stoneDiff;
     m_policy->StartPlayout();
 }
 
@@ -549,6 +635,7 @@ void GoUctGlobalSearchState<POLICY>::StartSearch()
     m_invMaxScore = (SgUctValue)(1 / maxScore);
     m_initialMoveNumber = bd.MoveNumber();
     m_mercyRuleThreshold = static_cast<int>(0.3 * size * size);
+    m_kernelSize = GoUctSizedKernelUtil::KernelSize(size);
     ClearTerritoryStatistics();
 }
 
@@ -569,12 +656,14 @@ public:
         @param treeFilterParam
         Stores a reference. Lifetime of parameter must exceed the lifetime of
         this instance.
+        @param treeFilterCache
         @param safe
         @param allSafe */
     GoUctGlobalSearchStateFactory(GoBoard& bd,
                                   FACTORY& playoutPolicyFactory,
                                   const GoUctPlayoutPolicyParam& policyParam,
                                   const GoUctDefaultMoveFilterParam& treeFilterParam,
+                                  GoUctMoveFilterCache& treeFilterCache,
                                   const SgBWSet& safe,
                                   const SgPointArray<bool>& allSafe);
 
@@ -589,6 +678,8 @@ private:
 
     const GoUctDefaultMoveFilterParam& m_treeFilterParam;
 
+    GoUctMoveFilterCache& m_treeFilterCache;
+
     const SgBWSet& m_safe;
 
     const SgPointArray<bool>& m_allSafe;
@@ -600,12 +691,14 @@ GoUctGlobalSearchStateFactory<POLICY,FACTORY>
                   FACTORY& playoutPolicyFactory,
                   const GoUctPlayoutPolicyParam& policyParam,
                   const GoUctDefaultMoveFilterParam& treeFilterParam,
+                  GoUctMoveFilterCache& treeFilterCache,
                   const SgBWSet& safe,
                   const SgPointArray<bool>& allSafe)
     : m_bd(bd),
       m_playoutPolicyFactory(playoutPolicyFactory),
       m_policyParam(policyParam),
       m_treeFilterParam(treeFilterParam),
+      m_treeFilterCache(treeFilterCache),
       m_safe(safe),
       m_allSafe(allSafe)
 {
@@ -648,6 +741,10 @@ public:
 
     void OnStartSearch();
 
+    /** Collects the profiles of the playout policies of all threads.
+        See PolicyProfile() */
+    void OnEndSearch();
+
     void DisplayGfx();
 
     // @} // @name
@@ -667,17 +764,30 @@ public:
     /** See GlobalSearchLiveGfx() */
     void SetGlobalSearchLiveGfx(bool enable);
 
+    /** Profile of the playout policies of the last search.
+        Merged from the profiles of all threads. Empty, if
+        GoUctPlayoutPolicyParam::m_profileInterval is zero. */
+    const GoUctPlayoutPolicyProfile& PolicyProfile() const;
+
 private:
     SgBWSet m_safe;
 
     SgPointArray<bool> m_allSafe;
 
+    /** Results of the tree filter shared by the threads.
+        Cleared at the start of each search, because the tree filter
+        parameters may have changed. */
+    GoUctMoveFilterCache m_treeFilterCache;
+
     boost::scoped_ptr<FACTORY> m_playoutPolicyFactory;
 
     GoRegionBoard m_regions;
 
     /** See GlobalSearchLiveGfx() */
     bool m_globalSearchLiveGfx;
+
+    /** See PolicyProfile() */
+    GoUctPlayoutPolicyProfile m_policyProfile;
 };
 
 template<class POLICY, class FACTORY>
@@ -695,6 +805,7 @@ GoUctGlobalSearch<POLICY,FACTORY>::GoUctGlobalSearch(GoBoard& bd,
                                                           *playoutFactory,
                                                           policyParam,
                                                           rootFilterParam,
+                                                          m_treeFilterCache,
                                                           m_safe, m_allSafe);
     SetThreadStateFactory(stateFactory);
     SetDefaultParameters(bd.Size());
@@ -724,6 +835,13 @@ inline bool GoUctGlobalSearch<POLICY,FACTORY>::GlobalSearchLiveGfx() const
     return m_globalSearchLiveGfx;
 }
 
+template<class POLICY, class FACTORY>
+inline const GoUctPlayoutPolicyProfile&
+GoUctGlobalSearch<POLICY,FACTORY>::PolicyProfile() const
+{
+    return m_policyProfile;
+}
+
 template<class POLICY, class FACTORY>
 void GoUctGlobalSearch<POLICY,FACTORY>::DisplayGfx()
 {
@@ -745,6 +863,8 @@ template<class POLICY, class FACTORY>
 void GoUctGlobalSearch<POLICY,FACTORY>::OnStartSearch()
 {
     GoUctSearch::OnStartSearch();
+    if (m_param.m_useTreeFilter)
+        m_treeFilterCache.Clear();
     m_safe.Clear();
     m_allSafe.Fill(false);
     if (GOUCT_USE_SAFETY_SOLVER)
@@ -761,6 +881,24 @@ void GoUctGlobalSearch<POLICY,FACTORY>::OnStartSearch()
             "live graphics need territory statistics enabled\n";
 }
 
+template<class POLICY, class FACTORY>
+void GoUctGlobalSearch<POLICY,FACTORY>::OnEndSearch()
+{
+    GoUctSearch::OnEndSearch();
+    m_policyProfile.Clear();
+    for (unsigned int i = 0; i < NumberThreads(); ++i)
+    {
+        GoUctGlobalSearchState<POLICY>& state =
+            dynamic_cast<GoUctGlobalSearchState<POLICY>&>(ThreadState(i));
+        POLICY* policy = state.Policy();
+        if (policy != 0)
+        {
+            m_policyProfile.Merge(policy->Profile());
+            policy->ClearProfile();
+        }
+    }
+}
+
 template<class POLICY, class FACTORY>
 void GoUctGlobalSearch<POLICY,FACTORY>::SetDefaultParameters(int boardSize)
 {
@@ -817,6 +955,7 @@ SgUctThreadState* GoUctGlobalSearchStateFactory<POLICY,FACTORY>::Create(
                                    globalSearch.m_param, 
                                            m_policyParam,
                                            m_treeFilterParam,
+                                           m_treeFilterCache,
                                            m_safe, m_allSafe);
     POLICY* policy = m_playoutPolicyFactory.Create(state->UctBoard());
     state->SetPolicy(policy);
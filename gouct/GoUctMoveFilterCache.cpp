@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------------
+/** @file GoUctMoveFilterCache.cpp
+    See GoUctMoveFilterCache.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctMoveFilterCache.h"
+
+#include "GoBoard.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+GoUctMoveFilterCache::GoUctMoveFilterCache(size_t nuEntries)
+    : m_entries(nuEntries),
+      m_mutexes(new boost::mutex[NU_MUTEXES])
+{
+    SG_ASSERT(nuEntries > 0);
+    Clear();
+}
+
+void GoUctMoveFilterCache::Clear()
+{
+    for (vector<Entry>::iterator it = m_entries.begin();
+         it != m_entries.end(); ++it)
+        it->m_size = 0;
+}
+
+inline size_t GoUctMoveFilterCache::Index(const SgHashCode& hash) const
+{
+    return hash.Hash(static_cast<int>(m_entries.size()));
+}
+
+bool GoUctMoveFilterCache::Lookup(const GoBoard& bd, SgPointSet& filtered)
+{
+    const SgHashCode hash = bd.GetHashCodeInclToPlay();
+    const size_t index = Index(hash);
+    const Entry& entry = m_entries[index];
+    boost::mutex::scoped_lock lock(m_mutexes[index % NU_MUTEXES]);
+    if (entry.m_size != bd.Size() || entry.m_hash != hash)
+        return false;
+    filtered = entry.m_filtered;
+    return true;
+}
+
+void GoUctMoveFilterCache::Store(const GoBoard& bd,
+                                 const SgPointSet& filtered)
+{
+    const SgHashCode hash = bd.GetHashCodeInclToPlay();
+    const size_t index = Index(hash);
+    Entry& entry = m_entries[index];
+    boost::mutex::scoped_lock lock(m_mutexes[index % NU_MUTEXES]);
+    entry.m_size = bd.Size();
+    entry.m_hash = hash;
+    entry.m_filtered = filtered;
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+//----------------------------------------------------------------------------
+/** @file GoUctMoveFilterCache.h */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_MOVEFILTERCACHE_H
+#define GOUCT_MOVEFILTERCACHE_H
+
+#include <vector>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/mutex.hpp>
+#include "SgHash.h"
+#include "SgPointSet.h"
+
+class GoBoard;
+
+//----------------------------------------------------------------------------
+
+/** Bounded cache of the moves filtered by a move filter, shared by the
+    threads of a search.
+    The cache is a direct-mapped table indexed by the hash code of the
+    position including the color to play; a new entry replaces the old entry
+    with the same index. The entries are protected by a fixed number of
+    mutexes, each mutex protects the entries whose index is equal modulo the
+    number of mutexes, so threads rarely wait for each other. The ko point is
+    not part of the key. */
+class GoUctMoveFilterCache
+{
+public:
+    /** Constructor.
+        @param nuEntries Number of entries of the table. */
+    explicit GoUctMoveFilterCache(std::size_t nuEntries = 1 << 14);
+
+    /** Look up the filtered moves of the current position.
+        @param bd The board
+        @param[out] filtered The filtered moves, if found
+        @return @c true if the position was found */
+    bool Lookup(const GoBoard& bd, SgPointSet& filtered);
+
+    /** Store the filtered moves of the current position. */
+    void Store(const GoBoard& bd, const SgPointSet& filtered);
+
+    /** Remove all entries.
+        Must not be called concurrently with Lookup() or Store(); the search
+        clears the cache at the start of a search, because the filter
+        parameters may have changed. */
+    void Clear();
+
+private:
+    static const std::size_t NU_MUTEXES = 64;
+
+    struct Entry
+    {
+        /** Board size, 0 for an unused entry. */
+        int m_size;
+
+        SgHashCode m_hash;
+
+        SgPointSet m_filtered;
+    };
+
+    std::vector<Entry> m_entries;
+
+    boost::scoped_array<boost::mutex> m_mutexes;
+
+    std::size_t Index(const SgHashCode& hash) const;
+
+    /** Not implemented */
+    GoUctMoveFilterCache(const GoUctMoveFilterCache&);
+
+    /** Not implemented */
+    GoUctMoveFilterCache& operator=(const GoUctMoveFilterCache&);
+};
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_MOVEFILTERCACHE_H
@@ -6,9 +6,14 @@
 #ifndef GOUCT_PLAYER_H
 #define GOUCT_PLAYER_H
 
+#include <algorithm>
+#include <functional>
+#include <utility>
 #include <boost/scoped_ptr.hpp>
+#include <boost/thread.hpp>
 #include <vector>
 #include "GoBoard.h"
+#include "GoBoardHistory.h"
 #include "GoBoardRestorer.h"
 #include "GoPlayer.h"
 #include "GoTimeControl.h"
@@ -63,6 +68,11 @@ public:
 
         SgStatisticsExt<float,std::size_t> m_reuse;
 
+        /** Fraction of the moves of the opponent that were among the
+            candidates of the previous pondering.
+            See PonderCandidates() */
+        SgStatisticsExt<float,std::size_t> m_ponderHit;
+
         SgStatisticsExt<double,std::size_t> m_gamesPerSecond;
 
         Statistics();
@@ -91,6 +101,8 @@ public:
 
     void OnBoardChange();
 
+    void OnUpdate();
+
     // @} // @name
 
 
@@ -185,6 +197,20 @@ public:
     /** See MaxPonderTime() */
     void SetMaxPonderTime(double seconds);
 
+    /** Number of predicted moves of the opponent to ponder on.
+        If greater zero, pondering first does a short search to predict the
+        moves of the opponent, and then searches in turn below each of the
+        children of the root with the highest move counts (at most this
+        number), each for a share of the time proportional to its count.
+        The subtrees of the candidates are kept in the search tree, such that
+        a larger part of the tree can be reused if the opponent plays one of
+        them. If 0, the pondering search is a regular search in the current
+        position. Default is 0. */
+    int PonderCandidates() const;
+
+    /** See PonderCandidates() */
+    void SetPonderCandidates(int n);
+
     /** Minimum number of simulations to check for resign.
         This minimum number of simulations is also required to apply the
         early pass check (see EarlyPass()).
@@ -209,6 +235,20 @@ public:
     /** See ReuseSubtree() */
     void SetReuseSubtree(bool enable);
 
+    /** Prepare the reused subtree in a background thread.
+        If enabled and ReuseSubtree() is true, the player starts extracting
+        the subtree for the new position from the search tree in a background
+        thread as soon as its board is updated (e.g. by the play command with
+        the move of the opponent), so that pondering and the next move
+        generation start with the subtree ready. All uses of the search wait
+        for the thread to finish. The non-const accessors of the search also
+        discard the prepared subtree, because the caller could modify the
+        search trees; the const accessors keep it. Default is true. */
+    bool PrepareInitTree() const;
+
+    /** See PrepareInitTree() */
+    void SetPrepareInitTree(bool enable);
+
     /** Threshold for position value to resign.
         Default is 0.01. */
     SgUctValue ResignThreshold() const;
@@ -277,6 +317,9 @@ public:
     /** See ReuseSubtree() */
     bool m_reuseSubtree;
 
+    /** See PrepareInitTree() */
+    bool m_prepareInitTree;
+
     /** See EarlyPass() */
     bool m_earlyPass;
 
@@ -292,6 +335,17 @@ public:
 
     double m_maxPonderTime;
 
+    /** See PonderCandidates() */
+    int m_ponderCandidates;
+
+    /** Candidate moves of the last pondering.
+        See PonderCandidates() */
+    std::vector<SgPoint> m_ponderMoves;
+
+    /** Position of the last pondering.
+        See m_ponderMoves */
+    GoBoardHistory m_ponderPosition;
+
     SEARCH m_search;
 
     GoTimeControl m_timeControl;
@@ -308,15 +362,56 @@ public:
 
     bool m_writeDebugOutput;
 
+    /** Function of the thread started by StartInitTree(). */
+    class InitTreeFunction
+    {
+    public:
+        InitTreeFunction(GoUctPlayer& player,
+                         const std::vector<SgPoint>& sequence);
+
+        void operator()();
+
+    private:
+        GoUctPlayer& m_player;
+
+        std::vector<SgPoint> m_sequence;
+    };
+
+    friend class InitTreeFunction;
+
+    /** See PrepareInitTree()
+        Mutable, because the const accessors of the search also wait for
+        the thread. */
+    mutable boost::scoped_ptr<boost::thread> m_initTreeThread;
+
+    /** Prepared init tree.
+        The temporary tree of the search, if it contains the subtree for
+        m_initTreePosition extracted by the thread started by
+        StartInitTree(), 0 otherwise. */
+    SgUctTree* m_initTree;
+
+    /** See m_initTree */
+    GoBoardHistory m_initTreePosition;
+
     SgMove GenMovePlayoutPolicy(SgBlackWhite toPlay);
 
     bool DoEarlyPassSearch(SgUctValue maxGames, double maxTime, SgPoint& move);
 
     SgPoint DoSearch(SgBlackWhite toPlay, double maxTime,
-                     bool isDuringPondering);
+                     bool isDuringPondering,
+                     SgUctStabilityParam* stability = 0);
+
+    void AddPonderHit();
+
+    void DiscardInitTree();
 
-    void FindInitTree(SgUctTree& initTree, SgBlackWhite toPlay,
-                      double maxTime);
+    SgUctTree& FindInitTree(SgBlackWhite toPlay, double maxTime);
+
+    void PonderOnCandidates();
+
+    void StartInitTree();
+
+    void WaitInitTree() const;
 
     void SetDefaultParameters(int boardSize);
 
@@ -333,12 +428,14 @@ template <class SEARCH, class THREAD>
 inline SEARCH&
 GoUctPlayer<SEARCH, THREAD>::GlobalSearch()
 {
+    DiscardInitTree();
     return m_search;
 }
 
 template <class SEARCH, class THREAD>
 inline const SEARCH& GoUctPlayer<SEARCH, THREAD>::GlobalSearch() const
 {
+    WaitInitTree();
     return m_search;
 }
 
@@ -402,6 +499,18 @@ inline bool GoUctPlayer<SEARCH, THREAD>::ReuseSubtree() const
     return m_reuseSubtree;
 }
 
+template <class SEARCH, class THREAD>
+inline int GoUctPlayer<SEARCH, THREAD>::PonderCandidates() const
+{
+    return m_ponderCandidates;
+}
+
+template <class SEARCH, class THREAD>
+inline bool GoUctPlayer<SEARCH, THREAD>::PrepareInitTree() const
+{
+    return m_prepareInitTree;
+}
+
 template <class SEARCH, class THREAD>
 inline GoUctMoveFilter& GoUctPlayer<SEARCH, THREAD>::RootFilter()
 {
@@ -462,6 +571,19 @@ inline void GoUctPlayer<SEARCH, THREAD>::SetUseRootFilter(bool enable)
     m_useRootFilter = enable;
 }
 
+template <class SEARCH, class THREAD>
+inline void GoUctPlayer<SEARCH, THREAD>::SetPonderCandidates(int n)
+{
+    SG_ASSERT(n >= 0);
+    m_ponderCandidates = n;
+}
+
+template <class SEARCH, class THREAD>
+inline void GoUctPlayer<SEARCH, THREAD>::SetPrepareInitTree(bool enable)
+{
+    m_prepareInitTree = enable;
+}
+
 template <class SEARCH, class THREAD>
 inline void GoUctPlayer<SEARCH, THREAD>::SetResignMinGames(SgUctValue n)
 {
@@ -502,6 +624,32 @@ GoUctPlayer<SEARCH, THREAD>::GetMpiSynchronizer()
     return SgMpiSynchronizerHandle(m_mpiSynchronizer);
 }
 
+template <class SEARCH, class THREAD>
+GoUctPlayer<SEARCH, THREAD>::InitTreeFunction::InitTreeFunction(
+                                       GoUctPlayer& player,
+                                       const std::vector<SgPoint>& sequence)
+    : m_player(player),
+      m_sequence(sequence)
+{
+}
+
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::InitTreeFunction::operator()()
+{
+    SEARCH& search = m_player.m_search;
+    SgUctTree& initTree = search.GetTempTree();
+    // The extraction is truncated, if SgUserAbort() is set by the next
+    // command before it is finished; FindInitTree() extracts the subtree
+    // again in this case
+    if (SgUctTreeUtil::ExtractSubtree(search.Tree(), initTree, m_sequence,
+                                      false,
+                                      std::numeric_limits<double>::max(),
+                                      search.PruneMinCount()))
+        m_player.m_initTree = &initTree;
+}
+
+//----------------------------------------------------------------------------
+
 template <class SEARCH, class THREAD>
 GoUctPlayer<SEARCH, THREAD>::Statistics::Statistics()
 {
@@ -514,6 +662,7 @@ void GoUctPlayer<SEARCH, THREAD>::Statistics::Clear()
     m_nuGenMove = 0;
     m_gamesPerSecond.Clear();
     m_reuse.Clear();
+    m_ponderHit.Clear();
 }
 
 template <class SEARCH, class THREAD>
@@ -537,6 +686,9 @@ void GoUctPlayer<SEARCH, THREAD>::Statistics::Write(std::ostream& out) const
     out << '\n'
         << SgWriteLabel("Reuse");
     m_reuse.Write(out);
+    out << '\n'
+        << SgWriteLabel("PonderHit");
+    m_ponderHit.Write(out);
     out << '\n';
 }
 
@@ -550,11 +702,13 @@ GoUctPlayer<SEARCH, THREAD>::GoUctPlayer(const GoBoard& bd)
       m_enablePonder(false),
       m_useRootFilter(true),
       m_reuseSubtree(true),
+      m_prepareInitTree(true),
       m_earlyPass(true),
       m_lastBoardSize(-1),
       m_maxGames(std::numeric_limits<SgUctValue>::max()),
       m_resignMinGames(5000),
       m_maxPonderTime(300),
+      m_ponderCandidates(0),
       m_search(Board(),
                new GoUctPlayoutPolicyFactory<GoUctBoard>(
                                                  m_playoutPolicyParam),
@@ -563,16 +717,20 @@ GoUctPlayer<SEARCH, THREAD>::GoUctPlayer(const GoBoard& bd)
       m_timeControl(Board()),
       m_rootFilter(new GoUctDefaultMoveFilter(Board(), m_rootFilterParam)),
       m_mpiSynchronizer(SgMpiNullSynchronizer::Create()),
-      m_writeDebugOutput(true)
+      m_writeDebugOutput(true),
+      m_initTree(0)
 {
     SetDefaultParameters(Board().Size());
     m_search.SetMpiSynchronizer(m_mpiSynchronizer);
     m_treeFilterParam.SetCheckSafety(false);
+    m_rootFilterParam.SetLadderThreads(
+                 std::max(1, int(boost::thread::hardware_concurrency())));
 }
 
 template <class SEARCH, class THREAD>
 GoUctPlayer<SEARCH, THREAD>::~GoUctPlayer()
 {
+    WaitInitTree();
 }
 
 template <class SEARCH, class THREAD>
@@ -705,22 +863,24 @@ bool GoUctPlayer<SEARCH, THREAD>::DoEarlyPassSearch(SgUctValue maxGames,
     @param maxTime
     @param isDuringPondering Hint that search is done during pondering (this
     handles the decision to discard an aborted FindInitTree differently)
+    @param stability Parameters for adjusting the time to the stability of
+    the search, 0 if not used. See SgUctStabilityParam
     @return The best move or SG_NULLMOVE if terminal position (can also
     happen, if @c isDuringPondering, no search was performed, because
     DoSearch() was aborted during FindInitTree()). */
 template <class SEARCH, class THREAD>
 SgPoint GoUctPlayer<SEARCH, THREAD>::DoSearch(SgBlackWhite toPlay, 
                                               double maxTime,
-                                              bool isDuringPondering)
+                                              bool isDuringPondering,
+                                              SgUctStabilityParam* stability)
 {
     SgUctTree* initTree = 0;
     SgTimer timer;
     double timeInitTree = 0;
     if (m_reuseSubtree)
     {
-        initTree = &m_search.GetTempTree();
         timeInitTree = -timer.GetTime();
-        FindInitTree(*initTree, toPlay, maxTime);
+        initTree = &FindInitTree(toPlay, maxTime);
         timeInitTree += timer.GetTime();
         if (isDuringPondering)
         {
@@ -744,6 +904,8 @@ SgPoint GoUctPlayer<SEARCH, THREAD>::DoSearch(SgBlackWhite toPlay,
         timeRootFilter += timer.GetTime();
     }
     maxTime -= timer.GetTime();
+    if (stability != 0)
+        stability->m_maxExtendedTime -= timer.GetTime();
     m_search.SetToPlay(toPlay);
     std::vector<SgPoint> sequence;
     SgUctEarlyAbortParam earlyAbort;
@@ -751,7 +913,7 @@ SgPoint GoUctPlayer<SEARCH, THREAD>::DoSearch(SgBlackWhite toPlay,
     earlyAbort.m_minGames = m_resignMinGames;
     earlyAbort.m_reductionFactor = 3;
     SgUctValue value = m_search.Search(m_maxGames, maxTime, sequence, rootFilter,
-                                  initTree, &earlyAbort);
+                                  initTree, &earlyAbort, stability);
 
     bool wasEarlyAbort = m_search.WasEarlyAbort();
     SgUctValue rootMoveCount = m_search.Tree().Root().MoveCount();
@@ -804,30 +966,94 @@ SgPoint GoUctPlayer<SEARCH, THREAD>::DoSearch(SgBlackWhite toPlay,
     return move;
 }
 
+/** Add to the ponder hit statistics, if the last pondering was on
+    candidates and the current position follows from it by one move.
+    See PonderCandidates() */
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::AddPonderHit()
+{
+    if (m_ponderMoves.empty())
+        return;
+    GoBoardHistory currentPosition;
+    currentPosition.SetFromBoard(Board());
+    std::vector<SgPoint> sequence;
+    if (currentPosition.IsAlternatePlayFollowUpOf(m_ponderPosition, sequence)
+        && sequence.size() == 1)
+    {
+        bool isHit = (std::find(m_ponderMoves.begin(), m_ponderMoves.end(),
+                                sequence[0]) != m_ponderMoves.end());
+        m_statistics.m_ponderHit.Add(isHit ? 1.f : 0.f);
+    }
+    m_ponderMoves.clear();
+}
+
+/** Wait for the thread started by StartInitTree() and discard the prepared
+    init tree.
+    Used if the search is accessed by other code, which could use the
+    temporary tree of the search. */
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::DiscardInitTree()
+{
+    WaitInitTree();
+    m_initTree = 0;
+}
+
 /** Find initial tree for search, if subtree reusing is enabled.
     Goes back in the tree until the node is found, the search tree is valid
     for and checks if the path of nodes corresponds to an alternating
     sequence of moves starting with the color to play of the search tree.
+    Uses the tree prepared by StartInitTree(), if it is for the current
+    position. If the search tree is already for the current position (e.g.
+    after pondering) and at most half full, it is used without copying. The
+    searches of PonderOnCandidates() always continue in the search tree,
+    because copying the whole tree for each of them would be slow and could
+    truncate or prune the subtrees of the candidates.
+    @return The init tree (the temporary tree of the search)
     @see SetReuseSubtree */
 template <class SEARCH, class THREAD>
-void GoUctPlayer<SEARCH, THREAD>::FindInitTree(SgUctTree& initTree, 
-                                               SgBlackWhite toPlay,
-                                               double maxTime)
+SgUctTree& GoUctPlayer<SEARCH, THREAD>::FindInitTree(SgBlackWhite toPlay,
+                                                     double maxTime)
 {
+    WaitInitTree();
     Board().SetToPlay(toPlay);
     GoBoardHistory currentPosition;
     currentPosition.SetFromBoard(Board());
     std::vector<SgPoint> sequence;
-    if (! currentPosition.IsAlternatePlayFollowUpOf(m_search.BoardHistory(),
-                                                    sequence))
+    const size_t oldTreeNodes = m_search.Tree().NuNodes();
+    // The searches of PonderOnCandidates() continue in the same tree, they
+    // are not counted in the reuse statistics
+    const bool isPonderTurn = (m_search.RootFocus() != SG_NULLMOVE);
+    SgUctTree* initTree;
+    if (m_initTree != 0
+        && currentPosition.IsAlternatePlayFollowUpOf(m_initTreePosition,
+                                                     sequence)
+        && sequence.empty())
+    {
+        SgDebug() << "GoUctPlayer: Using prepared subtree\n";
+        initTree = m_initTree;
+    }
+    else if (! currentPosition.IsAlternatePlayFollowUpOf(
+                                           m_search.BoardHistory(), sequence))
     {
         SgDebug() << "GoUctPlayer: No tree to reuse found\n";
-        return;
+        m_initTree = 0;
+        return m_search.GetTempTree();
     }
-    SgUctTreeUtil::ExtractSubtree(m_search.Tree(), initTree, sequence, true,
-                                  maxTime, m_search.PruneMinCount());
-    size_t initTreeNodes = initTree.NuNodes();
-    size_t oldTreeNodes = m_search.Tree().NuNodes();
+    else if (sequence.empty()
+             && (isPonderTurn || oldTreeNodes <= m_search.MaxNodes() / 2))
+    {
+        initTree = &m_search.GetTempTree();
+        m_search.SwapTree(*initTree);
+    }
+    else
+    {
+        initTree = &m_search.GetTempTree();
+        SgUctTreeUtil::ExtractSubtree(m_search.Tree(), *initTree, sequence,
+                                      true, maxTime,
+                                      m_search.PruneMinCount());
+    }
+    m_initTree = 0;
+    size_t initTreeNodes = initTree->NuNodes();
     if (oldTreeNodes > 1 && initTreeNodes >= 1)
     {
         float reuse = float(initTreeNodes) / float(oldTreeNodes);
@@ -836,33 +1062,38 @@ void GoUctPlayer<SEARCH, THREAD>::FindInitTree(SgUctTree& initTree,
                   << " nodes (" << reusePercent << "%)\n";
 
         //SgDebug() << SgWritePointList(sequence, "Sequence", false);
-        m_statistics.m_reuse.Add(reuse);
+        if (! isPonderTurn)
+            m_statistics.m_reuse.Add(reuse);
     }
     else
     {
         SgDebug() << "GoUctPlayer: Subtree to reuse has 0 nodes\n";
-        m_statistics.m_reuse.Add(0.f);
+        if (! isPonderTurn)
+            m_statistics.m_reuse.Add(0.f);
     }
 
     // Check consistency
-    if (initTree.Root().HasChildren())
+    if (initTree->Root().HasChildren())
     {
-        for (SgUctChildIterator it(initTree, initTree.Root()); it; ++it)
+        for (SgUctChildIterator it(*initTree, initTree->Root()); it; ++it)
             if (! Board().IsLegal((*it).Move()))
             {
                 SgWarning() <<
                     "GoUctPlayer: illegal move in root child of init tree\n";
-                initTree.Clear();
+                initTree->Clear();
                 // Should not happen, if no bugs
                 SG_ASSERT(false);
             }
     }
+    return *initTree;
 }
 
 template <class SEARCH, class THREAD>
 SgPoint GoUctPlayer<SEARCH, THREAD>::GenMove(const SgTimeRecord& time,
                                              SgBlackWhite toPlay)
 {
+    WaitInitTree();
+    AddPonderHit();
     ++m_statistics.m_nuGenMove;
     if (m_searchMode == GOUCT_SEARCHMODE_PLAYOUTPOLICY)
         return GenMovePlayoutPolicy(toPlay);
@@ -904,7 +1135,21 @@ SgPoint GoUctPlayer<SEARCH, THREAD>::GenMove(const SgTimeRecord& time,
         else
         {
             SG_ASSERT(m_searchMode == GOUCT_SEARCHMODE_UCT);
-            move = DoSearch(toPlay, maxTime, false);
+            SgUctStabilityParam stability;
+            const bool useStability =
+                (! m_ignoreClock && m_timeControl.StabilityControl());
+            if (useStability)
+            {
+                stability.m_minTime = m_timeControl.StableMinTime();
+                stability.m_countGap =
+                    SgUctValue(m_timeControl.StableCountGap());
+                stability.m_valueDrop =
+                    SgUctValue(m_timeControl.VolatileValueDrop());
+                stability.m_maxExtendedTime =
+                    m_timeControl.MaxExtendedTime(time, maxTime);
+            }
+            move = DoSearch(toPlay, maxTime, false,
+                            useStability ? &stability : 0);
             m_statistics.m_gamesPerSecond.Add(
                                       m_search.Statistics().m_gamesPerSecond);
         }
@@ -949,6 +1194,7 @@ std::string GoUctPlayer<SEARCH, THREAD>::Name() const
 template <class SEARCH, class THREAD>
 void GoUctPlayer<SEARCH, THREAD>::OnBoardChange()
 {
+    DiscardInitTree();
     int size = Board().Size();
     if (m_autoParam && size != m_lastBoardSize)
     {
@@ -974,19 +1220,94 @@ void GoUctPlayer<SEARCH, THREAD>::Ponder()
         return;
     }
     SgDebug() << "GoUctPlayer::Ponder: start\n";
-    DoSearch(bd.ToPlay(), m_maxPonderTime, true);
+    if (m_ponderCandidates > 0)
+        PonderOnCandidates();
+    else
+        DoSearch(bd.ToPlay(), m_maxPonderTime, true);
     SgDebug() << "GoUctPlayer::Ponder: end\n";
 }
 
+/** Ponder on the most likely moves of the opponent.
+    See PonderCandidates() */
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::PonderOnCandidates()
+{
+    // Time for searching all candidates once. The candidates are searched
+    // in short turns, because pondering is aborted at an unknown time.
+    const double roundTime = 1;
+    const SgBlackWhite toPlay = Board().ToPlay();
+    // The early pass search would replace the search tree
+    SgRestorer<bool> restorer(&m_earlyPass);
+    m_earlyPass = false;
+    SgTimer timer;
+    if (DoSearch(toPlay, std::min(roundTime, m_maxPonderTime), true)
+        == SG_NULLMOVE)
+        return;
+    typedef std::pair<SgUctValue,SgMove> Candidate;
+    std::vector<Candidate> candidates;
+    const SgUctTree& tree = m_search.Tree();
+    if (tree.Root().HasChildren())
+        for (SgUctChildIterator it(tree, tree.Root()); it; ++it)
+            if ((*it).MoveCount() > 0)
+                candidates.push_back(Candidate((*it).MoveCount(),
+                                               (*it).Move()));
+    std::sort(candidates.begin(), candidates.end(),
+              std::greater<Candidate>());
+    if (candidates.size() > static_cast<size_t>(m_ponderCandidates))
+        candidates.resize(m_ponderCandidates);
+    if (candidates.empty())
+        return;
+    SgUctValue totalCount = 0;
+    m_ponderPosition.SetFromBoard(Board());
+    m_ponderMoves.clear();
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        totalCount += candidates[i].first;
+        m_ponderMoves.push_back(candidates[i].second);
+    }
+    SgDebug() << "GoUctPlayer::Ponder: candidates "
+              << SgWritePointList(m_ponderMoves, "", false);
+    bool isRoundSearched = true;
+    while (isRoundSearched)
+    {
+        // Stop if no games were played in a round, for example, because
+        // MaxGames() is reached
+        isRoundSearched = false;
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            double maxTime = m_maxPonderTime - timer.GetTime();
+            if (maxTime <= 0 || SgUserAbort())
+            {
+                isRoundSearched = false;
+                break;
+            }
+            double time = roundTime * double(candidates[i].first / totalCount);
+            m_search.SetRootFocus(candidates[i].second);
+            if (DoSearch(toPlay, std::min(time, maxTime), true) != SG_NULLMOVE
+                && m_search.GamesPlayed() > 0)
+                isRoundSearched = true;
+        }
+    }
+    m_search.SetRootFocus(SG_NULLMOVE);
+}
+
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::OnUpdate()
+{
+    StartInitTree();
+}
+
 template <class SEARCH, class THREAD>
 GoUctSearch& GoUctPlayer<SEARCH, THREAD>::Search()
 {
+    DiscardInitTree();
     return m_search;
 }
 
 template <class SEARCH, class THREAD>
 const GoUctSearch& GoUctPlayer<SEARCH, THREAD>::Search() const
 {
+    WaitInitTree();
     return m_search;
 }
 
@@ -1026,6 +1347,48 @@ const SgDefaultTimeControl& GoUctPlayer<SEARCH, THREAD>::TimeControl() const
     return m_timeControl;
 }
 
+/** Start extracting the subtree for the current position in a background
+    thread.
+    Does nothing if the prepared tree is already for the current position or
+    if the search tree is already for the current position (FindInitTree()
+    uses it without copying then). See PrepareInitTree() */
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::StartInitTree()
+{
+    WaitInitTree();
+    if (! m_prepareInitTree || ! m_reuseSubtree
+        || m_searchMode != GOUCT_SEARCHMODE_UCT)
+        return;
+    GoBoardHistory position;
+    position.SetFromBoard(Board());
+    std::vector<SgPoint> sequence;
+    if (m_initTree != 0
+        && position.IsAlternatePlayFollowUpOf(m_initTreePosition, sequence)
+        && sequence.empty())
+        return;
+    m_initTree = 0;
+    if (! position.IsAlternatePlayFollowUpOf(m_search.BoardHistory(),
+                                             sequence)
+        || sequence.empty())
+        return;
+    m_initTreePosition = position;
+    m_initTreeThread.reset(new boost::thread(InitTreeFunction(*this,
+                                                              sequence)));
+}
+
+/** Wait for the thread started by StartInitTree() to finish.
+    Does not discard the prepared init tree, so it can be used by the const
+    accessors of the search. */
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::WaitInitTree() const
+{
+    if (m_initTreeThread)
+    {
+        m_initTreeThread->join();
+        m_initTreeThread.reset();
+    }
+}
+
 /** Verify that the move selected by DoEarlyPassSearch is viable.
     Prevent blunders from so-called neutral moves that are not. */
 template <class SEARCH, class THREAD>
@@ -16,7 +16,8 @@ using boost::io::ios_all_saver;
 GoUctPlayoutPolicyParam::GoUctPlayoutPolicyParam()
     : m_statisticsEnabled(false),
       m_useNakadeHeuristic(false),
-      m_fillboardTries(0)
+      m_fillboardTries(0),
+      m_profileInterval(0)
 {
 }
 
@@ -85,3 +86,60 @@ void GoUctPlayoutPolicyStat::Write(std::ostream& out) const
 }
 
 //----------------------------------------------------------------------------
+
+GoUctPlayoutPolicyProfile::GoUctPlayoutPolicyProfile()
+{
+    Clear();
+}
+
+void GoUctPlayoutPolicyProfile::Clear()
+{
+    m_nuSamples = 0;
+    fill(m_nuCalls.begin(), m_nuCalls.end(), 0);
+    fill(m_nuHits.begin(), m_nuHits.end(), 0);
+    fill(m_time.begin(), m_time.end(), 0.);
+}
+
+void GoUctPlayoutPolicyProfile::Merge(const GoUctPlayoutPolicyProfile& profile)
+{
+    m_nuSamples += profile.m_nuSamples;
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+    {
+        m_nuCalls[i] += profile.m_nuCalls[i];
+        m_nuHits[i] += profile.m_nuHits[i];
+        m_time[i] += profile.m_time[i];
+    }
+}
+
+void GoUctPlayoutPolicyProfile::Write(std::ostream& out) const
+{
+    ios_all_saver saver(out);
+    double totalTime = 0;
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+        totalTime += m_time[i];
+    out << SgWriteLabel("Samples") << m_nuSamples << '\n'
+        << SgWriteLabel("Time") << fixed << setprecision(3) << totalTime
+        << '\n'
+        << "Stage          Calls    Hits  HitRate  Time/call[ns] Time[%]\n";
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+    {
+        GoUctPlayoutPolicyType type = static_cast<GoUctPlayoutPolicyType>(i);
+        size_t nuCalls = m_nuCalls[type];
+        size_t nuHits = m_nuHits[type];
+        if (nuCalls == 0)
+            continue;
+        out << setw(13) << left << GoUctPlayoutPolicyTypeStr(type) << right
+            << setw(7) << nuCalls
+            << setw(8) << nuHits
+            << setw(8) << setprecision(1)
+            << 100. * double(nuHits) / double(nuCalls)
+            << '%'
+            << setw(15) << setprecision(0)
+            << 1e9 * m_time[type] / double(nuCalls)
+            << setw(8) << setprecision(1)
+            << (totalTime > 0 ? 100. * m_time[type] / totalTime : 0.)
+            << '\n';
+    }
+}
+
+//----------------------------------------------------------------------------
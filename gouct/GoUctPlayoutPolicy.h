@@ -11,6 +11,7 @@
 #include "GoEyeUtil.h"
 #include "GoUctPatterns.h"
 #include "GoUctPureRandomGenerator.h"
+#include "SgTime.h"
 
 //----------------------------------------------------------------------------
 
@@ -33,6 +34,13 @@ public:
         Default is 0 */
     int m_fillboardTries;
 
+    /** Profile every n-th move generation.
+        Collects a GoUctPlayoutPolicyProfile for a sample of the move
+        generations. Only the sampled move generations measure the time,
+        the cost for the others is a counter decrement. 0 disables
+        profiling. Default is 0 */
+    int m_profileInterval;
+
     GoUctPlayoutPolicyParam();
 };
 
@@ -93,6 +101,35 @@ struct GoUctPlayoutPolicyStat
 
 //----------------------------------------------------------------------------
 
+/** Time and hit rate of the stages of GoUctPlayoutPolicy::GenerateMove().
+    Stages are identified by the move type they generate. Collected by each
+    policy for a sample of its move generations (see
+    GoUctPlayoutPolicyParam::m_profileInterval) and merged over all threads
+    by GoUctGlobalSearch at the end of a search. */
+struct GoUctPlayoutPolicyProfile
+{
+    /** Number of profiled move generations. */
+    std::size_t m_nuSamples;
+
+    /** Number of times a stage was tried. */
+    boost::array<std::size_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_nuCalls;
+
+    /** Number of times a stage generated or corrected the move. */
+    boost::array<std::size_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_nuHits;
+
+    /** Time spent in a stage in seconds. */
+    boost::array<double,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_time;
+
+    GoUctPlayoutPolicyProfile();
+
+    void Clear();
+
+    /** Add the counts and times of another profile. */
+    void Merge(const GoUctPlayoutPolicyProfile& profile);
+
+    void Write(std::ostream& out) const;
+};
+
 /** Default playout policy for usage in GoUctGlobalSearch.
     Parametrized by the board class to make it usable with both GoBoard
     and GoUctBoard.
@@ -146,6 +183,13 @@ public:
 
     void ClearStatistics();
 
+    /** Return the profile of the move generation.
+        Only collected, if GoUctPlayoutPolicyParam::m_profileInterval is not
+        zero. */
+    const GoUctPlayoutPolicyProfile& Profile() const;
+
+    void ClearProfile();
+
     // @} // @name
 
 
@@ -229,6 +273,14 @@ private:
 
     SgBWArray<GoUctPlayoutPolicyStat> m_statistics;
 
+    GoUctPlayoutPolicyProfile m_profile;
+
+    /** Number of move generations until the next profiled one. */
+    int m_profileCountdown;
+
+    /** Start time of the currently profiled stage. */
+    double m_stageStartTime;
+
     /** Try to correct the proposed move, typically by moving it to a
         'better' point such as other liberty or neighbor.
         Examples implemented: self-ataries, clumps. */
@@ -269,6 +321,18 @@ private:
 
     /** Add statistics for most recently generated move. */
     void UpdateStatistics();
+
+    /** Check if the current move generation is profiled. */
+    bool StartProfile();
+
+    /** Start timing a stage of a profiled move generation. */
+    void StartStage(bool profile);
+
+    /** End timing a stage of a profiled move generation.
+        @param profile Whether the move generation is profiled
+        @param stage The stage
+        @param hit Whether the stage generated or corrected the move */
+    void EndStage(bool profile, GoUctPlayoutPolicyType stage, bool hit);
 };
 
 template<class BOARD>
@@ -343,11 +407,18 @@ GoUctPlayoutPolicy<BOARD>::GoUctPlayoutPolicy(const BOARD& bd,
       m_patterns(bd),
       m_checked(false),
       m_captureGenerator(bd),
-      m_pureRandomGenerator(bd, m_random)
+      m_pureRandomGenerator(bd, m_random),
+      m_profileCountdown(0)
 {
     ClearStatistics();
 }
 
+template<class BOARD>
+void GoUctPlayoutPolicy<BOARD>::ClearProfile()
+{
+    m_profile.Clear();
+}
+
 template<class BOARD>
 void GoUctPlayoutPolicy<BOARD>::ClearStatistics()
 {
@@ -383,6 +454,19 @@ void GoUctPlayoutPolicy<BOARD>::EndPlayout()
 {
 }
 
+template<class BOARD>
+inline void GoUctPlayoutPolicy<BOARD>::EndStage(bool profile,
+                                                GoUctPlayoutPolicyType stage,
+                                                bool hit)
+{
+    if (! profile)
+        return;
+    ++m_profile.m_nuCalls[stage];
+    if (hit)
+        ++m_profile.m_nuHits[stage];
+    m_profile.m_time[stage] += SgTime::Get(SG_TIME_REAL) - m_stageStartTime;
+}
+
 template<class BOARD>
 bool GoUctPlayoutPolicy<BOARD>::GenerateAtariCaptureMove()
 {
@@ -409,7 +493,7 @@ void GoUctPlayoutPolicy<BOARD>::PlayGoodLiberties(SgPoint block)
     if (! GoBoardUtil::IsSimpleChain(m_bd, block, ignoreOther))
         for (typename BOARD::LibertyIterator it(m_bd, block); it; ++it)
             if (  GoUctUtil::GainsLiberties(m_bd, block, *it)
-               && ! GoBoardUtil::SelfAtari(m_bd, *it)
+               && ! GoUctUtil::SelfAtari(m_bd, *it)
                )
                 m_moves.PushBack(*it);
 }
@@ -459,12 +543,15 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
     m_checked = false;
 
     SgPoint mv = SG_NULLMOVE;
+    const bool profile = StartProfile();
 
     if (m_param.m_fillboardTries > 0)
     {
+        StartStage(profile);
         m_moveType = GOUCT_FILLBOARD;
         mv = m_pureRandomGenerator.GenerateFillboardMove(
                                                     m_param.m_fillboardTries);
+        EndStage(profile, GOUCT_FILLBOARD, mv != SG_NULLMOVE);
     }
 
     m_lastMove = m_bd.GetLastMove();
@@ -473,57 +560,94 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
         && ! m_bd.IsEmpty(m_lastMove) // skip if move was suicide
        )
     {
-        if (m_param.m_useNakadeHeuristic && GenerateNakadeMove())
+        if (m_param.m_useNakadeHeuristic)
         {
-            m_moveType = GOUCT_NAKADE;
-            mv = SelectRandom();
+            StartStage(profile);
+            if (GenerateNakadeMove())
+            {
+                m_moveType = GOUCT_NAKADE;
+                mv = SelectRandom();
+            }
+            EndStage(profile, GOUCT_NAKADE, mv != SG_NULLMOVE);
         }
-        if (mv == SG_NULLMOVE && GenerateAtariCaptureMove())
+        if (mv == SG_NULLMOVE)
         {
-            m_moveType = GOUCT_ATARI_CAPTURE;
-            mv = SelectRandom();
+            StartStage(profile);
+            if (GenerateAtariCaptureMove())
+            {
+                m_moveType = GOUCT_ATARI_CAPTURE;
+                mv = SelectRandom();
+            }
+            EndStage(profile, GOUCT_ATARI_CAPTURE, mv != SG_NULLMOVE);
         }
-        if (mv == SG_NULLMOVE && GenerateAtariDefenseMove())
+        if (mv == SG_NULLMOVE)
         {
-            m_moveType = GOUCT_ATARI_DEFEND;
-            mv = SelectRandom();
+            StartStage(profile);
+            if (GenerateAtariDefenseMove())
+            {
+                m_moveType = GOUCT_ATARI_DEFEND;
+                mv = SelectRandom();
+            }
+            EndStage(profile, GOUCT_ATARI_DEFEND, mv != SG_NULLMOVE);
         }
-        if (mv == SG_NULLMOVE && GenerateLowLibMove(m_lastMove))
+        if (mv == SG_NULLMOVE)
         {
-            m_moveType = GOUCT_LOWLIB;
-            mv = SelectRandom();
+            StartStage(profile);
+            if (GenerateLowLibMove(m_lastMove))
+            {
+                m_moveType = GOUCT_LOWLIB;
+                mv = SelectRandom();
+            }
+            EndStage(profile, GOUCT_LOWLIB, mv != SG_NULLMOVE);
         }
-        if (mv == SG_NULLMOVE && GeneratePatternMove())
+        if (mv == SG_NULLMOVE)
         {
-            m_moveType = GOUCT_PATTERN;
-            mv = SelectRandom();
+            StartStage(profile);
+            if (GeneratePatternMove())
+            {
+                m_moveType = GOUCT_PATTERN;
+                mv = SelectRandom();
+            }
+            EndStage(profile, GOUCT_PATTERN, mv != SG_NULLMOVE);
         }
     }
     if (mv == SG_NULLMOVE)
     {
+        StartStage(profile);
         m_moveType = GOUCT_CAPTURE;
         m_captureGenerator.Generate(m_moves);
         mv = SelectRandom();
+        EndStage(profile, GOUCT_CAPTURE, mv != SG_NULLMOVE);
     }
     if (mv == SG_NULLMOVE)
     {
+        StartStage(profile);
         m_moveType = GOUCT_RANDOM;
         mv = m_pureRandomGenerator.Generate();
+        EndStage(profile, GOUCT_RANDOM, mv != SG_NULLMOVE);
     }
 
     if (mv == SG_NULLMOVE)
     {
+        StartStage(profile);
         m_moveType = GOUCT_PASS;
         mv = SG_PASS;
+        EndStage(profile, GOUCT_PASS, true);
     }
     else
     {
         SG_ASSERT(m_bd.IsLegal(mv));
+        StartStage(profile);
         m_checked = CorrectMove(GoUctUtil::DoSelfAtariCorrection, mv,
                                 GOUCT_SELFATARI_CORRECTION);
+        EndStage(profile, GOUCT_SELFATARI_CORRECTION, m_checked);
         if (USE_CLUMP_CORRECTION && ! m_checked)
-            CorrectMove(GoUctUtil::DoClumpCorrection, mv,
-                        GOUCT_CLUMP_CORRECTION);
+        {
+            StartStage(profile);
+            bool corrected = CorrectMove(GoUctUtil::DoClumpCorrection, mv,
+                                         GOUCT_CLUMP_CORRECTION);
+            EndStage(profile, GOUCT_CLUMP_CORRECTION, corrected);
+        }
     }
     SG_ASSERT(m_bd.IsLegal(mv));
     SG_ASSERT(mv == SG_PASS || ! m_bd.IsSuicide(mv));
@@ -633,7 +757,7 @@ inline void GoUctPlayoutPolicy<BOARD>::GeneratePatternMove(SgPoint p)
 {
     if (m_bd.IsEmpty(p)
         && m_patterns.MatchAny(p)
-        && ! GoBoardUtil::SelfAtari(m_bd, p))
+        && ! GoUctUtil::SelfAtari(m_bd, p))
         m_moves.PushBack(p);
 }
 
@@ -644,7 +768,7 @@ inline void GoUctPlayoutPolicy<BOARD>::GeneratePatternMove2(SgPoint p,
     if (m_bd.IsEmpty(p)
         && ! SgPointUtil::In8Neighborhood(lastMove, p)
         && m_patterns.MatchAny(p)
-        && ! GoBoardUtil::SelfAtari(m_bd, p))
+        && ! GoUctUtil::SelfAtari(m_bd, p))
         m_moves.PushBack(p);
 }
 
@@ -693,6 +817,13 @@ const GoUctPatterns<BOARD>& GoUctPlayoutPolicy<BOARD>::Patterns()
     return m_patterns;
 }
 
+template<class BOARD>
+inline const GoUctPlayoutPolicyProfile& GoUctPlayoutPolicy<BOARD>::Profile()
+    const
+{
+    return m_profile;
+}
+
 template<class BOARD>
 inline SgPoint GoUctPlayoutPolicy<BOARD>::SelectRandom()
 {
@@ -714,6 +845,23 @@ GoUctPlayoutPolicy<BOARD>::Statistics(SgBlackWhite color) const
     return m_statistics[color];
 }
 
+template<class BOARD>
+inline bool GoUctPlayoutPolicy<BOARD>::StartProfile()
+{
+    if (m_param.m_profileInterval <= 0 || --m_profileCountdown > 0)
+        return false;
+    m_profileCountdown = m_param.m_profileInterval;
+    ++m_profile.m_nuSamples;
+    return true;
+}
+
+template<class BOARD>
+inline void GoUctPlayoutPolicy<BOARD>::StartStage(bool profile)
+{
+    if (profile)
+        m_stageStartTime = SgTime::Get(SG_TIME_REAL);
+}
+
 template<class BOARD>
 void GoUctPlayoutPolicy<BOARD>::StartPlayout()
 {
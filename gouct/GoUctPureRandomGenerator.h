@@ -7,6 +7,7 @@
 
 #include <vector>
 #include "GoBoard.h"
+#include "GoUctSizedKernel.h"
 #include "GoUctUtil.h"
 #include "SgWrite.h"
 
@@ -66,6 +67,21 @@ public:
     SgPoint GenerateFillboardMove(int numberTries);
 
 private:
+    /** Inserts the empty points found by GoUctSizedKernel::ForEachEmpty. */
+    struct InsertFunction
+    {
+        GoUctPureRandomGenerator& m_generator;
+
+        InsertFunction(GoUctPureRandomGenerator& generator)
+            : m_generator(generator)
+        { }
+
+        void operator()(SgPoint p)
+        {
+            m_generator.Insert(p);
+        }
+    };
+
     const BOARD& m_bd;
 
     float m_invNuPoints;
@@ -244,14 +260,12 @@ inline void GoUctPureRandomGenerator<BOARD>::Insert(SgPoint p)
 template<class BOARD>
 inline void GoUctPureRandomGenerator<BOARD>::Start()
 {
-    m_nuEmptyFloat = 0;
     m_candidates.clear();
-    for (typename BOARD::Iterator it(m_bd); it; ++it)
-        if (m_bd.IsEmpty(*it))
-        {
-            Insert(*it);
-            m_nuEmptyFloat += 1.f;
-        }
+    InsertFunction insert(*this);
+    GoUctSizedKernelUtil::ForEachEmpty(
+                          GoUctSizedKernelUtil::KernelSize(m_bd.Size()),
+                          m_bd, insert);
+    m_nuEmptyFloat = float(m_candidates.size());
     m_invNuPoints = 1.f / float(m_bd.Size() * m_bd.Size());
     CheckConsistency();
 }
@@ -99,9 +99,10 @@ GoUctState::GoUctState(unsigned int threadId, const GoBoard& bd)
     : SgUctThreadState(threadId, MOVERANGE),
       m_assertionHandler(*this),
       m_uctBd(bd),
-      m_synchronizer(bd)
+      m_searchBd(bd),
+      m_nuBdMoves(0)
 {
-    m_synchronizer.SetSubscriber(m_bd);
+    m_uctBd.EnableUndo(true);
     m_isInPlayout = false;
 }
 
@@ -109,21 +110,16 @@ void GoUctState::Dump(ostream& out) const
 {
     out << "GoUctState[" << m_threadId << "] ";
     if (m_isInPlayout)
-        out << "playout board:\n" << m_uctBd;
-    else
-        out << "board:\n" << m_bd;
+        out << "playout ";
+    out << "board:\n" << m_uctBd;
 }
 
 void GoUctState::Execute(SgMove move)
 {
     SG_ASSERT(! m_isInPlayout);
-    SG_ASSERT(move == SG_PASS || ! m_bd.Occupied(move));
-    // Temporarily switch ko rule to SIMPLEKO to avoid slow full board
-    // repetition test in GoBoard::Play()
-    GoRestoreKoRule restoreKoRule(m_bd);
-    m_bd.Rules().SetKoRule(GoRules::SIMPLEKO);
-    m_bd.Play(move);
-    SG_ASSERT(! m_bd.LastMoveInfo(GO_MOVEFLAG_ILLEGAL));
+    SG_ASSERT(move == SG_PASS || ! m_uctBd.Occupied(move));
+    m_uctBd.Play(move);
+    m_inTreeMoves.push_back(move);
     ++m_gameLength;
 }
 
@@ -141,11 +137,6 @@ void GoUctState::GameStart()
     m_gameLength = 0;
 }
 
-void GoUctState::StartPlayout()
-{
-    m_uctBd.Init(m_bd);
-}
-
 void GoUctState::StartPlayouts()
 {
     m_isInPlayout = true;
@@ -153,17 +144,42 @@ void GoUctState::StartPlayouts()
 
 void GoUctState::StartSearch()
 {
-    m_synchronizer.UpdateSubscriber();
+    m_bd.Init(m_searchBd);
+    m_uctBd.Init(m_bd);
+    m_inTreeMoves.clear();
+    m_nuBdMoves = 0;
+}
+
+void GoUctState::SyncBoard()
+{
+    SG_ASSERT(! m_isInPlayout);
+    if (m_nuBdMoves == m_inTreeMoves.size())
+        return;
+    // Temporarily switch ko rule to SIMPLEKO to avoid slow full board
+    // repetition test in GoBoard::Play()
+    GoRestoreKoRule restoreKoRule(m_bd);
+    m_bd.Rules().SetKoRule(GoRules::SIMPLEKO);
+    for ( ; m_nuBdMoves < m_inTreeMoves.size(); ++m_nuBdMoves)
+    {
+        m_bd.Play(m_inTreeMoves[m_nuBdMoves]);
+        SG_ASSERT(! m_bd.LastMoveInfo(GO_MOVEFLAG_ILLEGAL));
+    }
 }
 
 void GoUctState::TakeBackInTree(std::size_t nuMoves)
 {
+    SG_ASSERT(nuMoves <= m_inTreeMoves.size());
     for (size_t i = 0; i < nuMoves; ++i)
+        m_uctBd.Undo();
+    m_inTreeMoves.resize(m_inTreeMoves.size() - nuMoves);
+    for ( ; m_nuBdMoves > m_inTreeMoves.size(); --m_nuBdMoves)
         m_bd.Undo();
 }
 
 void GoUctState::TakeBackPlayout(std::size_t nuMoves)
 {
+    for (size_t i = 0; i < nuMoves; ++i)
+        m_uctBd.Undo();
     m_gameLength -= nuMoves;
 }
 
@@ -6,9 +6,9 @@
 #define GOUCT_SEARCH_H
 
 #include <iosfwd>
+#include <vector>
 #include "GoBoard.h"
 #include "GoBoardHistory.h"
-#include "GoBoardSynchronizer.h"
 #include "GoUctBoard.h"
 #include "SgUctSearch.h"
 #include "SgBlackWhite.h"
@@ -27,16 +27,21 @@ public:
         @param threadId The number of the thread. Needed for passing to
         constructor of SgUctThreadState.
         @param bd The board with the current position. The state has is own
-        board that will be synchronized with the currently searched position
+        board that will be set to a copy of the currently searched position
         in StartSearch() */
     GoUctState(unsigned int threadId, const GoBoard& bd);
 
     /** @name Pure virtual functions of SgUctThreadState */
     // @{
 
+    /** Copy the searched position to the boards.
+        Uses GoBoard::Init(const GoBoard&), which copies the move history
+        in one pass instead of replaying the moves of the game. */
     void StartSearch();
 
-    /** Implementation of SgUctSearch::Execute */
+    /** Implementation of SgUctSearch::Execute.
+        Plays the move only on the playout board. The move is played on the
+        in-tree board by the next call of SyncBoard(). */
     void Execute(SgMove move);
 
     /** Implementation of SgUctSearch::ExecutePlayout */
@@ -44,6 +49,9 @@ public:
 
     void TakeBackInTree(std::size_t nuMoves);
 
+    /** Take back the moves of a playout with GoUctBoard::Undo().
+        The next playout of the same game starts from the position at the
+        end of the in-tree phase again. */
     void TakeBackPlayout(std::size_t nuMoves);
 
     // @} // @name
@@ -54,18 +62,21 @@ public:
 
     void GameStart();
 
-    void StartPlayout();
-
     void StartPlayouts();
 
     // @} // @name
 
-    /** Board used during in-tree phase. */
+    /** Board with the position of the in-tree phase.
+        Contains the current position only after SyncBoard(). */
     const GoBoard& Board() const;
 
-    /** Board used during playout phase. */
+    /** Board used during in-tree and playout phase. */
     const GoUctBoard& UctBoard() const;
 
+    /** Play the in-tree moves that were not played yet on Board().
+        Needs to be called before using Board() in the in-tree phase. */
+    void SyncBoard();
+
     bool IsInPlayout() const;
 
     /** Length of the current game from the root position of the search. */
@@ -89,18 +100,32 @@ private:
 
     AssertionHandler m_assertionHandler;
 
-    /** Board used for in-tree phase. */
+    /** Board used for the move generation in the in-tree phase.
+        Follows the in-tree moves only in SyncBoard(). The move generation
+        for expanding a node uses GoBoard: the legal moves with the ko rule
+        of the game (GoBoard::AllLegal()), the move history, the tree
+        filter and the prior and feature knowledge. Most in-tree moves are
+        played on nodes that are not expanded in this game, which only need
+        the terminal position check on m_uctBd. */
     GoBoard m_bd;
 
-    /** Board used for playout phase. */
+    /** Board used for in-tree and playout phase.
+        Records the moves for GoUctBoard::Undo(). */
     GoUctBoard m_uctBd;
 
-    GoBoardSynchronizer m_synchronizer;
+    /** The board with the currently searched position. */
+    const GoBoard& m_searchBd;
 
     bool m_isInPlayout;
 
     /** See GameLength() */
     std::size_t m_gameLength;
+
+    /** Moves played in the in-tree phase of the current game. */
+    std::vector<SgMove> m_inTreeMoves;
+
+    /** Number of moves of m_inTreeMoves already played on m_bd. */
+    std::size_t m_nuBdMoves;
 };
 
 inline const GoBoard& GoUctState::Board() const
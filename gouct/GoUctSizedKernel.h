@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------------
+/** @file GoUctSizedKernel.h
+    Full-board loops of the playout phase specialized on the board size. */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_SIZEDKERNEL_H
+#define GOUCT_SIZEDKERNEL_H
+
+#include "GoBoardUtil.h"
+#include "SgBWSet.h"
+#include "SgPoint.h"
+#include "SgPointArray.h"
+
+//----------------------------------------------------------------------------
+
+/** Full-board loops used once per playout, with the board size as a
+    compile-time constant.
+    The generic versions iterate over the point list of SgBoardConst, which
+    needs a load and a test for the end marker per point. Here the row and
+    column bounds are constants, so the compiler can unroll the inner loop
+    and compute the points from the constant stride SG_NS.
+    Only the board sizes that are played almost exclusively (9, 13, 19) are
+    instantiated; see GoUctSizedKernelUtil::IsSpecialized(). The point
+    layout is still the one of SgPoint (arrays of size SG_MAXPOINT), so the
+    kernels work with any board class that provides the GoBoard interface.
+    @tparam SIZE The board size */
+template<int SIZE>
+class GoUctSizedKernel
+{
+public:
+    /** Number of points on the board. */
+    static const int NU_POINTS = SIZE * SIZE;
+
+    /** Specialized version of GoBoardUtil::ScoreSimpleEndPosition(). */
+    template<class BOARD>
+    static float ScoreSimpleEndPosition(const BOARD& bd, float komi,
+                                  const SgBWSet& safe, bool noCheck,
+                                  SgPointArray<SgEmptyBlackWhite>* scoreBoard);
+
+    /** Call f(p) for each empty point of the board in board iterator
+        order. */
+    template<class BOARD, class FUNCTION>
+    static void ForEachEmpty(const BOARD& bd, FUNCTION& f);
+};
+
+template<int SIZE>
+template<class BOARD, class FUNCTION>
+inline void GoUctSizedKernel<SIZE>::ForEachEmpty(const BOARD& bd,
+                                                 FUNCTION& f)
+{
+    for (int row = 1; row <= SIZE; ++row)
+    {
+        const SgPoint rowStart = SG_NS * row;
+        for (int col = 1; col <= SIZE; ++col)
+            if (bd.IsEmpty(rowStart + col))
+                f(rowStart + col);
+    }
+}
+
+template<int SIZE>
+template<class BOARD>
+float GoUctSizedKernel<SIZE>::ScoreSimpleEndPosition(const BOARD& bd,
+                                  float komi, const SgBWSet& safe,
+                                  bool noCheck,
+                                  SgPointArray<SgEmptyBlackWhite>* scoreBoard)
+{
+    SG_ASSERT(bd.Size() == SIZE);
+    int score = 0;
+    for (int row = 1; row <= SIZE; ++row)
+    {
+        const SgPoint rowStart = SG_NS * row;
+        for (int col = 1; col <= SIZE; ++col)
+        {
+            const SgPoint p = rowStart + col;
+            SgEmptyBlackWhite c;
+            if (safe[SG_BLACK].Contains(p))
+                c = SG_BLACK;
+            else if (safe[SG_WHITE].Contains(p))
+                c = SG_WHITE;
+            else
+                c = GoBoardUtil::ScorePoint(bd, p, noCheck);
+            if (c == SG_BLACK)
+                ++score;
+            else if (c == SG_WHITE)
+                --score;
+            if (scoreBoard != 0)
+                (*scoreBoard)[p] = c;
+        }
+    }
+    return float(score) - komi;
+}
+
+//----------------------------------------------------------------------------
+
+/** Dispatch from the run-time board size to GoUctSizedKernel. */
+namespace GoUctSizedKernelUtil
+{
+    /** Check if a specialized kernel exists for a board size.
+        Sizes larger than SG_MAX_SIZE are never specialized, so that builds
+        with a smaller maximum board size do not use them. */
+    inline bool IsSpecialized(int size)
+    {
+        return (size == 9 || size == 13 || size == 19) && size <= SG_MAX_SIZE;
+    }
+
+    /** Score with the kernel for the board size or with the generic
+        GoBoardUtil::ScoreSimpleEndPosition() for other sizes.
+        @param size The kernel size as returned by KernelSize() */
+    template<class BOARD>
+    float ScoreSimpleEndPosition(int size, const BOARD& bd, float komi,
+                                 const SgBWSet& safe, bool noCheck,
+                                 SgPointArray<SgEmptyBlackWhite>* scoreBoard);
+
+    /** Return the board size if it has a specialized kernel, 0 otherwise. */
+    inline int KernelSize(int size)
+    {
+        return IsSpecialized(size) ? size : 0;
+    }
+
+    /** See GoUctSizedKernel::ForEachEmpty() */
+    template<class BOARD, class FUNCTION>
+    void ForEachEmpty(int size, const BOARD& bd, FUNCTION& f);
+}
+
+template<class BOARD>
+inline float GoUctSizedKernelUtil::ScoreSimpleEndPosition(int size,
+                                  const BOARD& bd, float komi,
+                                  const SgBWSet& safe, bool noCheck,
+                                  SgPointArray<SgEmptyBlackWhite>* scoreBoard)
+{
+    switch (size)
+    {
+    case 9:
+        return GoUctSizedKernel<9>::ScoreSimpleEndPosition(bd, komi, safe,
+                                                           noCheck,
+                                                           scoreBoard);
+    case 13:
+        return GoUctSizedKernel<13>::ScoreSimpleEndPosition(bd, komi, safe,
+                                                            noCheck,
+                                                            scoreBoard);
+    case 19:
+        return GoUctSizedKernel<19>::ScoreSimpleEndPosition(bd, komi, safe,
+                                                            noCheck,
+                                                            scoreBoard);
+    default:
+        return GoBoardUtil::ScoreSimpleEndPosition(bd, komi, safe, noCheck,
+                                                   scoreBoard);
+    }
+}
+
+template<class BOARD, class FUNCTION>
+inline void GoUctSizedKernelUtil::ForEachEmpty(int size, const BOARD& bd,
+                                               FUNCTION& f)
+{
+    switch (size)
+    {
+    case 9:
+        GoUctSizedKernel<9>::ForEachEmpty(bd, f);
+        break;
+    case 13:
+        GoUctSizedKernel<13>::ForEachEmpty(bd, f);
+        break;
+    case 19:
+        GoUctSizedKernel<19>::ForEachEmpty(bd, f);
+        break;
+    default:
+        for (typename BOARD::Iterator it(bd); it; ++it)
+            if (bd.IsEmpty(*it))
+                f(*it);
+        break;
+    }
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_SIZEDKERNEL_H
@@ -213,6 +213,26 @@ void GoUctUtil::GfxTerritoryStatistics(
     out << '\n';
 }
 
+bool GoUctUtil::IsSettledPosition(const GoUctBoard& bd)
+{
+    if (bd.NumOpenPoints() > 0)
+        return false;
+    for (GoUctBoard::Iterator it(bd); it; ++it)
+    {
+        const SgPoint p = *it;
+        if (! bd.Occupied(p) || bd.Anchor(p) != p)
+            continue;
+        const SgBlackWhite opp = SgOppBW(bd.GetStone(p));
+        int nuEyes = 0;
+        for (GoUctBoard::LibertyIterator lib(bd, p); lib; ++lib)
+            if (bd.NumNeighbors(*lib, opp) == 0 && ++nuEyes >= 2)
+                break;
+        if (nuEyes < 2)
+            return false;
+    }
+    return true;
+}
+
 void GoUctUtil::SaveTree(const SgUctTree& tree, int boardSize,
                          const SgBWSet& stones, SgBlackWhite toPlay,
                          ostream& out, int maxDepth)
@@ -174,6 +174,35 @@ namespace GoUctUtil
     /** selfatari of a larger number of stones and also atari on opponent. */
     template<class BOARD>
     bool IsMutualAtari(const BOARD& bd, SgPoint p, SgBlackWhite toPlay);
+
+    /** Check if the final score of a playout position is already known.
+        True if all empty points are single point regions and each block has
+        at least two liberties that are empty points adjacent only to stones
+        of the block's color. No block can then be captured, as long as no
+        player fills its own single point eyes (which is the assumption of
+        GoBoardUtil::ScoreSimpleEndPosition()). The remaining dame points are
+        filled alternately in a finished playout, see
+        ScoreSettledPosition(). Cheap if GoUctBoard::NumOpenPoints() is not
+        zero, which is the common case. */
+    bool IsSettledPosition(const GoUctBoard& bd);
+
+    /** Score a position for which IsSettledPosition() is true.
+        Returns the score that a finished playout would reach. Each dame
+        point (an empty point adjacent to stones of both colors) can be
+        filled by both players without creating a self-atari, so the players
+        fill them alternately: the color to play gets ceil(d/2) and the
+        opponent floor(d/2) of the d dame points. The other points are
+        scored as in GoBoardUtil::ScoreSimpleEndPosition().
+        @param bd
+        @param komi
+        @param safe
+        @param scoreBoard Optional board to fill in the status of each point
+        (SG_EMPTY for the dame points); null if not needed
+        @return Score including komi, positive for black. */
+    template<class BOARD>
+    float ScoreSettledPosition(const BOARD& bd, float komi,
+                               const SgBWSet& safe,
+                               SgPointArray<SgEmptyBlackWhite>* scoreBoard);
                                  
     /** Save tree contained in a search as a Go SGF file.
         The SGF file is written directly without using SgGameWriter to avoid
@@ -188,6 +217,20 @@ namespace GoUctUtil
     void SaveTree(const SgUctTree& tree, int boardSize, const SgBWSet& stones,
                   SgBlackWhite toPlay, std::ostream& out, int maxDepth = -1);
 
+    /** Check if playing at p is a self-atari for the color to play.
+        Same as GoBoardUtil::SelfAtari(). The overload for GoUctBoard uses
+        the cached results of GoUctBoard::SelfAtari(). */
+    template<class BOARD>
+    bool SelfAtari(const BOARD& bd, SgPoint p);
+
+    bool SelfAtari(const GoUctBoard& bd, SgPoint p);
+
+    /** See SelfAtari() */
+    template<class BOARD>
+    bool SelfAtariForColor(const BOARD& bd, SgPoint p, SgBlackWhite c);
+
+    bool SelfAtariForColor(const GoUctBoard& bd, SgPoint p, SgBlackWhite c);
+
     /** Select a random move from a list of empty points.
         The check if GeneratePoint() returns true for the point is done after
         the random selection to avoid calling this function for every point in
@@ -223,6 +266,30 @@ namespace GoUctUtil
 
 //----------------------------------------------------------------------------
 
+template<class BOARD>
+inline bool GoUctUtil::SelfAtari(const BOARD& bd, SgPoint p)
+{
+    return GoBoardUtil::SelfAtari(bd, p);
+}
+
+inline bool GoUctUtil::SelfAtari(const GoUctBoard& bd, SgPoint p)
+{
+    return bd.SelfAtari(p, bd.ToPlay());
+}
+
+template<class BOARD>
+inline bool GoUctUtil::SelfAtariForColor(const BOARD& bd, SgPoint p,
+                                         SgBlackWhite c)
+{
+    return GoBoardUtil::SelfAtariForColor(bd, p, c);
+}
+
+inline bool GoUctUtil::SelfAtariForColor(const GoUctBoard& bd, SgPoint p,
+                                         SgBlackWhite c)
+{
+    return bd.SelfAtari(p, c);
+}
+
 template<class BOARD>
 bool GoUctUtil::DoClumpCorrection(const BOARD& bd, SgPoint& p)
 {
@@ -253,7 +320,7 @@ bool GoUctUtil::DoClumpCorrection(const BOARD& bd, SgPoint& p)
         && bd.NumNeighbors(nb, toPlay) <= bd.NumNeighbors(p, toPlay)
         &&
            (   bd.NumEmptyNeighbors(nb) >= 2
-            || ! GoBoardUtil::SelfAtari(bd, nb)
+            || ! SelfAtari(bd, nb)
            )
        )
     {
@@ -292,7 +359,7 @@ inline bool GoUctUtil::DoSelfAtariCorrection(const BOARD& bd, SgPoint& p)
         return false;
     if (bd.NumNeighbors(p, toPlay) > 0) // p part of existing block(s)
     {
-        if (! GoBoardUtil::SelfAtari(bd, p))
+        if (! SelfAtari(bd, p))
             return false;
         SgBlackWhite opp = SgOppBW(toPlay);
         SgPoint replaceMove = SG_NULLMOVE;
@@ -318,7 +385,7 @@ inline bool GoUctUtil::DoSelfAtariCorrection(const BOARD& bd, SgPoint& p)
         }
         SG_ASSERT(replaceMove != SG_NULLMOVE);
         if (   bd.IsLegal(replaceMove)
-            && ! GoBoardUtil::SelfAtari(bd, replaceMove)
+            && ! SelfAtari(bd, replaceMove)
             )
         {
             p = replaceMove;
@@ -383,7 +450,8 @@ inline bool GoUctUtil::IsMutualAtari(const BOARD& bd,
                                      SgPoint p, SgBlackWhite toPlay)
 {
     int nuStones = 0;
-    if (   GoBoardUtil::SelfAtari(bd, p, nuStones)
+    if (   SelfAtari(bd, p) // cheap filter for GoUctBoard
+        && GoBoardUtil::SelfAtari(bd, p, nuStones)
         && nuStones > MUTUAL_ATARI_LIMIT
         && (   nuStones > GoEyeUtil::NAKADE_LIMIT
             || ! GoEyeUtil::MakesNakadeShape(bd, p, toPlay)
@@ -394,7 +462,7 @@ inline bool GoUctUtil::IsMutualAtari(const BOARD& bd,
         SgBlackWhite opp = SgOppBW(toPlay);
         bool selfatari =
                 bd.HasNeighbors(p, opp) &&
-                GoBoardUtil::SelfAtariForColor(bd, p, opp);
+                SelfAtariForColor(bd, p, opp);
         if (selfatari)
             return true;
     }
@@ -451,6 +519,29 @@ inline SgPoint GoUctUtil::SelectRandom(const BOARD& bd,
     return SG_NULLMOVE;
 }
 
+template<class BOARD>
+float GoUctUtil::ScoreSettledPosition(const BOARD& bd, float komi,
+                                  const SgBWSet& safe,
+                                  SgPointArray<SgEmptyBlackWhite>* scoreBoard)
+{
+    float score =
+        GoBoardUtil::ScoreSimpleEndPosition(bd, komi, safe, true, scoreBoard);
+    int nuDame = 0;
+    for (typename BOARD::Iterator it(bd); it; ++it)
+        if (  bd.IsEmpty(*it)
+           && ! safe.OneContains(*it)
+           && bd.NumNeighbors(*it, SG_BLACK) > 0
+           && bd.NumNeighbors(*it, SG_WHITE) > 0)
+            ++nuDame;
+    const int nuToPlay = (nuDame + 1) / 2;
+    const int nuOpp = nuDame / 2;
+    if (bd.ToPlay() == SG_BLACK)
+        score += float(nuToPlay - nuOpp);
+    else
+        score -= float(nuToPlay - nuOpp);
+    return score;
+}
+
 template<class BOARD>
 void GoUctUtil::SetEdgeCorrection(const BOARD& bd, SgPoint p,
                                   int& edgeCorrection)
@@ -5,7 +5,10 @@
 
 #include "SgSystem.h"
 
+#include <vector>
 #include <boost/test/auto_unit_test.hpp>
+#include "GoBoardUtil.h"
+#include "GoTestUtil.h"
 #include "GoUctBoard.h"
 
 using namespace std;
@@ -15,6 +18,45 @@ using SgPointUtil::Pt;
 
 namespace {
 
+/** Check that two boards are in exactly the same state.
+    Compares also the order of the stones and liberties of the blocks,
+    which influences the moves generated by the playout policy. */
+void GoUctBoardTest_CheckSame(const GoUctBoard& bd1, const GoUctBoard& bd2)
+{
+    BOOST_REQUIRE_EQUAL(bd1.ToPlay(), bd2.ToPlay());
+    BOOST_CHECK_EQUAL(bd1.GetLastMove(), bd2.GetLastMove());
+    BOOST_CHECK_EQUAL(bd1.Get2ndLastMove(), bd2.Get2ndLastMove());
+    BOOST_CHECK_EQUAL(bd1.NumOpenPoints(), bd2.NumOpenPoints());
+    BOOST_CHECK_EQUAL(bd1.NumPrisoners(SG_BLACK), bd2.NumPrisoners(SG_BLACK));
+    BOOST_CHECK_EQUAL(bd1.NumPrisoners(SG_WHITE), bd2.NumPrisoners(SG_WHITE));
+    BOOST_CHECK(bd1.GetHashCode() == bd2.GetHashCode());
+    for (GoUctBoard::Iterator it(bd1); it; ++it)
+    {
+        SgPoint p = *it;
+        BOOST_REQUIRE_EQUAL(bd1.GetColor(p), bd2.GetColor(p));
+        if (bd1.IsEmpty(p))
+        {
+            BOOST_CHECK_EQUAL(bd1.IsLegal(p), bd2.IsLegal(p));
+            continue;
+        }
+        BOOST_CHECK_EQUAL(bd1.Anchor(p), bd2.Anchor(p));
+        vector<SgPoint> stones1;
+        vector<SgPoint> stones2;
+        for (GoUctBoard::StoneIterator it2(bd1, p); it2; ++it2)
+            stones1.push_back(*it2);
+        for (GoUctBoard::StoneIterator it2(bd2, p); it2; ++it2)
+            stones2.push_back(*it2);
+        BOOST_CHECK(stones1 == stones2);
+        vector<SgPoint> libs1;
+        vector<SgPoint> libs2;
+        for (GoUctBoard::LibertyIterator it2(bd1, p); it2; ++it2)
+            libs1.push_back(*it2);
+        for (GoUctBoard::LibertyIterator it2(bd2, p); it2; ++it2)
+            libs2.push_back(*it2);
+        BOOST_CHECK(libs1 == libs2);
+    }
+}
+
 /** Copied and adapted from GoBoardTest_GetLastMove.
     Parts removed that use Undo() */
 BOOST_AUTO_TEST_CASE(GoUctBoardTest_GetLastMove)
@@ -51,6 +93,216 @@ BOOST_AUTO_TEST_CASE(GoUctBoardTest_IsLibertyOfBlock)
     BOOST_CHECK(! bd.IsLibertyOfBlock(Pt(2, 3), bd.Anchor(Pt(1, 2))));
 }
 
+/** Test GoUctBoard::Init(const GoUctBoard&) */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_InitFromUctBoard)
+{
+    // 3 . . .
+    // 2 X O .
+    // 1 . X O
+    //   A B C
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 2));
+    setup.AddBlack(Pt(2, 1));
+    setup.AddWhite(Pt(2, 2));
+    setup.AddWhite(Pt(3, 1));
+    setup.m_player = SG_WHITE;
+    GoBoard board(9, setup);
+    GoUctBoard bd1(board);
+    bd1.Play(Pt(1, 1)); // captures B1
+    GoBoard emptyBoard(13);
+    GoUctBoard bd2(emptyBoard);
+    bd2.Init(bd1);
+    BOOST_CHECK_EQUAL(bd2.Size(), 9);
+    BOOST_CHECK_EQUAL(bd2.ToPlay(), bd1.ToPlay());
+    BOOST_CHECK_EQUAL(bd2.GetLastMove(), Pt(1, 1));
+    for (GoUctBoard::Iterator it(bd1); it; ++it)
+    {
+        SgPoint p = *it;
+        BOOST_CHECK_EQUAL(bd2.GetColor(p), bd1.GetColor(p));
+        if (bd1.Occupied(p))
+        {
+            BOOST_CHECK_EQUAL(bd2.Anchor(p), bd1.Anchor(p));
+            BOOST_CHECK_EQUAL(bd2.NumLiberties(p), bd1.NumLiberties(p));
+            BOOST_CHECK_EQUAL(bd2.NumStones(p), bd1.NumStones(p));
+        }
+    }
+    // Boards are independent after the copy
+    bd2.Play(Pt(3, 2));
+    BOOST_CHECK(bd1.IsEmpty(Pt(3, 2)));
+    BOOST_CHECK_EQUAL(bd2.NumLiberties(Pt(2, 2)),
+                      bd1.NumLiberties(Pt(2, 2)) - 1);
+}
+
+/** Test that GoUctBoard::NumOpenPoints is updated after moves and
+    captures. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_NumOpenPoints)
+{
+    GoBoard board(3);
+    GoUctBoard bd(board);
+    BOOST_CHECK_EQUAL(bd.NumOpenPoints(), 9);
+    bd.Play(Pt(1, 2)); // B
+    BOOST_CHECK_EQUAL(bd.NumOpenPoints(), 8);
+    bd.Play(Pt(1, 1)); // W
+    BOOST_CHECK_EQUAL(bd.NumOpenPoints(), 7);
+    bd.Play(Pt(2, 1)); // B captures A1
+    // Empty: A1 (no empty neighbor), A3, B2, B3, C1, C2, C3
+    BOOST_CHECK(bd.IsEmpty(Pt(1, 1)));
+    BOOST_CHECK_EQUAL(bd.NumOpenPoints(), 6);
+    bd.Play(Pt(2, 2)); // W
+    BOOST_CHECK_EQUAL(bd.NumOpenPoints(), 5);
+}
+
+/** Compare GoUctBoard with GoBoard in pseudo-random games.
+    Both boards use GoBoardKernel for updating blocks, GoBoard with undo and
+    GoUctBoard without undo; the blocks must be the same. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_SameAsGoBoard)
+{
+    GoTestUtil::Random random;
+    for (int game = 0; game < 20; ++game)
+    {
+        GoBoard board(7);
+        GoUctBoard bd(board);
+        for (int move = 0; move < 150; ++move)
+        {
+            for (GoUctBoard::Iterator it(bd); it; ++it)
+            {
+                SgPoint p = *it;
+                BOOST_REQUIRE_EQUAL(bd.GetColor(p), board.GetColor(p));
+                if (bd.Occupied(p))
+                {
+                    BOOST_CHECK_EQUAL(bd.NumStones(p), board.NumStones(p));
+                    BOOST_CHECK_EQUAL(bd.NumLiberties(p),
+                                      board.NumLiberties(p));
+                    SgPoint anchor = board.Anchor(bd.Anchor(p));
+                    BOOST_CHECK(board.IsInBlock(p, anchor));
+                }
+            }
+            BOOST_CHECK_EQUAL(bd.NumPrisoners(SG_BLACK),
+                              board.NumPrisoners(SG_BLACK));
+            BOOST_CHECK_EQUAL(bd.NumPrisoners(SG_WHITE),
+                              board.NumPrisoners(SG_WHITE));
+            SgPoint p = GoTestUtil::RandomMove(bd, random);
+            if (p == SG_PASS)
+                break;
+            bd.Play(p);
+            board.Play(p);
+        }
+        // Undo in GoBoard restores the merged blocks
+        while (board.MoveNumber() > 0)
+            board.Undo();
+        for (GoBoard::Iterator it(board); it; ++it)
+            BOOST_CHECK(board.IsEmpty(*it));
+    }
+}
+
+/** Test GoUctBoard::GetHashCode() after captures and undo. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_GetHashCode)
+{
+    // 2 . . .
+    // 1 X O .
+    //   A B C
+    GoSetup setup;
+    setup.AddBlack(Pt(1, 1));
+    setup.AddWhite(Pt(2, 1));
+    setup.m_player = SG_WHITE;
+    GoBoard board(9, setup);
+    GoUctBoard bd(board);
+    bd.EnableUndo(true);
+    // Same code as GoBoard for positions without captures
+    BOOST_CHECK(bd.GetHashCode() == board.GetHashCode());
+    bd.Play(Pt(1, 2)); // captures A1
+    BOOST_CHECK_EQUAL(bd.NuCapturedStones(), 1);
+    GoSetup setup2;
+    setup2.AddWhite(Pt(2, 1));
+    setup2.AddWhite(Pt(1, 2));
+    GoBoard board2(9, setup2);
+    GoUctBoard bd2(board2);
+    BOOST_CHECK(bd.GetHashCode() == bd2.GetHashCode());
+    bd.Play(Pt(5, 5));
+    BOOST_CHECK(bd.GetHashCode() != bd2.GetHashCode());
+    bd.Undo();
+    BOOST_CHECK(bd.GetHashCode() == bd2.GetHashCode());
+    bd.Undo();
+    BOOST_CHECK(bd.GetHashCode() == board.GetHashCode());
+}
+
+/** Compare the cached results of GoUctBoard::SelfAtari with
+    GoBoardUtil::SelfAtariForColor in pseudo-random games.
+    All points are queried in each position, so that a cached result that
+    is still used after GoUctBoard::Play shows up in a later position. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_SelfAtari)
+{
+    GoTestUtil::Random random;
+    for (int game = 0; game < 20; ++game)
+    {
+        GoBoard board(7);
+        GoUctBoard bd(board);
+        for (int move = 0; move < 150; ++move)
+        {
+            for (GoUctBoard::Iterator it(bd); it; ++it)
+            {
+                SgPoint p = *it;
+                if (! bd.IsEmpty(p))
+                    continue;
+                for (SgBWIterator c; c; ++c)
+                    BOOST_CHECK_EQUAL(bd.SelfAtari(p, *c),
+                               GoBoardUtil::SelfAtariForColor(bd, p, *c));
+            }
+            SgPoint p = GoTestUtil::RandomMove(bd, random);
+            if (p == SG_PASS)
+                break;
+            bd.Play(p);
+        }
+    }
+}
+
+/** Test GoUctBoard::Undo() in pseudo-random games.
+    Moves are played and taken back in random order. After each undo, the
+    board must be in exactly the same state as a board on which the
+    remaining moves were played without undo. Many moves are played again
+    at points that were captured, so the storage of captured and merged
+    blocks is reused before they are restored. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_Undo)
+{
+    GoTestUtil::Random random;
+    for (int game = 0; game < 20; ++game)
+    {
+        GoBoard board(7);
+        GoUctBoard bd(board);
+        bd.EnableUndo(true);
+        BOOST_CHECK(! bd.CanUndo());
+        vector<SgPoint> sequence;
+        for (int step = 0; step < 300; ++step)
+        {
+            if (! sequence.empty() && random.Int(4) == 0)
+            {
+                int nuUndo = 1 + random.Int(4);
+                for (int i = 0; i < nuUndo && ! sequence.empty(); ++i)
+                {
+                    BOOST_REQUIRE(bd.CanUndo());
+                    bd.Undo();
+                    sequence.pop_back();
+                }
+                GoUctBoard replay(board);
+                for (size_t i = 0; i < sequence.size(); ++i)
+                    replay.Play(sequence[i]);
+                GoUctBoardTest_CheckSame(bd, replay);
+                continue;
+            }
+            SgPoint p = GoTestUtil::RandomMove(bd, random);
+            bd.Play(p);
+            sequence.push_back(p);
+        }
+        while (! sequence.empty())
+        {
+            bd.Undo();
+            sequence.pop_back();
+        }
+        BOOST_CHECK(! bd.CanUndo());
+        GoUctBoardTest_CheckSame(bd, GoUctBoard(board));
+    }
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
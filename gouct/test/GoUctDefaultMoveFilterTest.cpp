@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------------
+/** @file GoUctDefaultMoveFilterTest.cpp
+    Unit tests for GoUctDefaultMoveFilter. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <algorithm>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoSetupUtil.h"
+#include "GoUctDefaultMoveFilter.h"
+
+using namespace std;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Two white blocks in atari that are captured in a ladder. */
+const char* TWO_LADDERS =
+    ".........\n"
+    "......X..\n"
+    ".....XOX.\n"
+    ".....X...\n"
+    ".........\n"
+    "...X.....\n"
+    ".XOX.....\n"
+    "..X......\n"
+    ".........";
+
+bool Contains(const vector<SgPoint>& moves, SgPoint p)
+{
+    return find(moves.begin(), moves.end(), p) != moves.end();
+}
+
+GoUctDefaultMoveFilterParam LadderOnlyParam()
+{
+    GoUctDefaultMoveFilterParam param;
+    param.SetCheckSafety(false);
+    param.SetFilterFirstLine(false);
+    param.SetMinLadderLength(2);
+    return param;
+}
+
+/** Test that the cached ladder moves follow changes of the position. */
+BOOST_AUTO_TEST_CASE(GoUctDefaultMoveFilterTest_LadderCache)
+{
+    string position(TWO_LADDERS);
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(position, boardSize);
+    setup.m_player = SG_WHITE;
+    GoBoard bd(boardSize, setup);
+    GoUctDefaultMoveFilterParam param = LadderOnlyParam();
+    GoUctDefaultMoveFilter filter(bd, param);
+    vector<SgPoint> moves = filter.Get();
+    BOOST_CHECK(Contains(moves, Pt(3, 4)));
+    BOOST_CHECK(Contains(moves, Pt(7, 6)));
+    BOOST_CHECK(filter.Get() == moves);
+    bd.Play(SG_PASS);
+    BOOST_CHECK(filter.Get().empty());
+    bd.Undo();
+    BOOST_CHECK(filter.Get() == moves);
+    param.SetCheckLadders(false);
+    BOOST_CHECK(filter.Get().empty());
+}
+
+/** Test that reading the ladders in several threads gives the same result
+    as in one thread. */
+BOOST_AUTO_TEST_CASE(GoUctDefaultMoveFilterTest_LadderThreads)
+{
+    string position(TWO_LADDERS);
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(position, boardSize);
+    setup.m_player = SG_WHITE;
+    GoBoard bd(boardSize, setup);
+    GoUctDefaultMoveFilterParam param = LadderOnlyParam();
+    GoUctDefaultMoveFilter filter(bd, param);
+    const vector<SgPoint> moves = filter.Get();
+    GoUctDefaultMoveFilterParam threadParam = LadderOnlyParam();
+    threadParam.SetLadderThreads(3);
+    GoUctDefaultMoveFilter threadFilter(bd, threadParam);
+    BOOST_CHECK(threadFilter.Get() == moves);
+    bd.CheckConsistency();
+}
+
+/** Test that the incremental ladder reads give the same result as reading
+    all ladders after moves far from and near the ladders. */
+BOOST_AUTO_TEST_CASE(GoUctDefaultMoveFilterTest_Incremental)
+{
+    string position(TWO_LADDERS);
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(position, boardSize);
+    setup.m_player = SG_WHITE;
+    GoBoard bd(boardSize, setup);
+    GoUctDefaultMoveFilterParam param = LadderOnlyParam();
+    param.SetIncremental(true);
+    GoUctDefaultMoveFilter filter(bd, param);
+    const vector<SgPoint> moves = filter.Get();
+    BOOST_CHECK(Contains(moves, Pt(3, 4)));
+    BOOST_CHECK(Contains(moves, Pt(7, 6)));
+
+    bd.Play(Pt(1, 9), SG_WHITE);
+    bd.Play(Pt(9, 1), SG_BLACK);
+    BOOST_CHECK(filter.Get() == moves);
+
+    bd.Play(Pt(3, 4), SG_WHITE);
+    bd.Play(Pt(9, 2), SG_BLACK);
+    const GoUctDefaultMoveFilterParam fullParam = LadderOnlyParam();
+    GoUctDefaultMoveFilter fullFilter(bd, fullParam);
+    const vector<SgPoint> fullMoves = fullFilter.Get();
+    BOOST_CHECK(! Contains(fullMoves, Pt(3, 4)));
+    BOOST_CHECK(Contains(fullMoves, Pt(7, 6)));
+    BOOST_CHECK(filter.Get() == fullMoves);
+}
+
+/** Test that moves on the first line are filtered only if no stone is
+    within a Manhattan distance of 4. */
+BOOST_AUTO_TEST_CASE(GoUctDefaultMoveFilterTest_FirstLine)
+{
+    GoBoard bd(9);
+    GoUctDefaultMoveFilterParam param;
+    param.SetCheckLadders(false);
+    param.SetCheckSafety(false);
+    GoUctDefaultMoveFilter filter(bd, param);
+    BOOST_CHECK_EQUAL(filter.Get().size(), 32u);
+    bd.Play(Pt(5, 5), SG_BLACK);
+    const vector<SgPoint> moves = filter.Get();
+    BOOST_CHECK_EQUAL(moves.size(), 28u);
+    BOOST_CHECK(! Contains(moves, Pt(5, 1)));
+    BOOST_CHECK(Contains(moves, Pt(4, 1)));
+    BOOST_CHECK(Contains(moves, Pt(1, 1)));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------
+/** @file GoUctDefaultPriorKnowledgeTest.cpp
+    Unit tests for GoUctDefaultPriorKnowledge. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoTestUtil.h"
+#include "GoUctDefaultPriorKnowledge.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Compare the incrementally updated features with the features computed
+    from scratch in a random game that also undoes and passes. */
+BOOST_AUTO_TEST_CASE(GoUctDefaultPriorKnowledgeTest_IncrementalFeatures)
+{
+    GoBoard bd(9);
+    GoUctPlayoutPolicyParam policyParam;
+    GoUctDefaultPriorKnowledgeParam param;
+    GoUctDefaultPriorKnowledge knowledge(bd, policyParam, param);
+    GoTestUtil::Random random;
+    for (int i = 0; i < 300; ++i)
+    {
+        SgPointSet pattern;
+        SgPointSet atari;
+        GoPointList empty;
+        knowledge.FindGlobalPatternAndAtariMoves(pattern, atari, empty);
+        GoUctDefaultPriorKnowledge fromScratch(bd, policyParam, param);
+        SgPointSet expectedPattern;
+        SgPointSet expectedAtari;
+        GoPointList expectedEmpty;
+        fromScratch.FindGlobalPatternAndAtariMoves(expectedPattern,
+                                                   expectedAtari,
+                                                   expectedEmpty);
+        BOOST_CHECK(pattern == expectedPattern);
+        BOOST_CHECK(atari == expectedAtari);
+        BOOST_CHECK(knowledge.BadSelfAtariMoves()
+                    == fromScratch.BadSelfAtariMoves());
+        BOOST_CHECK_EQUAL(empty.Length(), expectedEmpty.Length());
+
+        const int action = random.Int(10);
+        if (action == 0 && bd.CanUndo())
+        {
+            const int nuUndo = 1 + random.Int(3);
+            for (int j = 0; j < nuUndo && bd.CanUndo(); ++j)
+                bd.Undo();
+        }
+        else if (action == 1)
+            bd.Play(SG_PASS);
+        else
+            bd.Play(GoTestUtil::RandomMove(bd, random));
+    }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
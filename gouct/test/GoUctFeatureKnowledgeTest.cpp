@@ -0,0 +1,150 @@
+//----------------------------------------------------------------------------
+/** @file GoUctFeatureKnowledgeTest.cpp
+    Unit tests for GoUctFeatureKnowledge and GoUctFeatureTrainer. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <sstream>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoSetup.h"
+#include "GoUctFeatureKnowledge.h"
+#include "GoUctFeatureTrainer.h"
+#include "SgException.h"
+#include "SgGameReader.h"
+#include "SgNode.h"
+
+using namespace std;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Test that equivalent patterns under a mirror and a transposition of the
+    board have the same code. */
+BOOST_AUTO_TEST_CASE(GoUctFeatureKnowledgeTest_PatternCodeSymmetry)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(2, 3));
+    setup.AddBlack(Pt(3, 3));
+    setup.AddWhite(Pt(2, 4));
+    GoBoard bd(9, setup);
+    const uint32_t code = GoUctFeatureUtil::PatternCode(bd, Pt(3, 4));
+
+    GoSetup mirrored;
+    mirrored.AddBlack(Pt(8, 3));
+    mirrored.AddBlack(Pt(7, 3));
+    mirrored.AddWhite(Pt(8, 4));
+    GoBoard mirroredBd(9, mirrored);
+    BOOST_CHECK_EQUAL(GoUctFeatureUtil::PatternCode(mirroredBd, Pt(7, 4)),
+                      code);
+
+    GoSetup transposed;
+    transposed.AddBlack(Pt(3, 2));
+    transposed.AddBlack(Pt(3, 3));
+    transposed.AddWhite(Pt(4, 2));
+    GoBoard transposedBd(9, transposed);
+    BOOST_CHECK_EQUAL(GoUctFeatureUtil::PatternCode(transposedBd, Pt(4, 3)),
+                      code);
+
+    BOOST_CHECK(GoUctFeatureUtil::PatternCode(bd, Pt(5, 5)) != code);
+}
+
+/** Test the tactical features of a capture and of pass. */
+BOOST_AUTO_TEST_CASE(GoUctFeatureKnowledgeTest_FindFeatures)
+{
+    GoSetup setup;
+    setup.AddWhite(Pt(1, 1));
+    setup.AddBlack(Pt(2, 1));
+    GoBoard bd(9, setup);
+    GoUctMoveFeatures features = GoUctFeatureUtil::FindFeatures(bd, Pt(1, 2));
+    BOOST_CHECK(features.Has(GOUCT_FEATURE_CAPTURE));
+    BOOST_CHECK(features.Has(GOUCT_FEATURE_LINE_1));
+    BOOST_CHECK(! features.Has(GOUCT_FEATURE_SELF_ATARI));
+    BOOST_CHECK(features.m_hasPattern);
+    features = GoUctFeatureUtil::FindFeatures(bd, SG_PASS);
+    BOOST_CHECK(features.Has(GOUCT_FEATURE_PASS));
+    BOOST_CHECK(! features.m_hasPattern);
+}
+
+BOOST_AUTO_TEST_CASE(GoUctFeatureKnowledgeTest_ProcessPosition)
+{
+    GoSetup setup;
+    setup.AddWhite(Pt(1, 1));
+    setup.AddBlack(Pt(2, 1));
+    GoBoard bd(9, setup);
+    GoUctFeatureKnowledgeParam param;
+    param.m_weights.Weight(GOUCT_FEATURE_CAPTURE) = 2;
+    GoUctFeatureKnowledge knowledge(bd, param);
+    vector<SgUctMoveInfo> moves;
+    moves.push_back(SgUctMoveInfo(Pt(5, 5)));
+    moves.push_back(SgUctMoveInfo(Pt(1, 2)));
+    moves.push_back(SgUctMoveInfo(SG_PASS));
+    knowledge.ProcessPosition(moves);
+    BOOST_CHECK_CLOSE(moves[1].m_gamma, 1.f, 1e-4);
+    BOOST_CHECK(moves[1].m_prior > moves[0].m_prior);
+    BOOST_CHECK_CLOSE(moves[0].m_prior, moves[2].m_prior, 1e-4);
+    BOOST_CHECK_CLOSE(moves[0].m_prior + moves[1].m_prior + moves[2].m_prior,
+                      1.f, 1e-4);
+}
+
+/** Test writing and reading weights, including a resize of the dictionary.
+    */
+BOOST_AUTO_TEST_CASE(GoUctFeatureKnowledgeTest_ReadWrite)
+{
+    GoUctFeatureWeights weights;
+    weights.Weight(GOUCT_FEATURE_ATARI) = 1.5f;
+    weights.Weight(GOUCT_FEATURE_UNKNOWN_PATTERN) = -0.5f;
+    for (uint32_t code = 0; code < 3000; ++code)
+        weights.AddPattern(code * 7) = float(code) / 100;
+    BOOST_CHECK_EQUAL(weights.NuPatterns(), 3000);
+    ostringstream out;
+    weights.Write(out);
+    GoUctFeatureWeights readWeights;
+    istringstream in(out.str());
+    readWeights.Read(in);
+    BOOST_CHECK_EQUAL(readWeights.NuPatterns(), 3000);
+    BOOST_CHECK_EQUAL(readWeights.Weight(GOUCT_FEATURE_ATARI), 1.5f);
+    BOOST_CHECK_EQUAL(readWeights.PatternWeight(7 * 123), 1.23f);
+    BOOST_CHECK_EQUAL(readWeights.PatternWeight(1), -0.5f);
+    BOOST_CHECK(readWeights.FindPattern(1) == 0);
+
+    istringstream invalid("no weights");
+    BOOST_CHECK_THROW(readWeights.Read(invalid), SgException);
+    BOOST_CHECK_EQUAL(readWeights.NuPatterns(), 3000);
+}
+
+/** Test that training on a game increases the likelihood of its moves.
+    Pass is a candidate in every position, but never played, so its weight
+    must decrease. */
+BOOST_AUTO_TEST_CASE(GoUctFeatureKnowledgeTest_Trainer)
+{
+    const string sgf =
+        "(;FF[4]SZ[9];B[ee];W[gc];B[cg];W[dc];B[ec];W[eb];B[fb];W[fc]"
+        ";B[db];W[cc];B[gb];W[hb];B[ha];W[ib])";
+    GoUctFeatureWeights weights;
+    GoUctFeatureTrainer trainer(weights);
+    trainer.SetLearningRate(0.1f);
+    double firstLikelihood = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        istringstream in(sgf);
+        SgGameReader reader(in);
+        SgNode* root = reader.ReadGame();
+        BOOST_REQUIRE(root != 0);
+        trainer.ClearStatistics();
+        trainer.TrainGame(root);
+        BOOST_CHECK_EQUAL(trainer.NuPositions(), 14);
+        if (i == 0)
+            firstLikelihood = trainer.MeanLogLikelihood();
+    }
+    BOOST_CHECK(trainer.MeanLogLikelihood() > firstLikelihood);
+    BOOST_CHECK(weights.NuPatterns() > 0);
+    BOOST_CHECK(weights.Weight(GOUCT_FEATURE_PASS) < 0);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
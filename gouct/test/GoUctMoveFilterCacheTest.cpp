@@ -0,0 +1,51 @@
+//----------------------------------------------------------------------------
+/** @file GoUctMoveFilterCacheTest.cpp
+    Unit tests for GoUctMoveFilterCache. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoUctMoveFilterCache.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(GoUctMoveFilterCacheTest_LookupStore)
+{
+    GoBoard bd(9);
+    GoUctMoveFilterCache cache(256);
+    SgPointSet filtered;
+    BOOST_CHECK(! cache.Lookup(bd, filtered));
+    SgPointSet moves;
+    moves.Include(Pt(1, 1));
+    moves.Include(Pt(9, 9));
+    cache.Store(bd, moves);
+    BOOST_CHECK(cache.Lookup(bd, filtered));
+    BOOST_CHECK(filtered == moves);
+
+    // Same stones, other color to play
+    bd.SetToPlay(SG_WHITE);
+    BOOST_CHECK(! cache.Lookup(bd, filtered));
+    bd.SetToPlay(SG_BLACK);
+
+    bd.Play(Pt(5, 5));
+    BOOST_CHECK(! cache.Lookup(bd, filtered));
+    bd.Undo();
+    BOOST_CHECK(cache.Lookup(bd, filtered));
+
+    // Empty boards of different sizes have the same hash code
+    GoBoard otherSize(7);
+    BOOST_CHECK(! cache.Lookup(otherSize, filtered));
+
+    cache.Clear();
+    BOOST_CHECK(! cache.Lookup(bd, filtered));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
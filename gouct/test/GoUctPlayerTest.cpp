@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayerTest.cpp
+    Unit tests for GoUctPlayer. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoSetup.h"
+#include "GoUctPlayer.h"
+#include "SgDebug.h"
+#include "SgTimeRecord.h"
+
+using namespace std;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+typedef GoUctPlayer<GoUctGlobalSearch<GoUctPlayoutPolicy<GoUctBoard>,
+                    GoUctPlayoutPolicyFactory<GoUctBoard> >,
+                    GoUctGlobalSearchState<GoUctPlayoutPolicy<GoUctBoard> > >
+GoUctPlayerTest_Player;
+
+/** Set up a player for short searches.
+    Uses two threads, because the consistency check of the value estimate
+    in single-threaded SgUctSearch does not include the UCT bias term. */
+void GoUctPlayerTest_Init(GoUctPlayerTest_Player& player)
+{
+    player.SetMaxGames(300);
+    player.SetIgnoreClock(true);
+    player.SetEarlyPass(false);
+    player.SetForcedOpeningMoves(false);
+    player.SetWriteDebugOutput(false);
+    player.GlobalSearch().SetNumberThreads(2);
+    player.GlobalSearch().SetMaxNodes(100000);
+}
+
+/** Generate a move and return the debug output of the player. */
+string GoUctPlayerTest_GenMove(GoUctPlayerTest_Player& player,
+                               SgBlackWhite toPlay, SgPoint& move)
+{
+    SgDebugToString debugStr(false);
+    move = player.GenMove(SgTimeRecord(true, 10), toPlay);
+    return debugStr.GetString();
+}
+
+/** Test that the subtree prepared after the opponent's move is used by the
+    next move generation.
+    Also checks that the const access to the search waits for the thread
+    that prepares the subtree, but does not discard the subtree. */
+BOOST_AUTO_TEST_CASE(GoUctPlayerTest_PrepareInitTree)
+{
+    GoBoard game(9);
+    GoUctPlayerTest_Player player(game);
+    GoUctPlayerTest_Init(player);
+    player.UpdateSubscriber();
+    SgPoint move;
+    GoUctPlayerTest_GenMove(player, SG_BLACK, move);
+    BOOST_REQUIRE(game.IsLegal(move));
+    game.Play(move);
+    game.Play(move == Pt(3, 3) ? Pt(7, 7) : Pt(3, 3));
+    player.UpdateSubscriber();
+    const GoUctPlayerTest_Player& constPlayer = player;
+    BOOST_CHECK(constPlayer.GlobalSearch().Tree().NuNodes() > 1);
+    string debugOutput = GoUctPlayerTest_GenMove(player, SG_BLACK, move);
+    BOOST_CHECK(debugOutput.find("Using prepared subtree")
+                != string::npos);
+}
+
+/** Test that a prepared subtree is discarded if the game board changes to
+    an unrelated position before the next move generation. */
+BOOST_AUTO_TEST_CASE(GoUctPlayerTest_PrepareInitTree_Discard)
+{
+    GoBoard game(9);
+    GoUctPlayerTest_Player player(game);
+    GoUctPlayerTest_Init(player);
+    player.UpdateSubscriber();
+    SgPoint move;
+    GoUctPlayerTest_GenMove(player, SG_BLACK, move);
+    BOOST_REQUIRE(game.IsLegal(move));
+    game.Play(move);
+    game.Play(move == Pt(3, 3) ? Pt(7, 7) : Pt(3, 3));
+    player.UpdateSubscriber();
+    GoSetup setup;
+    setup.AddBlack(Pt(5, 5));
+    setup.AddWhite(Pt(5, 6));
+    game.Init(9, setup);
+    player.UpdateSubscriber();
+    string debugOutput = GoUctPlayerTest_GenMove(player, SG_BLACK, move);
+    BOOST_CHECK(debugOutput.find("Using prepared subtree")
+                == string::npos);
+    BOOST_CHECK(debugOutput.find("No tree to reuse found")
+                != string::npos);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutPolicyTest.cpp
+    Unit tests for GoUctPlayoutPolicy. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoUctBoard.h"
+#include "GoUctPlayoutPolicy.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Generate moves with profiling of every second move generation. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutPolicyTest_Profile)
+{
+    GoBoard board(9);
+    GoUctBoard bd(board);
+    GoUctPlayoutPolicyParam param;
+    param.m_profileInterval = 2;
+    GoUctPlayoutPolicy<GoUctBoard> policy(bd, param);
+    policy.StartPlayout();
+    for (int i = 0; i < 10; ++i)
+    {
+        SgPoint p = policy.GenerateMove();
+        bd.Play(p);
+        policy.OnPlay();
+    }
+    const GoUctPlayoutPolicyProfile& profile = policy.Profile();
+    BOOST_CHECK_EQUAL(profile.m_nuSamples, 5u);
+    size_t nuGenerated = 0;
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+    {
+        BOOST_CHECK(profile.m_nuHits[i] <= profile.m_nuCalls[i]);
+        BOOST_CHECK(profile.m_time[i] >= 0);
+        if (i != GOUCT_SELFATARI_CORRECTION && i != GOUCT_CLUMP_CORRECTION)
+            nuGenerated += profile.m_nuHits[i];
+    }
+    BOOST_CHECK_EQUAL(nuGenerated, 5u);
+    BOOST_CHECK_EQUAL(profile.m_nuCalls[GOUCT_SELFATARI_CORRECTION], 5u);
+
+    GoUctPlayoutPolicyProfile merged;
+    merged.Merge(profile);
+    merged.Merge(profile);
+    BOOST_CHECK_EQUAL(merged.m_nuSamples, 10u);
+    BOOST_CHECK_EQUAL(merged.m_nuCalls[GOUCT_SELFATARI_CORRECTION], 10u);
+
+    policy.ClearProfile();
+    BOOST_CHECK_EQUAL(policy.Profile().m_nuSamples, 0u);
+}
+
+/** Check that nothing is collected if profiling is disabled. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutPolicyTest_ProfileDisabled)
+{
+    GoBoard board(9);
+    GoUctBoard bd(board);
+    GoUctPlayoutPolicyParam param;
+    GoUctPlayoutPolicy<GoUctBoard> policy(bd, param);
+    policy.StartPlayout();
+    SgPoint p = policy.GenerateMove();
+    bd.Play(p);
+    policy.OnPlay();
+    BOOST_CHECK_EQUAL(policy.Profile().m_nuSamples, 0u);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
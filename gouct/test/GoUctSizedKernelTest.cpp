@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------
+/** @file GoUctSizedKernelTest.cpp
+    Unit tests for GoUctSizedKernel. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoUctBoard.h"
+#include "GoUctSizedKernel.h"
+
+using namespace std;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+struct CollectFunction
+{
+    vector<SgPoint> m_points;
+
+    void operator()(SgPoint p)
+    {
+        m_points.push_back(p);
+    }
+};
+
+GoSetup CreateTestSetup(int size)
+{
+    GoSetup setup;
+    for (int row = 1; row <= size; ++row)
+    {
+        setup.AddBlack(Pt(2, row));
+        setup.AddWhite(Pt(size - 1, row));
+    }
+    setup.AddBlack(Pt(4, 4));
+    setup.AddWhite(Pt(5, 5));
+    return setup;
+}
+
+void CheckScoreSimpleEndPosition(int size)
+{
+    GoBoard board(size, CreateTestSetup(size));
+    GoUctBoard bd(board);
+    SgBWSet safe;
+    safe[SG_WHITE].Include(Pt(5, 5));
+    SgPointArray<SgEmptyBlackWhite> scoreBoard;
+    SgPointArray<SgEmptyBlackWhite> expectedScoreBoard;
+    float score = GoUctSizedKernelUtil::ScoreSimpleEndPosition(
+                       GoUctSizedKernelUtil::KernelSize(size), bd, 6.5f,
+                       safe, true, &scoreBoard);
+    float expectedScore = GoBoardUtil::ScoreSimpleEndPosition(bd, 6.5f, safe,
+                                                   true, &expectedScoreBoard);
+    BOOST_CHECK_EQUAL(score, expectedScore);
+    for (GoUctBoard::Iterator it(bd); it; ++it)
+        BOOST_CHECK_EQUAL(scoreBoard[*it], expectedScoreBoard[*it]);
+}
+
+void CheckForEachEmpty(int size)
+{
+    GoBoard board(size, CreateTestSetup(size));
+    GoUctBoard bd(board);
+    CollectFunction f;
+    GoUctSizedKernelUtil::ForEachEmpty(GoUctSizedKernelUtil::KernelSize(size),
+                                       bd, f);
+    vector<SgPoint> expected;
+    for (GoUctBoard::Iterator it(bd); it; ++it)
+        if (bd.IsEmpty(*it))
+            expected.push_back(*it);
+    BOOST_CHECK(f.m_points == expected);
+}
+
+//----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(GoUctSizedKernelTest_KernelSize)
+{
+    BOOST_CHECK_EQUAL(GoUctSizedKernelUtil::KernelSize(9), 9);
+    BOOST_CHECK_EQUAL(GoUctSizedKernelUtil::KernelSize(7), 0);
+    BOOST_CHECK_EQUAL(GoUctSizedKernelUtil::KernelSize(19),
+                      SG_MAX_SIZE >= 19 ? 19 : 0);
+}
+
+/** Compare specialized and generic loops on all sizes with a kernel and on a
+    size without a kernel. */
+BOOST_AUTO_TEST_CASE(GoUctSizedKernelTest_SameAsGeneric)
+{
+    const int sizes[4] = { 7, 9, 13, 19 };
+    for (int i = 0; i < 4; ++i)
+        if (sizes[i] <= SG_MAX_SIZE)
+        {
+            CheckScoreSimpleEndPosition(sizes[i]);
+            CheckForEachEmpty(sizes[i]);
+        }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
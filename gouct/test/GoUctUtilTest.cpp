@@ -8,6 +8,7 @@
 #include <boost/test/auto_unit_test.hpp>
 #include "GoBoard.h"
 #include "GoSetupUtil.h"
+#include "GoUctPlayoutPolicy.h"
 #include "GoUctUtil.h"
 
 using namespace std;
@@ -277,6 +278,96 @@ BOOST_AUTO_TEST_CASE(GoUctUtilTest_GenForcedOpeningMove_SetupStones)
     }
 }
 
+/** Test GoUctUtil::IsSettledPosition */
+BOOST_AUTO_TEST_CASE(GoUctUtilTest_IsSettledPosition)
+{
+    string s(". X O . O\n"
+             "X X O O O\n"
+             ". X O . O\n"
+             "X X O O O\n"
+             ". X O . O\n");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    GoBoard bd(boardSize, setup);
+    GoUctBoard uctBd(bd);
+    BOOST_CHECK_EQUAL(uctBd.NumOpenPoints(), 0);
+    BOOST_CHECK(GoUctUtil::IsSettledPosition(uctBd));
+}
+
+/** Test GoUctUtil::IsSettledPosition (empty points with empty neighbors) */
+BOOST_AUTO_TEST_CASE(GoUctUtilTest_IsSettledPosition_Open)
+{
+    string s(". X O . O\n"
+             ". X O O O\n"
+             ". X O . O\n"
+             "X X O O O\n"
+             ". X O . O\n");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    GoBoard bd(boardSize, setup);
+    GoUctBoard uctBd(bd);
+    BOOST_CHECK_EQUAL(uctBd.NumOpenPoints(), 3);
+    BOOST_CHECK(! GoUctUtil::IsSettledPosition(uctBd));
+}
+
+/** Test GoUctUtil::IsSettledPosition (block with only one eye) */
+BOOST_AUTO_TEST_CASE(GoUctUtilTest_IsSettledPosition_OneEye)
+{
+    string s(". X O O O\n"
+             "X X O O O\n"
+             ". X O . O\n"
+             "X X O O O\n"
+             ". X O O O\n");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    GoBoard bd(boardSize, setup);
+    GoUctBoard uctBd(bd);
+    BOOST_CHECK_EQUAL(uctBd.NumOpenPoints(), 0);
+    BOOST_CHECK(! GoUctUtil::IsSettledPosition(uctBd));
+}
+
+/** Compare GoUctUtil::ScoreSettledPosition with the score of the position
+    played out by the playout policy.
+    The position has three dame points C5, C3 and C1, so the color to play
+    gets one point more of them than the opponent. */
+BOOST_AUTO_TEST_CASE(GoUctUtilTest_ScoreSettledPosition)
+{
+    const float komi = 0.5;
+    const SgBWSet safe;
+    for (SgBWIterator it; it; ++it)
+    {
+        string s(". X . O .\n"
+                 "X X X O O\n"
+                 ". X . O .\n"
+                 "X X X O O\n"
+                 ". X . O .\n");
+        int boardSize;
+        GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+        setup.m_player = *it;
+        GoBoard bd(boardSize, setup);
+        GoUctBoard uctBd(bd);
+        BOOST_REQUIRE(GoUctUtil::IsSettledPosition(uctBd));
+        const float score =
+            GoUctUtil::ScoreSettledPosition(uctBd, komi, safe, 0);
+        BOOST_CHECK_EQUAL(score, *it == SG_BLACK ? 2.5f : 0.5f);
+        GoUctPlayoutPolicyParam param;
+        GoUctPlayoutPolicy<GoUctBoard> policy(uctBd, param);
+        policy.StartPlayout();
+        int nuPass = 0;
+        for (int i = 0; i < 20 && nuPass < 2; ++i)
+        {
+            SgPoint p = policy.GenerateMove();
+            nuPass = (p == SG_PASS ? nuPass + 1 : 0);
+            uctBd.Play(p);
+            policy.OnPlay();
+        }
+        BOOST_REQUIRE_EQUAL(nuPass, 2);
+        BOOST_CHECK_EQUAL(GoBoardUtil::ScoreSimpleEndPosition(uctBd, komi,
+                                                              safe, false, 0),
+                          score);
+    }
+}
+
 //----------------------------------------------------------------------------
 
 } // namespace
@@ -15,6 +15,7 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <boost/static_assert.hpp>
 #include "SgArray.h"
 #include "SgException.h"
 #include "SgRandom.h"
@@ -92,8 +93,23 @@ private:
     std::bitset<N> m_code;
 };
 
-/** For backwards compatibility */
-typedef SgHash<64> SgHashCode;
+/** @var SG_HASHCODE_SIZE
+    Number of bits of SgHashCode.
+    The default is 64. Configuring with --enable-hash-size=128 defines
+    SG_HASH_SIZE and uses 128-bit hash codes for the board hash codes, the
+    search hash tables and the opening books, which makes collisions
+    practically impossible even for very large books at the cost of memory
+    and speed. */
+#ifdef SG_HASH_SIZE
+const int SG_HASHCODE_SIZE = SG_HASH_SIZE;
+#else
+const int SG_HASHCODE_SIZE = 64;
+#endif
+
+BOOST_STATIC_ASSERT(SG_HASHCODE_SIZE >= 64);
+BOOST_STATIC_ASSERT(SG_HASHCODE_SIZE % 32 == 0);
+
+typedef SgHash<SG_HASHCODE_SIZE> SgHashCode;
 
 template<int N>
 SgHash<N>::SgHash(unsigned int key)
@@ -152,7 +168,8 @@ unsigned int SgHash<N>::Code1() const
 template<int N>
 unsigned int SgHash<N>::Code2() const
 {
-    return (m_code >> 32).to_ulong();
+    static const std::bitset<N> mask(0xffffffffUL);
+    return (unsigned int)(((m_code >> 32) & mask).to_ulong());
 }
 
 template<int N>
@@ -310,8 +327,8 @@ private:
     SgArray<SgHash<N>,MAX_HASH_INDEX> m_hash;
 };
 
-/** For backwards compatibility */
-typedef SgHashZobrist<64> SgHashZobristTable;
+/** Zobrist table for SgHashCode. */
+typedef SgHashZobrist<SG_HASHCODE_SIZE> SgHashZobristTable;
 
 template<int N>
 SgHashZobrist<N> SgHashZobrist<N>::m_globalTable;
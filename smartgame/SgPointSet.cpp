@@ -47,10 +47,7 @@ SgPointSet SgPointSet::Border(int boardSize) const
 
 SgPointSet SgPointSet::BorderNoClip() const
 {
-    SgPointSet bd = (*this >> SG_NS);
-    bd |= (*this << SG_NS);
-    bd |= (*this >> SG_WE);
-    bd |= (*this << SG_WE);
+    SgPointSet bd = Neighbors4();
     bd -= (*this);
     return bd;
 }
@@ -154,20 +151,14 @@ void SgPointSet::Write(ostream& out, int boardSize) const
 
 void SgPointSet::Grow(int boardSize)
 {
-    SgPointSet bd = (*this >> SG_NS);
-    bd |= (*this << SG_NS);
-    bd |= (*this >> SG_WE);
-    bd |= (*this << SG_WE);
+    SgPointSet bd = Neighbors4();
     bd &= AllPoints(boardSize);
     *this |= bd;
 }
 
 void SgPointSet::Grow(SgPointSet* newArea, int boardSize)
 {
-    *newArea  = (*this >> SG_NS);
-    *newArea |= (*this << SG_NS);
-    *newArea |= (*this >> SG_WE);
-    *newArea |= (*this << SG_WE);
+    *newArea = Neighbors4();
     *newArea &= AllPoints(boardSize);
     *newArea ^= (*this);
     *this |= *newArea;
@@ -175,28 +166,14 @@ void SgPointSet::Grow(SgPointSet* newArea, int boardSize)
 
 void SgPointSet::Grow8(int boardSize)
 {
-    SgPointSet bd = (*this >> SG_NS);
-    bd |= (*this << SG_NS);
-    bd |= (*this >> SG_WE);
-    bd |= (*this << SG_WE);
-    bd |= (*this >> (SG_NS + SG_WE));
-    bd |= (*this << (SG_NS + SG_WE));
-    bd |= (*this >> (SG_NS - SG_WE));
-    bd |= (*this << (SG_NS - SG_WE));
+    SgPointSet bd = Neighbors8();
     bd &= AllPoints(boardSize);
     *this |= bd;
 }
 
 SgPointSet SgPointSet::Border8(int boardSize) const
 {
-    SgPointSet bd = (*this >> SG_NS);
-    bd |= (*this << SG_NS);
-    bd |= (*this >> SG_WE);
-    bd |= (*this << SG_WE);
-    bd |= (*this >> (SG_NS + SG_WE));
-    bd |= (*this << (SG_NS + SG_WE));
-    bd |= (*this >> (SG_NS - SG_WE));
-    bd |= (*this << (SG_NS - SG_WE));
+    SgPointSet bd = Neighbors8();
     bd -= (*this);
     bd &= AllPoints(boardSize);
     return bd;
@@ -210,12 +187,19 @@ bool SgPointSet::IsSize(int size) const
 
 bool SgPointSet::MinSetSize(int size) const
 {
-    return Size() >= size;
+    int n = 0;
+    for (int i = 0; i < NU_WORDS; ++i)
+    {
+        n += PopCount(m_a[i]);
+        if (n >= size)
+            return true;
+    }
+    return n >= size;
 }
 
 bool SgPointSet::MaxSetSize(int size) const
 {
-    return Size() <= size;
+    return ! MinSetSize(size + 1);
 }
 
 bool SgPointSet::Adjacent(const SgPointSet& s) const
@@ -251,23 +235,40 @@ SgPointSet SgPointSet::Kernel(int boardSize) const
 {
     // Kernel is computed by growing the complement,
     // and subtracting that from the given set.
-    // @todo would direct implementation be faster?
     SgPointSet k = AllPoints(boardSize) - (*this);
-    SgPointSet bd = (k >> SG_NS);
-    bd |= (k << SG_NS);
-    bd |= (k >> SG_WE);
-    bd |= (k << SG_WE);
-    return (*this) - bd;
+    return (*this) - k.Neighbors4();
+}
+
+SgPointSet SgPointSet::Neighbors4() const
+{
+    SgPointSet nb;
+    for (int i = 0; i < NU_WORDS; ++i)
+        nb.m_a[i] =   ShiftedUp(i, SG_NS) | ShiftedDown(i, SG_NS)
+                    | ShiftedUp(i, SG_WE) | ShiftedDown(i, SG_WE);
+    nb.m_a[NU_WORDS - 1] &= LAST_WORD_MASK;
+    return nb;
+}
+
+SgPointSet SgPointSet::Neighbors8() const
+{
+    SgPointSet nb;
+    for (int i = 0; i < NU_WORDS; ++i)
+        nb.m_a[i] =   ShiftedUp(i, SG_NS) | ShiftedDown(i, SG_NS)
+                    | ShiftedUp(i, SG_WE) | ShiftedDown(i, SG_WE)
+                    | ShiftedUp(i, SG_NS + SG_WE)
+                    | ShiftedDown(i, SG_NS + SG_WE)
+                    | ShiftedUp(i, SG_NS - SG_WE)
+                    | ShiftedDown(i, SG_NS - SG_WE);
+    nb.m_a[NU_WORDS - 1] &= LAST_WORD_MASK;
+    return nb;
 }
 
 SgPoint SgPointSet::PointOf() const
 {
-    // slight misuse of iterator, only see if can get one point
-    SgSetIterator it(*this);
-    if (it)
-        return *it;
-    else
-        return SG_NULLPOINT;
+    for (int i = 0; i < NU_WORDS; ++i)
+        if (m_a[i] != 0)
+            return i * WORD_BITS + CountTrailingZeros(m_a[i]);
+    return SG_NULLPOINT;
 }
 
 SgPoint SgPointSet::Center() const
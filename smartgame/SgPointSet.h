@@ -7,10 +7,10 @@
 #define SG_POINTSET_H
 
 #include <algorithm>
-#include <bitset>
 #include <cstring>
 #include <iosfwd>
 #include <memory>
+#include <stdint.h>
 #include "SgArray.h"
 #include "SgPoint.h"
 #include "SgRect.h"
@@ -20,7 +20,13 @@
 
 /** Set of points.
     Represents a set of points on the Go board. This class is efficient for
-    bit-level operations on the board as a whole. */
+    bit-level operations on the board as a whole.
+    The points are stored as bits in an array of 64-bit words. Set
+    operations work on whole words, Size() uses a population count per
+    word and SgSetIterator skips to the next set bit with a count of the
+    trailing zeros. The neighborhood operations (Border(), Grow(), Kernel()
+    and their 8-neighbor versions) compute the union of the shifted sets in
+    a single pass over the words. */
 class SgPointSet
 {
 public:
@@ -129,6 +135,16 @@ public:
     /** Include 8-neighbor points in set */
     void Grow8(int boardSize);
 
+    /** Union of the 4-neighbors of all points, not clipped to the board.
+        Unlike BorderNoClip(), it contains the points of the set that have
+        a neighbor in the set. */
+    SgPointSet Neighbors4() const;
+
+    /** Union of the 8-neighbors of all points, not clipped to the board.
+        Contains the points of the set that have an 8-neighbor in the
+        set. */
+    SgPointSet Neighbors8() const;
+
     SgPointSet& Include(SgPoint p);
 
     /** Whether set is connected or not.
@@ -175,6 +191,17 @@ public:
     bool IsCloseTo(SgPoint p) const;
     
 private:
+    typedef uint64_t Word;
+
+    static const int WORD_BITS = 64;
+
+    static const int NU_WORDS = (SG_MAXPOINT + WORD_BITS - 1) / WORD_BITS;
+
+    /** Mask of the bits of the last word that correspond to points. */
+    static const Word LAST_WORD_MASK =
+        (SG_MAXPOINT % WORD_BITS == 0) ?
+        ~Word(0) : (Word(1) << (SG_MAXPOINT % WORD_BITS)) - 1;
+
     /** Precomputed point sets with all points depending on board size. */
     class PrecompAllPoints
     {
@@ -194,14 +221,23 @@ private:
 
     friend class SgSetIterator;
 
-    std::bitset<SG_MAXPOINT> m_a;
+    /** Bit p % WORD_BITS of word p / WORD_BITS is set if p is in the set.
+        Bits above SG_MAXPOINT in the last word are always zero. */
+    Word m_a[NU_WORDS];
 
     static PrecompAllPoints s_allPoints;
 
-    SgPointSet operator>>(int n) const;
+    /** Word i of the set shifted by n points to larger points.
+        @param n The shift, must be in [1..WORD_BITS - 1] */
+    Word ShiftedUp(int i, int n) const;
 
-    SgPointSet operator<<(int n) const;
+    /** Word i of the set shifted by n points to smaller points.
+        @param n The shift, must be in [1..WORD_BITS - 1] */
+    Word ShiftedDown(int i, int n) const;
 
+    static int CountTrailingZeros(Word w);
+
+    static int PopCount(Word w);
 };
 
 
@@ -235,49 +271,104 @@ inline SgPointSet operator^(const SgPointSet& L, const SgPointSet& R)
 
 inline SgPointSet::SgPointSet()
 {
+    Clear();
 }
 
 inline SgPointSet::~SgPointSet()
 {
 }
 
+inline int SgPointSet::CountTrailingZeros(Word w)
+{
+    SG_ASSERT(w != 0);
+#if defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    int n = 0;
+    while ((w & 1) == 0)
+    {
+        w >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline int SgPointSet::PopCount(Word w)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<int>((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline SgPointSet::Word SgPointSet::ShiftedUp(int i, int n) const
+{
+    SG_ASSERT(n > 0 && n < WORD_BITS);
+    Word w = m_a[i] << n;
+    if (i > 0)
+        w |= m_a[i - 1] >> (WORD_BITS - n);
+    return w;
+}
+
+inline SgPointSet::Word SgPointSet::ShiftedDown(int i, int n) const
+{
+    SG_ASSERT(n > 0 && n < WORD_BITS);
+    Word w = m_a[i] >> n;
+    if (i < NU_WORDS - 1)
+        w |= m_a[i + 1] << (WORD_BITS - n);
+    return w;
+}
+
 inline void SgPointSet::Swap(SgPointSet& other) throw()
 {
-    std::swap(m_a, other.m_a);
+    for (int i = 0; i < NU_WORDS; ++i)
+        std::swap(m_a[i], other.m_a[i]);
 }
 
 inline SgPointSet& SgPointSet::operator-=(const SgPointSet& other)
 {
-    m_a &= ~other.m_a;
+    for (int i = 0; i < NU_WORDS; ++i)
+        m_a[i] &= ~other.m_a[i];
     return (*this);
 }
 
 inline SgPointSet& SgPointSet::operator&=(const SgPointSet& other)
 {
-    m_a &= other.m_a;
+    for (int i = 0; i < NU_WORDS; ++i)
+        m_a[i] &= other.m_a[i];
     return (*this);
 }
 
 inline SgPointSet& SgPointSet::operator|=(const SgPointSet& other)
 {
-    m_a |= other.m_a;
+    for (int i = 0; i < NU_WORDS; ++i)
+        m_a[i] |= other.m_a[i];
     return (*this);
 }
 
 inline SgPointSet& SgPointSet::operator^=(const SgPointSet& other)
 {
-    m_a ^= other.m_a;
+    for (int i = 0; i < NU_WORDS; ++i)
+        m_a[i] ^= other.m_a[i];
     return (*this);
 }
 
 inline bool SgPointSet::operator==(const SgPointSet& other) const
 {
-    return m_a == other.m_a;
+    for (int i = 0; i < NU_WORDS; ++i)
+        if (m_a[i] != other.m_a[i])
+            return false;
+    return true;
 }
 
 inline bool SgPointSet::operator!=(const SgPointSet& other) const
 {
-    return m_a != other.m_a;
+    return ! (*this == other);
 }
 
 inline const SgPointSet& SgPointSet::AllPoints(int boardSize)
@@ -287,14 +378,22 @@ inline const SgPointSet& SgPointSet::AllPoints(int boardSize)
 
 inline bool SgPointSet::Overlaps(const SgPointSet& other) const
 {
-    return (m_a & other.m_a).any();
+    for (int i = 0; i < NU_WORDS; ++i)
+        if ((m_a[i] & other.m_a[i]) != 0)
+            return true;
+    return false;
 }
 
 inline bool SgPointSet::MaxOverlap(const SgPointSet& other, int max) const
 {
-    SgPointSet s(*this);
-    s &= other;
-    return s.Size() <= max;
+    int n = 0;
+    for (int i = 0; i < NU_WORDS; ++i)
+    {
+        n += PopCount(m_a[i] & other.m_a[i]);
+        if (n > max)
+            return false;
+    }
+    return true;
 }
 
 inline bool SgPointSet::MinOverlap(const SgPointSet& s, int min) const
@@ -327,22 +426,31 @@ inline bool SgPointSet::Adjacent8To(SgPoint p) const
 
 inline bool SgPointSet::SubsetOf(const SgPointSet& other) const
 {
-    return (m_a & ~other.m_a).none();
+    for (int i = 0; i < NU_WORDS; ++i)
+        if ((m_a[i] & ~other.m_a[i]) != 0)
+            return false;
+    return true;
 }
 
 inline bool SgPointSet::SupersetOf(const SgPointSet& other) const
 {
-    return (other.m_a & ~m_a).none();
+    return other.SubsetOf(*this);
 }
 
 inline int SgPointSet::Size() const
 {
-    return static_cast<int>(m_a.count());
+    int n = 0;
+    for (int i = 0; i < NU_WORDS; ++i)
+        n += PopCount(m_a[i]);
+    return n;
 }
 
 inline bool SgPointSet::IsEmpty() const
 {
-    return m_a.none();
+    for (int i = 0; i < NU_WORDS; ++i)
+        if (m_a[i] != 0)
+            return false;
+    return true;
 }
 
 inline bool SgPointSet::NonEmpty() const
@@ -353,33 +461,34 @@ inline bool SgPointSet::NonEmpty() const
 inline SgPointSet& SgPointSet::Exclude(SgPoint p)
 {
     SG_ASSERT_BOARDRANGE(p);
-    m_a.reset(p); 
+    m_a[p / WORD_BITS] &= ~(Word(1) << (p % WORD_BITS));
     return (*this);
 }
 
 inline SgPointSet& SgPointSet::Include(SgPoint p)
 {
     SG_ASSERT_BOARDRANGE(p);
-    m_a.set(p);
+    m_a[p / WORD_BITS] |= Word(1) << (p % WORD_BITS);
     return (*this);
 }
 
 inline SgPointSet& SgPointSet::Clear()
 {
-    m_a.reset();
+    std::memset(m_a, 0, sizeof(m_a));
     return *this;
 }
 
 inline SgPointSet& SgPointSet::Toggle(SgPoint p)
 {
-    SG_ASSERT(p < static_cast<int>(m_a.size()));
-    m_a.flip(p);
+    SG_ASSERT(p >= 0 && p < SG_MAXPOINT);
+    m_a[p / WORD_BITS] ^= Word(1) << (p % WORD_BITS);
     return (*this);
 }
 
 inline bool SgPointSet::Contains(SgPoint p) const
 {
-    return m_a.test(p);
+    SG_ASSERT(p >= 0 && p < SG_MAXPOINT);
+    return ((m_a[p / WORD_BITS] >> (p % WORD_BITS)) & 1) != 0;
 }
 
 inline bool SgPointSet::CheckedContains(SgPoint p, bool doRangeCheck,
@@ -394,7 +503,7 @@ inline bool SgPointSet::CheckedContains(SgPoint p, bool doRangeCheck,
             SG_ASSERTRANGE(p, SgPointUtil::Pt(0, 0),
                            SgPointUtil::Pt(SG_MAX_SIZE + 1, SG_MAX_SIZE + 1));
     }
-    return m_a.test(p);
+    return Contains(p);
 }
 
 inline bool SgPointSet::ContainsPoint(SgPoint p) const
@@ -418,20 +527,6 @@ inline bool SgPointSet::NewMark(SgPoint p)
     }
 }
 
-inline SgPointSet SgPointSet::operator>>(int n) const
-{
-    SgPointSet result(*this);
-    result.m_a >>= n;
-    return result;
-}
-
-inline SgPointSet SgPointSet::operator<<(int n) const
-{
-    SgPointSet result(*this);
-    result.m_a <<= n;
-    return result;
-}
-
 //----------------------------------------------------------------------------
 
 /** Iterator to iterate through 'set'.
@@ -461,11 +556,10 @@ private:
 
     const SgPointSet& m_set;
 
+    /** Current point, SG_MAXPOINT at the end of the iteration. */
     int m_index;
 
     void FindNext();
-
-    int Size() const;
 };
 
 inline SgSetIterator::SgSetIterator(const SgPointSet& set)
@@ -477,36 +571,47 @@ inline SgSetIterator::SgSetIterator(const SgPointSet& set)
 
 inline void SgSetIterator::operator++()
 {
-    SG_ASSERT(m_index < Size());
+    SG_ASSERT(m_index < SG_MAXPOINT);
     FindNext();
 }
 
 inline SgPoint SgSetIterator::operator*() const
 {
-    SG_ASSERT(m_index <= Size());
+    SG_ASSERT(m_index < SG_MAXPOINT);
     SG_ASSERT_BOARDRANGE(m_index);
-    SG_ASSERT(m_set.m_a.test(m_index));
+    SG_ASSERT(m_set.Contains(m_index));
     return m_index;
 }
 
 inline SgSetIterator::operator bool() const
 {
-    return m_index < Size();
+    return m_index < SG_MAXPOINT;
 }
 
+/** Find the first point after m_index.
+    Reads the words of the set at each call, so the set may be changed
+    during the iteration like with a bit by bit search. */
 inline void SgSetIterator::FindNext()
 {
-    int size = Size();
-    do
+    const int index = m_index + 1;
+    int i = index / SgPointSet::WORD_BITS;
+    if (i >= SgPointSet::NU_WORDS)
     {
-        ++m_index;
+        m_index = SG_MAXPOINT;
+        return;
     }
-    while (m_index < size && ! m_set.m_a.test(m_index));
-}
-
-inline int SgSetIterator::Size() const
-{
-    return static_cast<int>(m_set.m_a.size());
+    const int shift = index % SgPointSet::WORD_BITS;
+    SgPointSet::Word w = m_set.m_a[i] & (~SgPointSet::Word(0) << shift);
+    while (w == 0)
+    {
+        if (++i == SgPointSet::NU_WORDS)
+        {
+            m_index = SG_MAXPOINT;
+            return;
+        }
+        w = m_set.m_a[i];
+    }
+    m_index = i * SgPointSet::WORD_BITS + SgPointSet::CountTrailingZeros(w);
 }
 
 //----------------------------------------------------------------------------
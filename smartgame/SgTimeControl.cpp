@@ -23,7 +23,12 @@ SgDefaultTimeControl::SgDefaultTimeControl()
     : m_fastOpenFactor(0.25),
       m_fastOpenMoves(0),
       m_minTime(0),
-      m_remainingConstant(1.0)
+      m_remainingConstant(1.0),
+      m_stabilityControl(false),
+      m_stableMinTime(0.25),
+      m_stableCountGap(0.5),
+      m_volatileValueDrop(0.03),
+      m_maxExtension(2.0)
 {
 }
 
@@ -37,6 +42,11 @@ int SgDefaultTimeControl::FastOpenMoves() const
     return m_fastOpenMoves;
 }
 
+double SgDefaultTimeControl::MaxExtension() const
+{
+    return m_maxExtension;
+}
+
 double SgDefaultTimeControl::RemainingConstant() const
 {
     return m_remainingConstant;
@@ -57,11 +67,68 @@ void SgDefaultTimeControl::SetFastOpenMoves(int nummoves)
     m_fastOpenMoves = nummoves;
 }
 
+void SgDefaultTimeControl::SetMaxExtension(double factor)
+{
+    m_maxExtension = factor;
+}
+
 void SgDefaultTimeControl::SetMinTime(double mintime)
 {
     m_minTime = mintime;
 }
 
+void SgDefaultTimeControl::SetStabilityControl(bool enable)
+{
+    m_stabilityControl = enable;
+}
+
+void SgDefaultTimeControl::SetStableCountGap(double fraction)
+{
+    m_stableCountGap = fraction;
+}
+
+void SgDefaultTimeControl::SetStableMinTime(double fraction)
+{
+    m_stableMinTime = fraction;
+}
+
+void SgDefaultTimeControl::SetVolatileValueDrop(double drop)
+{
+    m_volatileValueDrop = drop;
+}
+
+bool SgDefaultTimeControl::StabilityControl() const
+{
+    return m_stabilityControl;
+}
+
+double SgDefaultTimeControl::StableCountGap() const
+{
+    return m_stableCountGap;
+}
+
+double SgDefaultTimeControl::StableMinTime() const
+{
+    return m_stableMinTime;
+}
+
+double SgDefaultTimeControl::VolatileValueDrop() const
+{
+    return m_volatileValueDrop;
+}
+
+double SgDefaultTimeControl::MaxExtendedTime(const SgTimeRecord& time,
+                                             double timeForMove)
+{
+    SgBlackWhite toPlay;
+    int estimatedRemainingMoves;
+    int movesPlayed;
+    GetPositionInfo(toPlay, movesPlayed, estimatedRemainingMoves);
+    double maxTime = m_maxExtension * timeForMove;
+    maxTime = min(maxTime, time.TimeLeft(toPlay) / 2 - time.Overhead());
+    return max(maxTime, timeForMove);
+}
+
 double SgDefaultTimeControl::TimeForCurrentMove(const SgTimeRecord& time,
                                                 bool quiet)
 {
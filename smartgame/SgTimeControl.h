@@ -93,12 +93,65 @@ public:
         the time limit. */
     void SetMinTime(double mintime);
 
+    /** Adjust the time for a move to the stability of the search.
+        This parameter is not used by SgDefaultTimeControl itself, but by
+        players with a search that can monitor its own stability. If
+        enabled, such a search stops before the time returned by
+        TimeForCurrentMove(), if its decision cannot change anymore, and
+        extends it up to MaxExtendedTime(), if its decision is volatile.
+        Default is false. */
+    bool StabilityControl() const;
+
+    /** See StabilityControl() */
+    void SetStabilityControl(bool enable);
+
+    /** Fraction of the time for a move that is used before a stable search
+        stops.
+        Default is 0.25. See StabilityControl() */
+    double StableMinTime() const;
+
+    /** See StableMinTime() */
+    void SetStableMinTime(double fraction);
+
+    /** Fraction of the remaining games that the count gap between the best
+        and second best move must exceed to stop a stable search.
+        A value of 1 stops only if the best move cannot change anymore in the
+        remaining time, smaller values stop earlier.
+        Default is 0.5. See StabilityControl() */
+    double StableCountGap() const;
+
+    /** See StableCountGap() */
+    void SetStableCountGap(double fraction);
+
+    /** Drop of the value of the search that makes a search volatile.
+        Default is 0.03. See StabilityControl() */
+    double VolatileValueDrop() const;
+
+    /** See VolatileValueDrop() */
+    void SetVolatileValueDrop(double drop);
+
+    /** Maximum factor for extending the time for a move.
+        Default is 2. See MaxExtendedTime() */
+    double MaxExtension() const;
+
+    /** See MaxExtension() */
+    void SetMaxExtension(double factor);
+
     // @} // @name Parameters
 
 
     double TimeForCurrentMove(const SgTimeRecord& timeRecord,
                               bool quiet = false);
 
+    /** Maximum time for the current move, if the search is extended.
+        MaxExtension() times the time for the move, but at most half of the
+        remaining time (in the main time or current overtime period), and not
+        less than the time for the move.
+        @param timeRecord Time settings and clock state of current game.
+        @param timeForMove The result of TimeForCurrentMove() */
+    double MaxExtendedTime(const SgTimeRecord& timeRecord,
+                           double timeForMove);
+
     /** Get game-specific information about the current position.
         @param[out] toPlay Current color to move.
         @param[out] movesPlayed Moves already played (by the current player)
@@ -120,6 +173,21 @@ private:
 
     /** See RemainingConstant() */
     double m_remainingConstant;
+
+    /** See StabilityControl() */
+    bool m_stabilityControl;
+
+    /** See StableMinTime() */
+    double m_stableMinTime;
+
+    /** See StableCountGap() */
+    double m_stableCountGap;
+
+    /** See VolatileValueDrop() */
+    double m_volatileValueDrop;
+
+    /** See MaxExtension() */
+    double m_maxExtension;
 };
 
 //----------------------------------------------------------------------------
@@ -55,6 +55,28 @@ bool GetLockFreeDefault()
 #endif
 }
 
+/** Initial value of a move from the view of the player to move.
+    0.5, if the knowledge did not initialize the value of the move. */
+SgUctValue KnowledgeValue(const SgUctMoveInfo& info)
+{
+    if (info.m_count == 0)
+        return SgUctValue(0.5);
+    // m_value is from the view of the opponent like the value of the child
+    // node
+    return SgUctSearch::InverseEstimate(info.m_value);
+}
+
+/** Order of the children in the progressive widening mode.
+    See SgUctSearch::ProgressiveWidening() */
+bool IsHigherPrior(const SgUctMoveInfo& info1, const SgUctMoveInfo& info2)
+{
+    if (info1.m_prior != info2.m_prior)
+        return info1.m_prior > info2.m_prior;
+    if (info1.m_gamma != info2.m_gamma)
+        return info1.m_gamma > info2.m_gamma;
+    return KnowledgeValue(info1) > KnowledgeValue(info2);
+}
+
 /** Get a default value for the tree size.
     The default value is that both trees used by SgUctSearch take no more than
     half of the total amount of memory on the system (but no less than
@@ -226,6 +248,9 @@ void SgUctSearchStat::Clear()
     m_time = 0;
     m_knowledge = 0;
     m_expansions = 0;
+    m_widenings = 0;
+    m_stableStops = 0;
+    m_volatileExtensions = 0;
     m_gamesPerSecond = 0;
     m_gameLength.Clear();
     m_movesInTree.Clear();
@@ -237,6 +262,9 @@ void SgUctSearchStat::Write(std::ostream& out) const
 {
     ios_all_saver saver(out);
     out << SgWriteLabel("Expansions") << m_expansions << '\n'
+        << SgWriteLabel("Widenings") << m_widenings << '\n'
+        << SgWriteLabel("StableStops") << m_stableStops << '\n'
+        << SgWriteLabel("VolatileExt") << m_volatileExtensions << '\n'
         << SgWriteLabel("Time") << setprecision(2) << m_time << '\n'
         << SgWriteLabel("GameLen") << fixed << setprecision(1);
     m_gameLength.Write(out);
@@ -284,9 +312,15 @@ SgUctSearch::SgUctSearch(SgUctThreadStateFactory* threadStateFactory,
       m_raveWeightInitial(0.9f),
       m_raveWeightFinal(20000),
       m_progressiveBiasConstant(0.0f),
+      m_progressiveWidening(false),
+      m_wideningInitial(2),
+      m_wideningBase(40),
+      m_wideningFactor(1.4f),
+      m_deferredExpansion(false),
       m_extendUnstableSearch(true),
       m_virtualLoss(false),
       m_lazyDelete(false),
+      m_rootFocus(SG_NULLMOVE),
       m_logFileName("uctsearch.log"),
       m_fastLog(10),
       m_mpiSynchronizer(SgMpiNullSynchronizer::Create())
@@ -320,6 +354,8 @@ SgUctValue SgUctSearch::GamesPlayed() const
 
 bool SgUctSearch::ExtendUnstableSearch(SgUctThreadState& state)
 {
+    if (m_stability.get() != 0)
+        return ExtendVolatileSearch(state);
     if (m_extendUnstableSearch && ! m_extendedSearch)
     {
         const SgUctNode* countChild 
@@ -337,6 +373,47 @@ bool SgUctSearch::ExtendUnstableSearch(SgUctThreadState& state)
     return false;
 }
 
+/** Extend a volatile search by half of the maximum time.
+    See SgUctStabilityParam */
+bool SgUctSearch::ExtendVolatileSearch(SgUctThreadState& state)
+{
+    const double maxExtendedTime = m_stability->m_maxExtendedTime;
+    if (m_maxTime >= maxExtendedTime
+        || ! IsVolatileSearch(m_timer.GetTime()))
+        return false;
+    m_maxTime = std::min(m_maxTime + m_stabilityMaxTime / 2,
+                         maxExtendedTime);
+    m_statistics.m_volatileExtensions++;
+    Debug(state, str(format("SgUctSearch: extending volatile search to %.1f")
+                     % m_maxTime));
+    return true;
+}
+
+/** Check if a search that is not volatile can be stopped.
+    See SgUctStabilityParam */
+bool SgUctSearch::IsStableSearch(SgUctThreadState& state, double time) const
+{
+    if (time < m_stability->m_minTime * m_stabilityMaxTime
+        || time < numeric_limits<double>::epsilon()
+        || IsVolatileSearch(time))
+        return false;
+    double gamesPerSecond = GamesPlayed() / time;
+    double remainingGames = (m_maxTime - time) * gamesPerSecond;
+    return CheckCountAbort(state,
+                     SgUctValue(m_stability->m_countGap * remainingGames));
+}
+
+/** See SgUctStabilityParam */
+bool SgUctSearch::IsVolatileSearch(double time) const
+{
+    if (time - m_stableMoveTime < time / 2
+        || m_valueTrend < -m_stability->m_valueDrop)
+        return true;
+    const SgUctNode& root = m_tree.Root();
+    return (FindBestChild(root, SG_UCTMOVESELECT_COUNT)
+            != FindBestChild(root, SG_UCTMOVESELECT_VALUE));
+}
+
 bool SgUctSearch::CheckAbortSearch(SgUctThreadState& state)
 {
     if (SgUserAbort())
@@ -377,6 +454,17 @@ bool SgUctSearch::CheckAbortSearch(SgUctThreadState& state)
     {
         m_nextCheckTime = GamesPlayed() + m_checkTimeInterval;
         double time = m_timer.GetTime();
+        if (m_stability.get() != 0)
+        {
+            UpdateStability(time);
+            // Past the maximum time, only the extension below applies
+            if (time < m_maxTime && IsStableSearch(state, time))
+            {
+                m_statistics.m_stableStops++;
+                Debug(state, "SgUctSearch: stable search");
+                return true;
+            }
+        }
 
         if (time > m_maxTime)
         {
@@ -503,6 +591,10 @@ void SgUctSearch::DeleteThreads()
     @param node The node to expand. */
 void SgUctSearch::ExpandNode(SgUctThreadState& state, const SgUctNode& node)
 {
+    if (m_progressiveWidening)
+        stable_sort(state.m_moves.begin(), state.m_moves.end(),
+                    IsHigherPrior);
+    const int nuDeferred = DeferMoves(node, state.m_moves);
     unsigned int threadId = state.m_threadId;
     if (! m_tree.HasCapacity(threadId, state.m_moves.size()))
     {
@@ -513,9 +605,23 @@ void SgUctSearch::ExpandNode(SgUctThreadState& state, const SgUctNode& node)
         SgSynchronizeThreadMemory();
         return;
     }
+    m_tree.SetNuDeferredChildren(node, nuDeferred);
     m_tree.CreateChildren(threadId, node, state.m_moves);
 }
 
+/** Find the child of the root with the move RootFocus().
+    @return The child or 0, if the root has no such child */
+const SgUctNode* SgUctSearch::FindRootFocus() const
+{
+    const SgUctNode& root = m_tree.Root();
+    if (! root.HasChildren())
+        return 0;
+    for (SgUctChildIterator it(m_tree, root); it; ++it)
+        if ((*it).Move() == m_rootFocus)
+            return &(*it);
+    return 0;
+}
+
 const SgUctNode*
 SgUctSearch::FindBestChild(const SgUctNode& node,
                            SgUctMoveSelect moveSelect,
@@ -674,6 +780,11 @@ SgUctTree& SgUctSearch::GetTempTree()
     return m_tempTree;
 }
 
+void SgUctSearch::SwapTree(SgUctTree& tree)
+{
+    m_tree.Swap(tree);
+}
+
 SgUctValue SgUctSearch::GetValueEstimate(bool useRave, const SgUctNode& child) const
 {
     SgUctValue value = 0;
@@ -833,11 +944,16 @@ void SgUctSearch::CreateChildren(SgUctThreadState& state,
                                  const SgUctNode& node,
                                  bool deleteChildTrees)
 {
+    if (m_progressiveWidening)
+        stable_sort(state.m_moves.begin(), state.m_moves.end(),
+                    IsHigherPrior);
+    const int nuDeferred = DeferMoves(node, state.m_moves);
     // If not adding any new children then no need to allocate a new set
     // of children, just mark pruned children as proven losses. 
     if (! AddingNewChildren(node, state.m_moves))
     {
         m_tree.SetMustplay(node, state.m_moves, deleteChildTrees);
+        m_tree.SetNuDeferredChildren(node, nuDeferred);
         return;
     } 
     unsigned int threadId = state.m_threadId;
@@ -850,9 +966,48 @@ void SgUctSearch::CreateChildren(SgUctThreadState& state,
         SgSynchronizeThreadMemory();
         return;
     }
+    m_tree.SetNuDeferredChildren(node, nuDeferred);
     m_tree.MergeChildren(threadId, node, state.m_moves, deleteChildTrees);
 }
 
+/** Remove the moves that do not get a child node in the deferred expansion
+    mode.
+    Keeps all moves that already have a child node and the first other moves
+    until the number of moves reaches the current widening width of the node.
+    The existing children must be kept, because CreateChildren() would
+    otherwise prune them or mark them as losing moves.
+    @param node The node
+    @param moves The moves, sorted as in the progressive widening mode
+    @return The number of removed moves */
+int SgUctSearch::DeferMoves(const SgUctNode& node,
+                            vector<SgUctMoveInfo>& moves) const
+{
+    if (! m_progressiveWidening || ! m_deferredExpansion
+        || &node == &m_tree.Root())
+        return 0;
+    const int width = WideningWidth(node.PosCount());
+    if (moves.size() <= static_cast<size_t>(width))
+        return 0;
+    vector<bool> hasChild(moves.size(), false);
+    int nuNew = width;
+    if (node.HasChildren())
+        for (size_t i = 0; i < moves.size(); ++i)
+            for (SgUctChildIterator it(m_tree, node); it; ++it)
+                if ((*it).Move() == moves[i].m_move)
+                {
+                    hasChild[i] = true;
+                    --nuNew;
+                    break;
+                }
+    size_t nuKept = 0;
+    for (size_t i = 0; i < moves.size(); ++i)
+        if (hasChild[i] || nuNew-- > 0)
+            moves[nuKept++] = moves[i];
+    const int nuDeferred = int(moves.size() - nuKept);
+    moves.resize(nuKept);
+    return nuDeferred;
+}
+
 bool SgUctSearch::NeedToComputeKnowledge(const SgUctNode* current)
 {
     if (m_knowledgeThreshold.empty())
@@ -877,6 +1032,64 @@ bool SgUctSearch::NeedToComputeKnowledge(const SgUctNode* current)
     return false;
 }
 
+/** Check if a node with deferred children needs more children.
+    See DeferredExpansion(). The root always gets all children, for example
+    if it was a node with deferred children in the tree of a previous search,
+    and so does any node if the deferred expansion was disabled.
+    @param node The node
+    @param[out] nuDeferred The number of deferred children of the node, which
+    is set to 0 in the tree, if the node needs to be widened. */
+bool SgUctSearch::NeedToWiden(const SgUctNode& node, int& nuDeferred)
+{
+    nuDeferred = node.NuDeferredChildren();
+    if (nuDeferred == 0)
+        return false;
+    if (&node != &m_tree.Root() && m_progressiveWidening
+        && m_deferredExpansion
+        && WideningWidth(node.PosCount()) <= node.NuChildren())
+        return false;
+    // Mark immediately so other threads do not widen the same node
+    m_tree.SetNuDeferredChildren(node, 0);
+    return true;
+}
+
+/** Create more children of a node with deferred children.
+    The moves are generated again and merged with the existing children.
+    The moves that already have a child keep the statistics of the child
+    only, the initialization by the prior knowledge is not added again.
+    @param state The thread state
+    @param node The node
+    @param nuDeferred The number of deferred children before NeedToWiden(),
+    restored if no children can be created */
+void SgUctSearch::WidenNode(SgUctThreadState& state, const SgUctNode& node,
+                            int nuDeferred)
+{
+    state.m_moves.clear();
+    SgUctProvenType provenType = SG_NOT_PROVEN;
+    state.GenerateAllMoves(0, state.m_moves, provenType);
+    if (&node == &m_tree.Root())
+        ApplyRootFilter(state.m_moves);
+    if (state.m_moves.empty())
+    {
+        m_tree.SetNuDeferredChildren(node, nuDeferred);
+        return;
+    }
+    for (vector<SgUctMoveInfo>::iterator it = state.m_moves.begin();
+         it != state.m_moves.end(); ++it)
+        for (SgUctChildIterator child(m_tree, node); child; ++child)
+            if ((*child).Move() == it->m_move)
+            {
+                it->m_value = 0;
+                it->m_count = 0;
+                it->m_raveValue = 0;
+                it->m_raveCount = 0;
+                break;
+            }
+    CreateChildren(state, node, false);
+    if (state.m_isTreeOutOfMem)
+        m_tree.SetNuDeferredChildren(node, nuDeferred);
+}
+
 void SgUctSearch::OnStartSearch()
 {
     m_mpiSynchronizer->OnStartSearch(*this);
@@ -1063,6 +1276,7 @@ bool SgUctSearch::PlayInTree(SgUctThreadState& state, bool& isTerminal)
     bool breakAfterSelect = false;
     isTerminal = false;
     bool useBiasTerm = false;
+    int nuDeferred;
     if (--state.m_randomizeBiasCounter == 0) {
         useBiasTerm = true;
         state.m_randomizeBiasCounter = m_biasTermFrequency;
@@ -1137,8 +1351,20 @@ bool SgUctSearch::PlayInTree(SgUctThreadState& state, bool& isTerminal)
                 return true;
             breakAfterSelect = true;
         }
+        else if (NeedToWiden(*current, nuDeferred))
+        {
+            m_statistics.m_widenings++;
+            WidenNode(state, *current, nuDeferred);
+            if (state.m_isTreeOutOfMem)
+                return true;
+        }
         // Select next tree move.
-        if (m_lazyDelete)
+        const SgUctNode* focus = 0;
+        if (current == root && m_rootFocus != SG_NULLMOVE)
+            focus = FindRootFocus();
+        if (focus != 0)
+            current = focus;
+        else if (m_lazyDelete)
         {
             // Lazy delete is on: select a child and ask derived class
             // if it's still valid, if it isn't then mark it as a loss
@@ -1227,7 +1453,8 @@ SgUctValue SgUctSearch::Search(SgUctValue maxGames, double maxTime,
                                vector<SgMove>& sequence,
                                const vector<SgMove>& rootFilter,
                                SgUctTree* initTree,
-                               SgUctEarlyAbortParam* earlyAbort)
+                               SgUctEarlyAbortParam* earlyAbort,
+                               SgUctStabilityParam* stability)
 {
     m_timer.Start();
     m_rootFilter = rootFilter;
@@ -1241,6 +1468,10 @@ SgUctValue SgUctSearch::Search(SgUctValue maxGames, double maxTime,
     m_earlyAbort.reset(0);
     if (earlyAbort != 0)
         m_earlyAbort.reset(new SgUctEarlyAbortParam(*earlyAbort));
+    m_stability.reset(0);
+    if (stability != 0)
+        m_stability.reset(new SgUctStabilityParam(*stability));
+    m_stabilityMaxTime = maxTime;
 
     for (size_t i = 0; i < m_threads.size(); ++i)
     {
@@ -1428,11 +1659,18 @@ const SgUctNode& SgUctSearch::SelectChild(int& randomizeCounter,
         posCount = 1;
     }
     SgUctValue logPosCount = Log(posCount);
+    // Children beyond the width are only selected if all children within
+    // the width are losing
+    const int width = (m_progressiveWidening ? WideningWidth(posCount)
+                                             : numeric_limits<int>::max());
     const SgUctNode* bestChild = 0;
     SgUctValue bestUpperBound = 0;
     const SgUctValue epsilon = SgUctValue(1e-7);
-    for (SgUctChildIterator it(m_tree, node); it; ++it)
+    int i = 0;
+    for (SgUctChildIterator it(m_tree, node); it; ++it, ++i)
     {
+        if (i >= width && bestChild != 0)
+            break;
         const SgUctNode& child = *it;
         if (! child.IsProvenWin()) // Avoid losing moves
         {
@@ -1459,6 +1697,15 @@ const SgUctNode& SgUctSearch::SelectChild(int& randomizeCounter,
     return *node.FirstChild();
 }
 
+int SgUctSearch::WideningWidth(SgUctValue posCount) const
+{
+    int width = m_wideningInitial;
+    if (posCount >= m_wideningBase)
+        width += 1 + static_cast<int>(Log(posCount / m_wideningBase)
+                                      / Log(m_wideningFactor));
+    return width;
+}
+
 void SgUctSearch::SetNumberThreads(unsigned int n)
 {
     SG_ASSERT(n >= 1);
@@ -1521,6 +1768,10 @@ void SgUctSearch::StartSearch(const vector<SgMove>& rootFilter,
     m_aborted = false;
     m_wasEarlyAbort = false;
     m_extendedSearch = false;
+    m_stableMove = SG_NULLMOVE;
+    m_stableMoveTime = 0;
+    m_valueSampleTime = -1;
+    m_valueTrend = 0;
     if (! SgDeterministic::DeterministicMode())
        m_checkTimeInterval = 1;
     m_numberGames = 0;
@@ -1581,6 +1832,30 @@ void SgUctSearch::UpdateCheckTimeInterval(double time)
         m_checkTimeInterval = 1;
 }
 
+/** Update the state of the root monitored for SgUctStabilityParam.
+    @param time The time of the search */
+void SgUctSearch::UpdateStability(double time)
+{
+    const SgUctNode& root = m_tree.Root();
+    const SgUctNode* bestChild = FindBestChild(root, SG_UCTMOVESELECT_COUNT);
+    SgMove bestMove = (bestChild == 0 ? SG_NULLMOVE : bestChild->Move());
+    if (bestMove != m_stableMove)
+    {
+        m_stableMove = bestMove;
+        m_stableMoveTime = time;
+    }
+    if (root.HasMean()
+        && (m_valueSampleTime < 0
+            || time - m_valueSampleTime >= m_stabilityMaxTime / 10))
+    {
+        SgUctValue value = SgUctValue(root.Mean());
+        if (m_valueSampleTime >= 0)
+            m_valueTrend = value - m_valueSample;
+        m_valueSample = value;
+        m_valueSampleTime = time;
+    }
+}
+
 /** Update the RAVE values in the tree for both players after a game was
     played.
     @see SgUctSearch::Rave() */
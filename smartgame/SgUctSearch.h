@@ -431,6 +431,18 @@ struct SgUctSearchStat
 
     SgUctValue m_expansions;
 
+    /** Number of nodes that got more children in the deferred expansion
+        mode. See SgUctSearch::DeferredExpansion() */
+    SgUctValue m_widenings;
+
+    /** Number of searches stopped early, because they were stable.
+        See SgUctStabilityParam */
+    SgUctValue m_stableStops;
+
+    /** Number of extensions of volatile searches.
+        See SgUctStabilityParam */
+    SgUctValue m_volatileExtensions;
+
     /** Games per second.
         Useful values only if search time is higher than resolution of
         SgTime::Get(). */
@@ -472,6 +484,37 @@ struct SgUctEarlyAbortParam
 
 //----------------------------------------------------------------------------
 
+/** Optional parameters to SgUctSearch::Search() for adjusting the search
+    time to the stability of the search.
+    The search monitors the root at its regular time checks. The search is
+    volatile, if the child with the highest count changed during the last
+    half of the search time, if it is not the child with the highest value,
+    or if the value of the root dropped by more than m_valueDrop in the last
+    tenth of the maximum time. A search that is not volatile is stopped
+    after a fraction m_minTime of the maximum time, if the count gap
+    between the best and second best child is larger than a fraction
+    m_countGap of the games that can be played in the remaining time. A
+    volatile search is extended beyond the maximum time in steps of half the
+    maximum time up to m_maxExtendedTime. If used, this replaces the
+    extension of SgUctSearch::ExtendUnstableSearch(). */
+struct SgUctStabilityParam
+{
+    /** Fraction of the maximum time that is used before a stable search is
+        stopped. */
+    double m_minTime;
+
+    /** Fraction of the remaining games that the count gap must exceed. */
+    SgUctValue m_countGap;
+
+    /** Drop of the value of the root that makes the search volatile. */
+    SgUctValue m_valueDrop;
+
+    /** Maximum time in seconds including the extensions. */
+    double m_maxExtendedTime;
+};
+
+//----------------------------------------------------------------------------
+
 /** Monte Carlo tree search using UCT.
     The evaluation function is assumed to be in <code>[0..1]</code> and
     inverted with <code>1 - eval</code>.
@@ -589,13 +632,16 @@ public:
         initialization. The trees are actually swapped, not copied.
         @param earlyAbort See SgUctEarlyAbortParam. Null means not to do an
         early abort.
+        @param stability See SgUctStabilityParam. Null means not to adjust
+        the time to the stability of the search.
         @return The value of the root position. */
     SgUctValue Search(SgUctValue maxGames, double maxTime,
                       std::vector<SgMove>& sequence,
                       const std::vector<SgMove>& rootFilter
                       = std::vector<SgMove>(),
                       SgUctTree* initTree = 0,
-                      SgUctEarlyAbortParam* earlyAbort = 0);
+                      SgUctEarlyAbortParam* earlyAbort = 0,
+                      SgUctStabilityParam* stability = 0);
 
     /** Do a one-ply Monte Carlo search instead of the UCT search.
         @param maxGames
@@ -656,6 +702,13 @@ public:
         used by other code while the search is not running. */
     SgUctTree& GetTempTree();
 
+    /** Swap the tree of the search with another tree.
+        The other tree must be compatible with the tree of the search (see
+        GetTempTree()). Can be used to pass the current tree as the init tree
+        to Search() without copying it. Must not be called during a search.
+        */
+    void SwapTree(SgUctTree& tree);
+
     // @} // name
 
 
@@ -688,6 +741,66 @@ public:
     /** See ProgressiveBiasConstant() */
     void SetProgressiveBiasConstant(SgUctValue value);
 
+    /** Progressive widening by the ranks of the priors.
+        If enabled, the children of a node are created sorted by decreasing
+        SgUctMoveInfo::m_prior (ties by m_gamma, see below) and only the first
+        WideningInitial() children can be selected. Another child can be
+        selected each time the position count of the node reaches the next
+        threshold WideningBase() * WideningFactor()^i, i = 0, 1, 2...
+        The other children are only selected if all children that can be
+        selected are proven wins for the opponent. Moves with the same prior
+        (e.g. all moves, if the knowledge does not set priors, like
+        GoUctDefaultPriorKnowledge) are ordered by the initial value of the
+        knowledge (SgUctMoveInfo::m_value), moves without initial value
+        count as 0.5. Only moves without any knowledge keep the order of
+        SgUctThreadState::GenerateAllMoves(). Default is false. */
+    bool ProgressiveWidening() const;
+
+    /** See ProgressiveWidening() */
+    void SetProgressiveWidening(bool enable);
+
+    /** Number of children that can be selected before the first threshold.
+        See ProgressiveWidening(). Default is 2. */
+    int WideningInitial() const;
+
+    /** See WideningInitial() */
+    void SetWideningInitial(int width);
+
+    /** First threshold of the position count.
+        See ProgressiveWidening(). Default is 40. */
+    SgUctValue WideningBase() const;
+
+    /** See WideningBase() */
+    void SetWideningBase(SgUctValue base);
+
+    /** Ratio of subsequent thresholds of the position count.
+        Must be greater than 1. See ProgressiveWidening(). Default is 1.4. */
+    SgUctValue WideningFactor() const;
+
+    /** See WideningFactor() */
+    void SetWideningFactor(SgUctValue factor);
+
+    /** Create only the children that can be selected.
+        In the progressive widening mode, a node that is expanded gets child
+        nodes only for the moves within the current widening width and
+        remembers the number of the other moves. If the width grows beyond
+        the number of children, the moves are generated again and the new
+        children are merged with the existing ones. Since most nodes are
+        visited only a few times after the expansion, the tree holds many
+        more positions with the same maximum number of nodes. The children
+        of the root are always created. With deferred expansion, the children
+        beyond the width are not selected even if all children within the
+        width are losing. Only used if ProgressiveWidening() is true.
+        Default is false. */
+    bool DeferredExpansion() const;
+
+    /** See DeferredExpansion() */
+    void SetDeferredExpansion(bool enable);
+
+    /** Number of children of a node with a position count that can be
+        selected in the progressive widening mode. */
+    int WideningWidth(SgUctValue posCount) const;
+
     /** Extends search in unstable positions.
         An unstable position is one in which the move with the highest
         count is not the same as the move with the best value, as
@@ -868,6 +981,17 @@ public:
     /** See LazyDelete() */
     void SetLazyDelete(bool enable);
 
+    /** Restrict the games to the subtree of one child of the root.
+        If not SG_NULLMOVE and the root has a child with this move, all
+        games start with this move; the other children of the root and
+        their subtrees are kept unchanged. Used for pondering on a predicted
+        move of the opponent without losing the subtrees of the other
+        predicted moves. Default is SG_NULLMOVE. */
+    SgMove RootFocus() const;
+
+    /** See RootFocus() */
+    void SetRootFocus(SgMove move);
+
     /** Prune nodes with low counts if tree is full.
         This will prune nodes below a minimum count, if the tree gets full
         during a search. The minimum count is PruneMinCount() at the beginning
@@ -1019,6 +1143,33 @@ private:
         The auto pointer is empty, if no early abort is used. */
     std::auto_ptr<SgUctEarlyAbortParam> m_earlyAbort;
 
+    /** See SgUctStabilityParam.
+        The auto pointer is empty, if the time is not adjusted to the
+        stability of the search. */
+    std::auto_ptr<SgUctStabilityParam> m_stability;
+
+    /** Maximum time of the current search before extensions.
+        See SgUctStabilityParam */
+    double m_stabilityMaxTime;
+
+    /** Child of the root with the highest count at the last time check.
+        See SgUctStabilityParam */
+    SgMove m_stableMove;
+
+    /** Time at which m_stableMove became the child with the highest count.
+        */
+    double m_stableMoveTime;
+
+    /** Value of the root at m_valueSampleTime.
+        See SgUctStabilityParam */
+    SgUctValue m_valueSample;
+
+    /** Time of m_valueSample, negative if there is no sample yet. */
+    double m_valueSampleTime;
+
+    /** Change of the value of the root between the last two samples. */
+    SgUctValue m_valueTrend;
+
     /** See SgUctMoveSelect */
     SgUctMoveSelect m_moveSelect;
 
@@ -1103,6 +1254,21 @@ private:
     /** See ProgressiveBiasConstant() */
     SgUctValue m_progressiveBiasConstant;
 
+    /** See ProgressiveWidening() */
+    bool m_progressiveWidening;
+
+    /** See WideningInitial() */
+    int m_wideningInitial;
+
+    /** See WideningBase() */
+    SgUctValue m_wideningBase;
+
+    /** See WideningFactor() */
+    SgUctValue m_wideningFactor;
+
+    /** See DeferredExpansion() */
+    bool m_deferredExpansion;
+
     bool m_extendUnstableSearch;
 
     bool m_extendedSearch;
@@ -1116,6 +1282,9 @@ private:
     /** See LazyDelete() */
     bool m_lazyDelete;
 
+    /** See RootFocus() */
+    SgMove m_rootFocus;
+
     std::string m_logFileName;
 
     SgTimer m_timer;
@@ -1169,12 +1338,23 @@ private:
 
     bool ExtendUnstableSearch(SgUctThreadState& state);
 
+    bool ExtendVolatileSearch(SgUctThreadState& state);
+
+    bool IsStableSearch(SgUctThreadState& state, double time) const;
+
+    bool IsVolatileSearch(double time) const;
+
+    const SgUctNode* FindRootFocus() const;
+
     bool AddingNewChildren(const SgUctNode& node,
                            const std::vector<SgUctMoveInfo>& moves) const;
 
     void CreateChildren(SgUctThreadState& state, const SgUctNode& node,
                         bool deleteChildTrees);
 
+    int DeferMoves(const SgUctNode& node,
+                   std::vector<SgUctMoveInfo>& moves) const;
+
     SgUctValue GetBound(bool useRave, bool useBiasTerm,
                    SgUctValue logPosCount, 
                    const SgUctNode& child) const;
@@ -1188,6 +1368,11 @@ private:
 
     bool NeedToComputeKnowledge(const SgUctNode* current);
 
+    bool NeedToWiden(const SgUctNode& node, int& nuDeferred);
+
+    void WidenNode(SgUctThreadState& state, const SgUctNode& node,
+                   int nuDeferred);
+
     void PlayGame(SgUctThreadState& state, GlobalLock* lock);
 
     bool PlayInTree(SgUctThreadState& state, bool& isTerminal);
@@ -1204,6 +1389,8 @@ private:
 
     void UpdateCheckTimeInterval(double time);
 
+    void UpdateStability(double time);
+
     void UpdateDynRaveBias();
 
     void UpdateRaveValues(SgUctThreadState& state);
@@ -1235,6 +1422,59 @@ inline void SgUctSearch::SetProgressiveBiasConstant(SgUctValue value)
     m_progressiveBiasConstant = value;
 }
 
+inline bool SgUctSearch::ProgressiveWidening() const
+{
+    return m_progressiveWidening;
+}
+
+inline void SgUctSearch::SetProgressiveWidening(bool enable)
+{
+    m_progressiveWidening = enable;
+}
+
+inline bool SgUctSearch::DeferredExpansion() const
+{
+    return m_deferredExpansion;
+}
+
+inline void SgUctSearch::SetDeferredExpansion(bool enable)
+{
+    m_deferredExpansion = enable;
+}
+
+inline SgUctValue SgUctSearch::WideningBase() const
+{
+    return m_wideningBase;
+}
+
+inline void SgUctSearch::SetWideningBase(SgUctValue base)
+{
+    SG_ASSERT(base > 0);
+    m_wideningBase = base;
+}
+
+inline SgUctValue SgUctSearch::WideningFactor() const
+{
+    return m_wideningFactor;
+}
+
+inline void SgUctSearch::SetWideningFactor(SgUctValue factor)
+{
+    SG_ASSERT(factor > 1);
+    m_wideningFactor = factor;
+}
+
+inline int SgUctSearch::WideningInitial() const
+{
+    return m_wideningInitial;
+}
+
+inline void SgUctSearch::SetWideningInitial(int width)
+{
+    SG_ASSERT(width >= 1);
+    m_wideningInitial = width;
+}
+
 inline bool SgUctSearch::ExtendUnstableSearch() const
 {
     return m_extendUnstableSearch;
@@ -1532,6 +1772,16 @@ inline void SgUctSearch::SetLazyDelete(bool enable)
     m_lazyDelete = enable;
 }
 
+inline SgMove SgUctSearch::RootFocus() const
+{
+    return m_rootFocus;
+}
+
+inline void SgUctSearch::SetRootFocus(SgMove move)
+{
+    m_rootFocus = move;
+}
+
 inline const SgUctSearchStat& SgUctSearch::Statistics() const
 {
     return m_statistics;
@@ -307,7 +307,7 @@ void SgUctTree::DumpDebugInfo(std::ostream& out) const
             << " finish=" << Allocator(i).Finish() << '\n';
 }
 
-void SgUctTree::ExtractSubtree(SgUctTree& target, const SgUctNode& node,
+bool SgUctTree::ExtractSubtree(SgUctTree& target, const SgUctNode& node,
                                bool warnTruncate, double maxTime,
                                SgUctValue minCount) const
 {
@@ -321,6 +321,7 @@ void SgUctTree::ExtractSubtree(SgUctTree& target, const SgUctNode& node,
     CopySubtree(target, target.m_root, node, minCount, allocatorId, warnTruncate,
                 abort, timer, maxTime, /* alwaysKeepProven */ true);
     SgSynchronizeThreadMemory();
+    return ! abort;
 }
 
 void SgUctTree::SetMustplay(const SgUctNode& node,
@@ -400,6 +401,8 @@ void SgUctTree::MergeChildren(std::size_t allocatorId, const SgUctNode& node,
                     parentCount += oldChild.MoveCount();
                     if (oldChild.HasChildren())
                     {
+                        newChild->SetNuDeferredChildren(
+                                              oldChild.NuDeferredChildren());
                         newChild->SetFirstChild(oldChild.FirstChild());
                         newChild->SetNuChildren(oldChild.NuChildren());
                     }
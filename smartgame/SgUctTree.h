@@ -249,6 +249,16 @@ public:
     /** Set that knowledge has been computed at count. */
     void SetKnowledgeCount(SgUctValue count);
 
+    /** Number of legal moves that have no child node yet.
+        Used by the deferred expansion of SgUctSearch, which creates only the
+        children within the progressive widening width. The moves are not
+        stored, they are generated again when the width grows.
+        @see SgUctSearch::DeferredExpansion() */
+    int NuDeferredChildren() const;
+
+    /** See NuDeferredChildren() */
+    void SetNuDeferredChildren(int nuDeferredChildren);
+
     /** Returns true if node is a proven node. */
     bool IsProven() const;
 
@@ -282,6 +292,8 @@ private:
 
     volatile int m_virtualLossCount;
 
+    volatile int m_nuDeferredChildren;
+
     volatile SgUctValue m_prior;
 
     volatile SgUctValue m_gamma;
@@ -296,6 +308,7 @@ inline SgUctNode::SgUctNode(const SgUctMoveInfo& info)
       m_knowledgeCount(0),
       m_provenType(SG_NOT_PROVEN),
       m_virtualLossCount(0),
+      m_nuDeferredChildren(0),
       m_prior(info.m_prior),
       m_gamma(info.m_gamma)
 {
@@ -356,6 +369,7 @@ inline void SgUctNode::CopyDataFrom(const SgUctNode& node)
     m_knowledgeCount = node.m_knowledgeCount;
     m_provenType = node.m_provenType;
     m_virtualLossCount = node.m_virtualLossCount;
+    m_nuDeferredChildren = node.m_nuDeferredChildren;
     m_prior = node.m_prior;
     m_gamma = node.m_gamma;
 }
@@ -534,6 +548,16 @@ inline void SgUctNode::SetKnowledgeCount(SgUctValue count)
     m_knowledgeCount = count;
 }
 
+inline int SgUctNode::NuDeferredChildren() const
+{
+    return m_nuDeferredChildren;
+}
+
+inline void SgUctNode::SetNuDeferredChildren(int nuDeferredChildren)
+{
+    m_nuDeferredChildren = nuDeferredChildren;
+}
+
 inline bool SgUctNode::IsProven() const
 {
     return m_provenType != SG_NOT_PROVEN;
@@ -757,6 +781,9 @@ public:
 
     void SetKnowledgeCount(const SgUctNode& node, SgUctValue count);
 
+    /** See SgUctNode::NuDeferredChildren() */
+    void SetNuDeferredChildren(const SgUctNode& node, int nuDeferredChildren);
+
     void Clear();
 
     /** Return the current maximum number of nodes.
@@ -807,8 +834,9 @@ public:
         @param warnTruncate Print warning to SgDebug() if tree was truncated
         @param maxTime Truncate the tree, if the extraction takes longer than
         the given time
-        @param minCount */
-    void ExtractSubtree(SgUctTree& target, const SgUctNode& node,
+        @param minCount
+        @return @c false, if the tree was truncated */
+    bool ExtractSubtree(SgUctTree& target, const SgUctNode& node,
                    bool warnTruncate,
                    double maxTime = std::numeric_limits<double>::max(),
                    SgUctValue minCount = 0) const;
@@ -1097,6 +1125,15 @@ inline void SgUctTree::SetKnowledgeCount(const SgUctNode& node,
     const_cast<SgUctNode&>(node).SetKnowledgeCount(count);
 }
 
+inline void SgUctTree::SetNuDeferredChildren(const SgUctNode& node,
+                                             int nuDeferredChildren)
+{
+    SG_ASSERT(Contains(node));
+    // Parameters are const-references, because only the tree is allowed
+    // to modify nodes
+    const_cast<SgUctNode&>(node).SetNuDeferredChildren(nuDeferredChildren);
+}
+
 inline void SgUctTree::SetPosCount(const SgUctNode& node,
                                    SgUctValue posCount)
 {
@@ -76,7 +76,7 @@ std::ostream& operator<<(ostream& out, const SgUctTreeStatistics& stat)
 
 //----------------------------------------------------------------------------
 
-void SgUctTreeUtil::ExtractSubtree(const SgUctTree& tree, SgUctTree& target,
+bool SgUctTreeUtil::ExtractSubtree(const SgUctTree& tree, SgUctTree& target,
                                    const std::vector<SgMove>& sequence,
                                    bool warnTruncate, double maxTime,
                                    SgUctValue minCount)
@@ -89,9 +89,10 @@ void SgUctTreeUtil::ExtractSubtree(const SgUctTree& tree, SgUctTree& target,
         SgMove mv = *it;
         node = SgUctTreeUtil::FindChildWithMove(tree, *node, mv);
         if (node == 0)
-            return;
+            return true;
     }
-    tree.ExtractSubtree(target, *node, warnTruncate, maxTime, minCount);
+    return tree.ExtractSubtree(target, *node, warnTruncate, maxTime,
+                               minCount);
 }
 
 const SgUctNode* SgUctTreeUtil::FindChildWithMove(const SgUctTree& tree,
@@ -61,8 +61,9 @@ namespace SgUctTreeUtil
         @param sequence The sequence of moves.
         @param warnTruncate See SgUctTree::ExtractSubtree
         @param maxTime See SgUctTree::ExtractSubtree
-        @param minCount */
-    void ExtractSubtree(const SgUctTree& tree, SgUctTree& target,
+        @param minCount
+        @return @c false, if the subtree was truncated */
+    bool ExtractSubtree(const SgUctTree& tree, SgUctTree& target,
                         const std::vector<SgMove>& sequence,
                         bool warnTruncate,
                         double maxTime = std::numeric_limits<double>::max(),
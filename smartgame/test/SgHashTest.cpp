@@ -41,6 +41,17 @@ BOOST_AUTO_TEST_CASE(SgHashCodeTest_Constructor2)
     BOOST_CHECK(hash1 != hash2);
 }
 
+/** Test Code1() and Code2() of a 128-bit hash code with bits set above the
+    first 64 bits. */
+BOOST_AUTO_TEST_CASE(SgHashCodeTest_Code_128)
+{
+    SgHash<128> hash;
+    hash.FromString("ffffffffffffffff0000000200000001");
+    BOOST_CHECK_EQUAL(hash.Code1(), 1u);
+    BOOST_CHECK_EQUAL(hash.Code2(), 2u);
+    BOOST_CHECK_EQUAL(hash.ToString(), "ffffffffffffffff0000000200000001");
+}
+
 BOOST_AUTO_TEST_CASE(SgHashCodeTest_Random)
 {
     SgHashCode hash = SgHashCode::Random();
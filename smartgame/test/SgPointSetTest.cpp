@@ -7,7 +7,9 @@
 
 #include <sstream>
 #include <boost/test/auto_unit_test.hpp>
+#include "SgNbIterator.h"
 #include "SgPointSet.h"
+#include "SgRandom.h"
 
 using namespace std;
 using SgPointUtil::Pt;
@@ -16,6 +18,89 @@ using SgPointUtil::Pt;
 
 namespace {
 
+/** Random set of points on a board, each point included with
+    probability percent / 100. */
+SgPointSet RandomSet(SgRandom& random, int boardSize, int percent)
+{
+    SgPointSet set;
+    for (int row = 1; row <= boardSize; ++row)
+        for (int col = 1; col <= boardSize; ++col)
+            if (random.Int(100) < percent)
+                set.Include(Pt(col, row));
+    return set;
+}
+
+/** Border of a set computed point by point. */
+SgPointSet SimpleBorder(const SgPointSet& set, int boardSize, bool nb8)
+{
+    SgPointSet result;
+    for (int row = 1; row <= boardSize; ++row)
+        for (int col = 1; col <= boardSize; ++col)
+        {
+            SgPoint p = Pt(col, row);
+            if (set.Contains(p))
+                continue;
+            if (nb8 ? set.Adjacent8To(p) : set.AdjacentTo(p))
+                result.Include(p);
+        }
+    return result;
+}
+
+/** Check the word-based operations against point by point versions. */
+void CheckSameAsSimple(const SgPointSet& a, const SgPointSet& b,
+                       int boardSize)
+{
+    int size = 0;
+    int overlap = 0;
+    SgPoint first = SG_NULLPOINT;
+    SgVector<SgPoint> points;
+    for (SgPoint p = 0; p < SG_MAXPOINT; ++p)
+        if (a.Contains(p))
+        {
+            ++size;
+            if (first == SG_NULLPOINT)
+                first = p;
+            points.PushBack(p);
+            if (b.Contains(p))
+                ++overlap;
+        }
+    BOOST_CHECK_EQUAL(a.Size(), size);
+    BOOST_CHECK_EQUAL(a.PointOf(), first);
+    BOOST_CHECK_EQUAL(a.IsEmpty(), size == 0);
+    BOOST_CHECK(a.MinSetSize(size));
+    BOOST_CHECK(! a.MinSetSize(size + 1));
+    BOOST_CHECK(a.MaxSetSize(size));
+    BOOST_CHECK(size == 0 || ! a.MaxSetSize(size - 1));
+    BOOST_CHECK(a.MaxOverlap(b, overlap));
+    BOOST_CHECK(overlap == 0 || ! a.MaxOverlap(b, overlap - 1));
+    BOOST_CHECK_EQUAL(a.Overlaps(b), overlap > 0);
+    BOOST_CHECK_EQUAL((a & b).Size(), overlap);
+    BOOST_CHECK_EQUAL((a | b).Size(), size + b.Size() - overlap);
+    BOOST_CHECK_EQUAL(a.SubsetOf(b), overlap == size);
+    SgVector<SgPoint> iterated;
+    for (SgSetIterator it(a); it; ++it)
+        iterated.PushBack(*it);
+    BOOST_CHECK(iterated == points);
+    SgPointSet border = SimpleBorder(a, boardSize, false);
+    BOOST_CHECK(a.Border(boardSize) == border);
+    SgPointSet grown(a);
+    grown.Grow(boardSize);
+    BOOST_CHECK(grown == (a | border));
+    BOOST_CHECK(a.Border8(boardSize) == SimpleBorder(a, boardSize, true));
+    SgPointSet kernel;
+    for (SgSetIterator it(a); it; ++it)
+    {
+        bool isInKernel = true;
+        for (SgNb4Iterator nb(*it); nb; ++nb)
+            if (! a.Contains(*nb)
+                && SgPointSet::AllPoints(boardSize).Contains(*nb))
+                isInKernel = false;
+        if (isInKernel)
+            kernel.Include(*it);
+    }
+    BOOST_CHECK(a.Kernel(boardSize) == kernel);
+}
+
 BOOST_AUTO_TEST_CASE(SgPointSetTest_AllAdjacentTo)
 {
     SgPointSet a;
@@ -471,6 +556,21 @@ BOOST_AUTO_TEST_CASE(SgPointSetTest_PointOf)
     BOOST_CHECK_EQUAL(a.PointOf(), Pt(1, 1));
 }
 
+/** Compare the word-based operations with point by point computations on
+    random sets of different density. */
+BOOST_AUTO_TEST_CASE(SgPointSetTest_RandomSets)
+{
+    SgRandom random;
+    const int sizes[3] = { 5, 9, SG_MAX_SIZE };
+    for (int i = 0; i < 3; ++i)
+        for (int percent = 0; percent <= 100; percent += 10)
+        {
+            SgPointSet a = RandomSet(random, sizes[i], percent);
+            SgPointSet b = RandomSet(random, sizes[i], 50);
+            CheckSameAsSimple(a, b, sizes[i]);
+        }
+}
+
 BOOST_AUTO_TEST_CASE(SgPointSetTest_SubsetOf)
 {
     SgPointSet a;
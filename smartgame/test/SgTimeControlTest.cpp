@@ -82,6 +82,21 @@ BOOST_AUTO_TEST_CASE(SgDefaultTimeControlTest_Infinity)
     BOOST_CHECK(timeMove < 100.0 + epsilon);
 }
 
+/** Test that the extended time is limited by MaxExtension() and half of the
+    remaining time, but never shorter than the time for the move. */
+BOOST_AUTO_TEST_CASE(SgDefaultTimeControlTest_MaxExtendedTime)
+{
+    TimeControl control;
+    control.SetMaxExtension(2.0);
+    SgTimeRecord timeRecord;
+    timeRecord.SetOverhead(0.0);
+    timeRecord.SetTimeLeft(SG_BLACK, 100.0);
+    control.SetPositionInfo(SG_BLACK, 10, 50);
+    BOOST_CHECK_CLOSE(control.MaxExtendedTime(timeRecord, 2.0), 4.0, 1e-4);
+    BOOST_CHECK_CLOSE(control.MaxExtendedTime(timeRecord, 40.0), 50.0, 1e-4);
+    BOOST_CHECK_CLOSE(control.MaxExtendedTime(timeRecord, 60.0), 60.0, 1e-4);
+}
+
 //----------------------------------------------------------------------------
 
 } // namespace
@@ -10,6 +10,7 @@
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 #include "SgDebug.h"
+#include "SgTimer.h"
 #include "SgUctSearch.h"
 #include "SgUctTreeUtil.h"
 
@@ -62,6 +63,15 @@ struct TestNode
     float m_eval;
 
     bool m_isLeaf;
+
+    float m_prior;
+
+    /** Initial value of the move leading to the node.
+        From the view of the player to move at the node like
+        SgUctMoveInfo::m_value. */
+    float m_knowledgeValue;
+
+    float m_knowledgeCount;
 };
 
 //----------------------------------------------------------------------------
@@ -173,6 +183,9 @@ bool TestThreadState::GenerateAllMoves(SgUctValue count,
         if (WRITE)
             SgDebug() << Node(child).m_move << ' ';
         moves.push_back(SgUctMoveInfo(Node(child).m_move));
+        moves.back().m_prior = Node(child).m_prior;
+        moves.back().m_value = Node(child).m_knowledgeValue;
+        moves.back().m_count = Node(child).m_knowledgeCount;
         child = Node(child).m_sibling;
     }
 
@@ -296,6 +309,16 @@ public:
         @param father Index of father node, NO_NODE if root node. */
     void AddNode(size_t father, SgMove move);
 
+    /** Set the prior of the move leading to a node. */
+    void SetPrior(size_t node, float prior);
+
+    /** Set the initial value and count of the move leading to a node.
+        @param node The node
+        @param value The value from the view of the player to move at the
+        node (see SgUctMoveInfo::m_value)
+        @param count The count */
+    void SetKnowledge(size_t node, float value, float count);
+
     // @} // @name
 
     /** @name Virtual functions of SgUctSearch */
@@ -360,9 +383,25 @@ void TestUctSearch::AddNode(size_t father, SgMove move, bool isLeaf,
     node.m_move = move;
     node.m_eval = eval;
     node.m_isLeaf = isLeaf;
+    node.m_prior = 0;
+    node.m_knowledgeValue = 0;
+    node.m_knowledgeCount = 0;
     m_nodes.push_back(node);
 }
 
+void TestUctSearch::SetPrior(size_t node, float prior)
+{
+    SG_ASSERT(node < m_nodes.size());
+    m_nodes[node].m_prior = prior;
+}
+
+void TestUctSearch::SetKnowledge(size_t node, float value, float count)
+{
+    SG_ASSERT(node < m_nodes.size());
+    m_nodes[node].m_knowledgeValue = value;
+    m_nodes[node].m_knowledgeCount = count;
+}
+
 string TestUctSearch::MoveString(SgMove move) const
 {
     ostringstream buffer;
@@ -378,6 +417,40 @@ SgUctValue TestUctSearch::UnknownEval() const
     return 0;
 }
 
+//----------------------------------------------------------------------------
+
+/** Initialize the tree for the tests of SgUctStabilityParam.
+    Move 1 is better than move 2 for the player at the root. The evaluations
+    are not low or high enough to prove any node.
+    @verbatim
+    Numbers are node indices
+    0--1--3  0.59
+    |  \--4  0.59
+    \--2--5  0.41
+       \--6  0.41
+    @endverbatim */
+void InitStabilityTree(TestUctSearch& search)
+{
+    search.SetExpandThreshold(0);
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    search.AddNode(0, 1);
+    search.AddNode(0, 2);
+    search.AddLeafNode(1, 3, 0.59f);
+    search.AddLeafNode(1, 4, 0.59f);
+    search.AddLeafNode(2, 5, 0.41f);
+    search.AddLeafNode(2, 6, 0.41f);
+}
+
+SgUctStabilityParam StabilityParam(double minTime, double maxExtendedTime)
+{
+    SgUctStabilityParam param;
+    param.m_minTime = minTime;
+    param.m_countGap = 0.01f;
+    param.m_valueDrop = 0.03f;
+    param.m_maxExtendedTime = maxExtendedTime;
+    return param;
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
@@ -642,6 +715,281 @@ BOOST_AUTO_TEST_CASE(SgUctSearchTest_Knowledge)
 
 //----------------------------------------------------------------------------
 
+/** Test that progressive widening creates the children sorted by prior and
+    selects a new child only after the thresholds of the position count.
+    The children of the root are not expanded (expand threshold is raised
+    after the root is expanded), so they never become proven.
+    @verbatim
+    Numbers are node indices
+    0--1--5  prior 0
+    \--2--6  prior 0.3
+    \--3--7  prior 0.5
+    \--4--8  prior 0
+    @endverbatim */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_ProgressiveWidening)
+{
+    TestUctSearch search;
+    search.SetExpandThreshold(1);
+    search.SetProgressiveWidening(true);
+    search.SetWideningInitial(1);
+    search.SetWideningBase(10);
+    search.SetWideningFactor(2);
+    BOOST_CHECK_EQUAL(search.WideningWidth(0), 1);
+    BOOST_CHECK_EQUAL(search.WideningWidth(9), 1);
+    BOOST_CHECK_EQUAL(search.WideningWidth(15), 2);
+    BOOST_CHECK_EQUAL(search.WideningWidth(25), 3);
+    BOOST_CHECK_EQUAL(search.WideningWidth(45), 4);
+
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    for (size_t i = 1; i <= 4; ++i)
+        search.AddNode(0, SgMove(i));
+    for (size_t i = 1; i <= 4; ++i)
+        search.AddLeafNode(i, SgMove(i + 4), 0.5f);
+    search.SetPrior(2, 0.3f);
+    search.SetPrior(3, 0.5f);
+
+    search.StartSearch();
+    // Game 1 and 2 expand the root
+    search.PlayGame();
+    search.PlayGame();
+    search.SetExpandThreshold(1000);
+    for (int i = 0; i < 7; ++i)
+        search.PlayGame();
+    const SgUctTree& tree = search.Tree();
+    BOOST_CHECK_EQUAL(tree.Root().FirstChild()->Move(), 3);
+    BOOST_CHECK_EQUAL(GetNode(tree, 3)->MoveCount(), 8u);
+    BOOST_CHECK_EQUAL(GetNode(tree, 2)->MoveCount(), 0u);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1)->MoveCount(), 0u);
+    BOOST_CHECK_EQUAL(GetNode(tree, 4)->MoveCount(), 0u);
+
+    for (int i = 0; i < 6; ++i)
+        search.PlayGame();
+    BOOST_CHECK(GetNode(tree, 2)->MoveCount() > 0);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1)->MoveCount(), 0u);
+    BOOST_CHECK_EQUAL(GetNode(tree, 4)->MoveCount(), 0u);
+}
+
+/** Test that progressive widening orders moves with equal priors by the
+    initial value of the knowledge. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_ProgressiveWidening_NoPriors)
+{
+    TestUctSearch search;
+    search.SetExpandThreshold(1);
+    search.SetProgressiveWidening(true);
+    search.SetWideningInitial(1);
+    search.SetWideningBase(1000);
+
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    for (size_t i = 1; i <= 4; ++i)
+        search.AddNode(0, SgMove(i));
+    for (size_t i = 1; i <= 4; ++i)
+        search.AddLeafNode(i, SgMove(i + 4), 0.5f);
+    // Values from the view of the opponent: move 3 is good, move 2 is bad,
+    // moves 1 and 4 have no knowledge
+    search.SetKnowledge(3, 0.1f, 10);
+    search.SetKnowledge(2, 0.7f, 10);
+
+    search.StartSearch();
+    search.PlayGame();
+    search.PlayGame();
+    search.SetExpandThreshold(1000);
+    for (int i = 0; i < 5; ++i)
+        search.PlayGame();
+    const SgUctTree& tree = search.Tree();
+    vector<SgMove> moves;
+    for (SgUctChildIterator it(tree, tree.Root()); it; ++it)
+        moves.push_back((*it).Move());
+    BOOST_REQUIRE_EQUAL(moves.size(), 4u);
+    BOOST_CHECK_EQUAL(moves[0], 3);
+    BOOST_CHECK_EQUAL(moves[1], 1);
+    BOOST_CHECK_EQUAL(moves[2], 4);
+    BOOST_CHECK_EQUAL(moves[3], 2);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1)->MoveCount(), 0u);
+    BOOST_CHECK_EQUAL(GetNode(tree, 4)->MoveCount(), 0u);
+}
+
+/** Test that the deferred expansion creates only the children within the
+    widening width and creates the next child when the width grows.
+    @verbatim
+    Numbers are node indices
+    0--1--2--6  prior 0
+       \--3--7  prior 0.5
+       \--4--8  prior 0.3
+       \--5--9  prior 0
+    @endverbatim */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_DeferredExpansion)
+{
+    TestUctSearch search;
+    search.SetExpandThreshold(1);
+    search.SetProgressiveWidening(true);
+    search.SetDeferredExpansion(true);
+    search.SetWideningInitial(1);
+    search.SetWideningBase(10);
+    search.SetWideningFactor(2);
+
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    search.AddNode(0, 1);
+    for (size_t i = 2; i <= 5; ++i)
+        search.AddNode(1, SgMove(i));
+    for (size_t i = 2; i <= 5; ++i)
+        search.AddLeafNode(i, SgMove(i + 4), 0.5f);
+    search.SetPrior(3, 0.5f);
+    search.SetPrior(4, 0.3f);
+
+    search.StartSearch();
+    // Game 2 expands the root, game 3 expands node 1
+    for (int i = 0; i < 3; ++i)
+        search.PlayGame();
+    search.SetExpandThreshold(1000);
+    const SgUctTree& tree = search.Tree();
+    const SgUctNode* node = GetNode(tree, 1);
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 3u);
+    BOOST_CHECK_EQUAL(node->NuChildren(), 1);
+    BOOST_CHECK_EQUAL(node->NuDeferredChildren(), 3);
+    BOOST_CHECK_EQUAL(node->FirstChild()->Move(), 3);
+
+    for (int i = 0; i < 9; ++i)
+        search.PlayGame();
+    BOOST_CHECK_EQUAL(node->PosCount(), 10u);
+    BOOST_CHECK_EQUAL(node->NuChildren(), 1);
+
+    search.PlayGame();
+    BOOST_CHECK_EQUAL(node->NuChildren(), 2);
+    BOOST_CHECK_EQUAL(node->NuDeferredChildren(), 2);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1, 3)->MoveCount(), 10u);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1, 4)->MoveCount(), 1u);
+    BOOST_CHECK_EQUAL(search.Statistics().m_widenings, 1u);
+}
+
+/** Test that widening a node in the deferred expansion mode keeps the
+    existing children, even if their moves are no longer the first moves in
+    the order of the priors. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_DeferredExpansion_KeepChildren)
+{
+    TestUctSearch search;
+    search.SetExpandThreshold(1);
+    search.SetProgressiveWidening(true);
+    search.SetDeferredExpansion(true);
+    search.SetWideningInitial(1);
+    search.SetWideningBase(10);
+    search.SetWideningFactor(2);
+
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    search.AddNode(0, 1);
+    for (size_t i = 2; i <= 5; ++i)
+        search.AddNode(1, SgMove(i));
+    for (size_t i = 2; i <= 5; ++i)
+        search.AddLeafNode(i, SgMove(i + 4), 0.5f);
+    search.SetPrior(3, 0.5f);
+
+    search.StartSearch();
+    for (int i = 0; i < 3; ++i)
+        search.PlayGame();
+    search.SetExpandThreshold(1000);
+    for (int i = 0; i < 9; ++i)
+        search.PlayGame();
+    const SgUctTree& tree = search.Tree();
+    const SgUctNode* node = GetNode(tree, 1);
+    BOOST_CHECK_EQUAL(node->NuChildren(), 1);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1, 3)->MoveCount(), 10u);
+
+    // Move 3 has now the lowest prior, moves 5 and 4 the highest
+    search.SetPrior(3, 0.1f);
+    search.SetPrior(4, 0.7f);
+    search.SetPrior(5, 0.9f);
+    search.PlayGame();
+    BOOST_CHECK_EQUAL(node->NuChildren(), 2);
+    BOOST_CHECK_EQUAL(node->NuDeferredChildren(), 2);
+    BOOST_REQUIRE(GetNode(tree, 1, 3) != 0);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1, 3)->MoveCount(), 10u);
+    BOOST_CHECK(! GetNode(tree, 1, 3)->IsProven());
+    BOOST_REQUIRE(GetNode(tree, 1, 5) != 0);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1, 5)->MoveCount(), 1u);
+    BOOST_CHECK(GetNode(tree, 1, 4) == 0);
+}
+
+/** Test that SgUctSearch::RootFocus() restricts the games to one child of
+    the root and keeps the other children. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_RootFocus)
+{
+    TestUctSearch search;
+    search.SetExpandThreshold(1);
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    search.AddNode(0, 1);
+    search.AddNode(0, 2);
+    search.AddLeafNode(1, 3, 0.5f);
+    search.AddLeafNode(2, 4, 0.5f);
+    search.SetRootFocus(2);
+
+    search.StartSearch();
+    // Game 2 expands the root
+    for (int i = 0; i < 2; ++i)
+        search.PlayGame();
+    search.SetExpandThreshold(1000);
+    for (int i = 0; i < 4; ++i)
+        search.PlayGame();
+    const SgUctTree& tree = search.Tree();
+    BOOST_CHECK_EQUAL(tree.Root().NuChildren(), 2);
+    BOOST_CHECK_EQUAL(GetNode(tree, 1)->MoveCount(), 0u);
+    BOOST_CHECK_EQUAL(GetNode(tree, 2)->MoveCount(), 5u);
+
+    // A move that is not a child of the root is ignored
+    search.SetRootFocus(5);
+    search.PlayGame();
+    BOOST_CHECK_EQUAL(GetNode(tree, 1)->MoveCount(), 1u);
+    search.SetRootFocus(SG_NULLMOVE);
+    search.PlayGame();
+    BOOST_CHECK_EQUAL(tree.Root().MoveCount(), 8u);
+}
+
+/** Test that a search with a clear best move stops before the maximum
+    time. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_Stability_StableStop)
+{
+    TestUctSearch search;
+    InitStabilityTree(search);
+    SgUctStabilityParam param = StabilityParam(0.01, 20);
+    vector<SgMove> sequence;
+    SgTimer timer;
+    search.Search(1e9, 20, sequence, vector<SgMove>(), 0, 0, &param);
+    BOOST_CHECK(timer.GetTime() < 10);
+    BOOST_CHECK_EQUAL(search.Statistics().m_stableStops, 1u);
+    BOOST_CHECK_EQUAL(search.Statistics().m_volatileExtensions, 0u);
+}
+
+/** Test that the stable stop is not used after the maximum time.
+    The minimum time for the stable stop is the maximum time, so the search
+    must stop because of the maximum time. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_Stability_NoStableStopAfterMaxTime)
+{
+    TestUctSearch search;
+    InitStabilityTree(search);
+    SgUctStabilityParam param = StabilityParam(1, 0.2);
+    vector<SgMove> sequence;
+    search.Search(1e9, 0.2, sequence, vector<SgMove>(), 0, 0, &param);
+    BOOST_CHECK_EQUAL(search.Statistics().m_stableStops, 0u);
+    BOOST_CHECK_EQUAL(search.Statistics().m_volatileExtensions, 0u);
+}
+
+/** Test that a volatile search is extended up to the maximum extended
+    time.
+    The initial count of move 2 makes it the best move by count, while move 1
+    is the best move by value, so the search stays volatile. Each extension
+    adds half of the original maximum time. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_Stability_VolatileExtension)
+{
+    TestUctSearch search;
+    InitStabilityTree(search);
+    search.SetKnowledge(2, 0.9f, 1e8f);
+    SgUctStabilityParam param = StabilityParam(0.01, 0.4);
+    vector<SgMove> sequence;
+    SgTimer timer;
+    search.Search(1e9, 0.2, sequence, vector<SgMove>(), 0, 0, &param);
+    BOOST_CHECK(timer.GetTime() >= 0.4);
+    BOOST_CHECK_EQUAL(search.Statistics().m_volatileExtensions, 2u);
+    BOOST_CHECK_EQUAL(search.Statistics().m_stableStops, 0u);
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
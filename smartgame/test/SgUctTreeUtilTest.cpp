@@ -88,7 +88,7 @@ BOOST_AUTO_TEST_CASE(SgUctTreeUtilTest_ExtractSubtree)
     vector<SgMove> sequence;
     sequence.push_back(20);
     sequence.push_back(50);
-    SgUctTreeUtil::ExtractSubtree(tree, target, sequence, false);
+    BOOST_CHECK(SgUctTreeUtil::ExtractSubtree(tree, target, sequence, false));
     BOOST_REQUIRE_NO_THROW(target.CheckConsistency());
     BOOST_CHECK_EQUAL(3u, target.NuNodes());
 